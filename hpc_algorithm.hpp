@@ -4,6 +4,7 @@
 #include <hpc_functional.hpp>
 #include <hpc_macros.hpp>
 #include <hpc_range.hpp>
+#include <hpc_thread_pool.hpp>
 #include <hpc_transform_reduce.hpp>
 
 #ifdef HPC_CUDA
@@ -41,6 +42,20 @@ for_each(serial_policy, Range&& r, UnaryFunction f)
   }
 }
 
+template <class Range, class UnaryFunction>
+HPC_NOINLINE void
+for_each(parallel_policy, Range&& r, UnaryFunction f)
+{
+  auto const                         first = r.begin();
+  ::hpc::impl::chunk_partition const partition(::hpc::impl::iterator_distance(first, r.end()));
+  auto chunk_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      f(*::hpc::impl::iterator_offset(first, i));
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, chunk_functor);
+}
+
 #ifdef HPC_CUDA
 template <class Range, class UnaryFunction>
 HPC_NOINLINE void
@@ -74,6 +89,21 @@ copy(serial_policy, FromRange const& from, ToRange& to)
   }
 }
 
+template <class FromRange, class ToRange>
+HPC_NOINLINE void
+copy(parallel_policy, FromRange const& from, ToRange& to)
+{
+  auto const                         first   = from.begin();
+  auto const                         d_first = to.begin();
+  ::hpc::impl::chunk_partition const partition(::hpc::impl::iterator_distance(first, from.end()));
+  auto chunk_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      *::hpc::impl::iterator_offset(d_first, i) = *::hpc::impl::iterator_offset(first, i);
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, chunk_functor);
+}
+
 #ifdef HPC_CUDA
 
 template <class FromRange, class ToRange>
@@ -117,6 +147,21 @@ move(serial_policy, InputRange& input, OutputRange& output)
   }
 }
 
+template <class InputRange, class OutputRange>
+HPC_NOINLINE void
+move(parallel_policy, InputRange& input, OutputRange& output)
+{
+  auto const                         first   = input.begin();
+  auto const                         d_first = output.begin();
+  ::hpc::impl::chunk_partition const partition(::hpc::impl::iterator_distance(first, input.end()));
+  auto chunk_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      *::hpc::impl::iterator_offset(d_first, i) = std::move(*::hpc::impl::iterator_offset(first, i));
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, chunk_functor);
+}
+
 #ifdef HPC_CUDA
 
 template <class InputRange, class OutputRange>
@@ -156,6 +201,20 @@ fill(serial_policy, Range& r, T value)
   }
 }
 
+template <class Range, class T>
+HPC_NOINLINE void
+fill(parallel_policy, Range& r, T value)
+{
+  auto const                         first = r.begin();
+  ::hpc::impl::chunk_partition const partition(::hpc::impl::iterator_distance(first, r.end()));
+  auto chunk_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      *::hpc::impl::iterator_offset(first, i) = value;
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, chunk_functor);
+}
+
 #ifdef HPC_CUDA
 template <class Range, class T>
 HPC_NOINLINE void
@@ -214,4 +273,32 @@ any_of(serial_policy policy, Range const& range)
   return any_of(policy, range, identity<bool>());
 }
 
+template <class Range, class UnaryPredicate>
+bool
+any_of(parallel_policy policy, Range const& range, UnaryPredicate p)
+{
+  return transform_reduce(policy, range, false, logical_or(), p);
+}
+
+template <class Range, class UnaryPredicate>
+bool
+all_of(parallel_policy policy, Range const& range, UnaryPredicate p)
+{
+  return transform_reduce(policy, range, true, logical_and(), p);
+}
+
+template <class Range>
+bool
+all_of(parallel_policy policy, Range const& range)
+{
+  return all_of(policy, range, identity<bool>());
+}
+
+template <class Range>
+bool
+any_of(parallel_policy policy, Range const& range)
+{
+  return any_of(policy, range, identity<bool>());
+}
+
 }  // namespace hpc
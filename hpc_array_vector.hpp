@@ -9,19 +9,79 @@ namespace hpc {
 
 namespace impl {
 
-template <class T, layout L, class O>
+// What array_traits<T>::load and store see of a scalar that an array_vector keeps at another precision
+template <class Storage, class Value>
+class converting_reference
+{
+  Storage& m_storage;
+
+ public:
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit converting_reference(Storage& storage_in) noexcept
+      : m_storage(storage_in)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE operator Value() const noexcept
+  {
+    return Value(m_storage);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE converting_reference const&
+                                    operator=(Value const& value) const noexcept
+  {
+    m_storage = std::remove_const_t<Storage>(value);
+    return *this;
+  }
+};
+
+template <class Iterator, class Value>
+class converting_iterator
+{
+  Iterator m_iterator;
+
+ public:
+  using difference_type = typename Iterator::difference_type;
+  using reference       = converting_reference<std::remove_reference_t<typename Iterator::reference>, Value>;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit converting_iterator(Iterator iterator_in) noexcept
+      : m_iterator(iterator_in)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE reference
+  operator*() const noexcept
+  {
+    return reference(*m_iterator);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE converting_iterator&
+                                    operator++() noexcept
+  {
+    ++m_iterator;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE reference
+  operator[](difference_type const i) const noexcept
+  {
+    return reference(m_iterator[i]);
+  }
+};
+
+// the iterator handed to array_traits: the storage iterator itself unless the scalars need converting
+template <class Iterator, class Storage, class Value>
+using array_traits_iterator = typename std::
+    conditional<std::is_same<Storage, Value>::value, Iterator, converting_iterator<Iterator, Value>>::type;
+
+template <class T, layout L, class O, class S = typename ::hpc::array_traits<std::remove_const_t<T>>::value_type>
 class array_vector_reference
 {
  public:
   using array_value_type = typename ::hpc::array_traits<T>::value_type;
   using array_size_type  = typename ::hpc::array_traits<T>::size_type;
+  using storage_type     = S;
   using iterator_type    = ::hpc::impl::inner_iterator<
-      ::hpc::pointer_iterator<array_value_type, decltype(O() * array_size_type())>,
+      ::hpc::pointer_iterator<storage_type, decltype(O() * array_size_type())>,
       L,
       O,
       array_size_type>;
 
  private:
+  using traits_iterator = array_traits_iterator<iterator_type, storage_type, array_value_type>;
   iterator_type m_iterator;
 
  public:
@@ -40,44 +100,46 @@ class array_vector_reference
   array_vector_reference(array_vector_reference const&) = delete;
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit operator T() const noexcept
   {
-    return ::hpc::array_traits<T>::load(m_iterator);
+    return ::hpc::array_traits<T>::load(traits_iterator(m_iterator));
   }
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
   operator=(T const& value) const noexcept
   {
-    ::hpc::array_traits<T>::store(m_iterator, value);
+    ::hpc::array_traits<T>::store(traits_iterator(m_iterator), value);
   }
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE T
   load() const noexcept
   {
-    return ::hpc::array_traits<T>::load(m_iterator);
+    return ::hpc::array_traits<T>::load(traits_iterator(m_iterator));
   }
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
   store(T const& value) const noexcept
   {
-    ::hpc::array_traits<T>::store(m_iterator, value);
+    ::hpc::array_traits<T>::store(traits_iterator(m_iterator), value);
   }
-  template <class T2, layout L2, class O2>
+  template <class T2, layout L2, class O2, class S2>
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
-  operator=(array_vector_reference<T2, L2, O2> const& ref) const noexcept
+  operator=(array_vector_reference<T2, L2, O2, S2> const& ref) const noexcept
   {
-    ::hpc::array_traits<T>::store(m_iterator, ref.load());
+    ::hpc::array_traits<T>::store(traits_iterator(m_iterator), ref.load());
   }
 };
 
-template <class T, layout L, class O>
-class array_vector_reference<T const, L, O>
+template <class T, layout L, class O, class S>
+class array_vector_reference<T const, L, O, S>
 {
  public:
   using array_value_type = typename ::hpc::array_traits<T>::value_type;
   using array_size_type  = typename ::hpc::array_traits<T>::size_type;
+  using storage_type     = S;
   using iterator_type    = ::hpc::impl::inner_iterator<
-      ::hpc::pointer_iterator<array_value_type const, decltype(O() * array_size_type())>,
+      ::hpc::pointer_iterator<storage_type const, decltype(O() * array_size_type())>,
       L,
       O,
       array_size_type>;
 
  private:
+  using traits_iterator = array_traits_iterator<iterator_type, storage_type, array_value_type>;
   iterator_type m_iterator;
 
  public:
@@ -97,28 +159,28 @@ class array_vector_reference<T const, L, O>
                                              operator=(array_vector_reference const&) = delete;
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit operator T() const noexcept
   {
-    return ::hpc::array_traits<T>::load(m_iterator);
+    return ::hpc::array_traits<T>::load(traits_iterator(m_iterator));
   }
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE T
   load() const noexcept
   {
-    return ::hpc::array_traits<T>::load(m_iterator);
+    return ::hpc::array_traits<T>::load(traits_iterator(m_iterator));
   }
 };
 
 }  // namespace impl
 
-template <class T, layout L, class O>
+template <class T, layout L, class O, class S = typename ::hpc::array_traits<std::remove_const_t<T>>::value_type>
 class array_vector_iterator
 {
  public:
-  using value_type       = std::remove_const_t<T>;
-  using array_value_type = typename ::hpc::array_traits<value_type>::value_type;
-  using array_size_type  = typename ::hpc::array_traits<value_type>::size_type;
-  using qualified_array_value_type =
-      typename std::conditional<std::is_const<T>::value, array_value_type const, array_value_type>::type;
+  using value_type      = std::remove_const_t<T>;
+  using array_size_type = typename ::hpc::array_traits<value_type>::size_type;
+  using storage_type    = S;
+  using qualified_storage_type =
+      typename std::conditional<std::is_const<T>::value, storage_type const, storage_type>::type;
   using iterator = ::hpc::impl::outer_iterator<
-      ::hpc::pointer_iterator<qualified_array_value_type, decltype(O() * array_size_type())>,
+      ::hpc::pointer_iterator<qualified_storage_type, decltype(O() * array_size_type())>,
       L,
       O,
       array_size_type>;
@@ -128,7 +190,7 @@ class array_vector_iterator
 
  public:
   using difference_type   = O;
-  using reference         = ::hpc::impl::array_vector_reference<T, L, O>;
+  using reference         = ::hpc::impl::array_vector_reference<T, L, O, S>;
   using pointer           = T*;
   using iterator_category = typename iterator::iterator_category;
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit constexpr array_vector_iterator(iterator iterator_in) noexcept
@@ -231,17 +293,22 @@ class array_vector_iterator
   }
 };
 
+// Storage is the scalar kept in memory for each component of T. It defaults to the scalar of T; a narrower
+// one such as float halves the memory and bandwidth of the vector, and the references still load and store T,
+// converting each component on the way.
 template <
     class T,
     layout L              = ::hpc::host_layout,
     class Allocator       = std::allocator<T>,
     class ExecutionPolicy = ::hpc::serial_policy,
-    class Index           = std::ptrdiff_t>
+    class Index           = std::ptrdiff_t,
+    class Storage         = typename ::hpc::array_traits<T>::value_type>
 class array_vector
 {
  public:
   using array_value_type = typename ::hpc::array_traits<T>::value_type;
   using array_size_type  = typename ::hpc::array_traits<T>::size_type;
+  using storage_type     = Storage;
   static constexpr array_size_type
   array_size() noexcept
   {
@@ -249,9 +316,8 @@ class array_vector
   }
 
  private:
-  using matrix_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<array_value_type>;
-  using matrix_type =
-      ::hpc::matrix<array_value_type, L, matrix_allocator_type, ExecutionPolicy, Index, array_size_type>;
+  using matrix_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<storage_type>;
+  using matrix_type = ::hpc::matrix<storage_type, L, matrix_allocator_type, ExecutionPolicy, Index, array_size_type>;
   matrix_type m_matrix;
 
  public:
@@ -260,12 +326,12 @@ class array_vector
   using execution_policy            = ExecutionPolicy;
   using size_type                   = Index;
   using difference_type             = typename matrix_type::difference_type;
-  using reference                   = ::hpc::impl::array_vector_reference<value_type, L, Index>;
-  using const_reference             = ::hpc::impl::array_vector_reference<value_type const, L, Index>;
+  using reference                   = ::hpc::impl::array_vector_reference<value_type, L, Index, Storage>;
+  using const_reference             = ::hpc::impl::array_vector_reference<value_type const, L, Index, Storage>;
   using pointer                     = T*;
   using const_pointer               = T const*;
-  using iterator                    = ::hpc::array_vector_iterator<T, L, Index>;
-  using const_iterator              = ::hpc::array_vector_iterator<T const, L, Index>;
+  using iterator                    = ::hpc::array_vector_iterator<T, L, Index, Storage>;
+  using const_iterator              = ::hpc::array_vector_iterator<T const, L, Index, Storage>;
   constexpr array_vector() noexcept = default;
   array_vector(size_type count) : m_matrix(count, array_size())
   {
@@ -354,47 +420,70 @@ class array_vector
   {
     return begin()[i];
   }
-  array_value_type*
+  storage_type*
   data() noexcept
   {
     return m_matrix.data();
   }
-  array_value_type const*
+  storage_type const*
   data() const noexcept
   {
     return m_matrix.data();
   }
 };
 
-template <class T, class Index = std::ptrdiff_t>
-using host_array_vector = array_vector<T, ::hpc::host_layout, ::hpc::host_allocator<T>, ::hpc::host_policy, Index>;
-template <class T, class Index = std::ptrdiff_t>
-using device_array_vector =
-    array_vector<T, ::hpc::device_layout, ::hpc::device_allocator<T>, ::hpc::device_policy, Index>;
-template <class T, class Index = std::ptrdiff_t>
-using pinned_array_vector =
-    array_vector<T, ::hpc::device_layout, ::hpc::pinned_allocator<T>, ::hpc::host_policy, Index>;
+template <
+    class T,
+    class Index   = std::ptrdiff_t,
+    layout L      = ::hpc::host_layout,
+    class Storage = typename ::hpc::array_traits<T>::value_type>
+using host_array_vector = array_vector<T, L, ::hpc::host_allocator<T>, ::hpc::host_policy, Index, Storage>;
+template <
+    class T,
+    class Index   = std::ptrdiff_t,
+    layout L      = ::hpc::device_layout,
+    class Storage = typename ::hpc::array_traits<T>::value_type>
+using device_array_vector = array_vector<T, L, ::hpc::device_allocator<T>, ::hpc::device_policy, Index, Storage>;
+template <
+    class T,
+    class Index   = std::ptrdiff_t,
+    layout L      = ::hpc::device_layout,
+    class Storage = typename ::hpc::array_traits<T>::value_type>
+using pinned_array_vector = array_vector<T, L, ::hpc::pinned_allocator<T>, ::hpc::host_policy, Index, Storage>;
 
-template <class T, layout L, class A, class P, class I>
+template <class T, layout L, class A, class P, class I, class S>
 void
-copy(array_vector<T, L, A, P, I> const& from, array_vector<T, L, A, P, I>& to)
+copy(array_vector<T, L, A, P, I, S> const& from, array_vector<T, L, A, P, I, S>& to)
 {
   hpc::copy(from.get_execution_policy(), from, to);
 }
 
+#ifndef HPC_CUDA
+
+template <class T, layout FromLayout, layout ToLayout, class A, class FromPolicy, class ToPolicy, class I, class S>
+void
+copy(
+    array_vector<T, FromLayout, A, FromPolicy, I, S> const& from,
+    array_vector<T, ToLayout, A, ToPolicy, I, S>&           to)
+{
+  hpc::copy(to.get_execution_policy(), from, to);
+}
+
+#endif
+
 #ifdef HPC_CUDA
 
-template <class T, class Index>
+template <class T, class Index, layout L, class S>
 void
-copy(pinned_array_vector<T, Index> const& from, device_array_vector<T, Index>& to)
+copy(pinned_array_vector<T, Index, L, S> const& from, device_array_vector<T, Index, L, S>& to)
 {
   assert(from.size() == to.size());
-  auto const num_arrays  = from.size();
-  auto const array_size  = from.array_size();
-  auto const size        = std::size_t(num_arrays * array_size);
-  auto const from_ptr    = from.data();
-  auto const to_ptr      = to.data();
-  using array_value_type = typename pinned_array_vector<T, Index>::array_value_type;
+  auto const num_arrays = from.size();
+  auto const array_size = from.array_size();
+  auto const size       = std::size_t(::hpc::padded_size(L, num_arrays) * array_size);
+  auto const from_ptr   = from.data();
+  auto const to_ptr     = to.data();
+  using storage_type    = typename pinned_array_vector<T, Index, L, S>::storage_type;
 #ifndef NDEBUG
   auto err =
 #endif
@@ -403,7 +492,7 @@ copy(pinned_array_vector<T, Index> const& from, device_array_vector<T, Index>& t
 #ifndef NDEBUG
   err =
 #endif
-      cudaMemcpy(to_ptr, from_ptr, size * sizeof(array_value_type), cudaMemcpyHostToDevice);
+      cudaMemcpy(to_ptr, from_ptr, size * sizeof(storage_type), cudaMemcpyHostToDevice);
   assert(cudaSuccess == err);
 #ifndef NDEBUG
   err =
@@ -412,17 +501,17 @@ copy(pinned_array_vector<T, Index> const& from, device_array_vector<T, Index>& t
   assert(cudaSuccess == err);
 }
 
-template <class T, class Index>
+template <class T, class Index, layout L, class S>
 void
-copy(device_array_vector<T, Index> const& from, pinned_array_vector<T, Index>& to)
+copy(device_array_vector<T, Index, L, S> const& from, pinned_array_vector<T, Index, L, S>& to)
 {
   assert(from.size() == to.size());
-  auto const num_arrays  = from.size();
-  auto const array_size  = from.array_size();
-  auto const size        = std::size_t(num_arrays * array_size);
-  auto const from_ptr    = from.data();
-  auto const to_ptr      = to.data();
-  using array_value_type = typename pinned_array_vector<T, Index>::array_value_type;
+  auto const num_arrays = from.size();
+  auto const array_size = from.array_size();
+  auto const size       = std::size_t(::hpc::padded_size(L, num_arrays) * array_size);
+  auto const from_ptr   = from.data();
+  auto const to_ptr     = to.data();
+  using storage_type    = typename pinned_array_vector<T, Index, L, S>::storage_type;
 #ifndef NDEBUG
   auto err =
 #endif
@@ -431,7 +520,7 @@ copy(device_array_vector<T, Index> const& from, pinned_array_vector<T, Index>& t
 #ifndef NDEBUG
   err =
 #endif
-      cudaMemcpy(to_ptr, from_ptr, size * sizeof(array_value_type), cudaMemcpyDeviceToHost);
+      cudaMemcpy(to_ptr, from_ptr, size * sizeof(storage_type), cudaMemcpyDeviceToHost);
   assert(cudaSuccess == err);
 #ifndef NDEBUG
   err =
@@ -1,34 +1,266 @@
 #pragma once
 
+#include <cstdint>
+#include <hpc_dimensional.hpp>
 #include <hpc_macros.hpp>
 
 namespace hpc {
 
+namespace impl {
+
+#ifdef __CUDA_ARCH__
+
+HPC_ALWAYS_INLINE HPC_DEVICE bool
+same_bits(int a, int b) noexcept
+{
+  return a == b;
+}
+HPC_ALWAYS_INLINE HPC_DEVICE bool
+same_bits(std::int64_t a, std::int64_t b) noexcept
+{
+  return a == b;
+}
+HPC_ALWAYS_INLINE HPC_DEVICE bool
+same_bits(double a, double b) noexcept
+{
+  return __double_as_longlong(a) == __double_as_longlong(b);
+}
+HPC_ALWAYS_INLINE HPC_DEVICE int
+device_atomic_cas(int* ptr, int expected, int desired) noexcept
+{
+  return atomicCAS(ptr, expected, desired);
+}
+HPC_ALWAYS_INLINE HPC_DEVICE std::int64_t
+device_atomic_cas(std::int64_t* ptr, std::int64_t expected, std::int64_t desired) noexcept
+{
+  using ull = unsigned long long;
+  return std::int64_t(atomicCAS(reinterpret_cast<ull*>(ptr), ull(expected), ull(desired)));
+}
+HPC_ALWAYS_INLINE HPC_DEVICE double
+device_atomic_cas(double* ptr, double expected, double desired) noexcept
+{
+  using ull      = unsigned long long;
+  auto const old = atomicCAS(
+      reinterpret_cast<ull*>(ptr), ull(__double_as_longlong(expected)), ull(__double_as_longlong(desired)));
+  return __longlong_as_double((long long)(old));
+}
+
+#endif
+
 template <class T>
-class atomic_ref;
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE T
+atomic_load(T& ref) noexcept
+{
+#ifdef __CUDA_ARCH__
+  return *const_cast<T volatile*>(&ref);
+#else
+  T result;
+  __atomic_load(&ref, &result, __ATOMIC_RELAXED);
+  return result;
+#endif
+}
 
-template <>
-class atomic_ref<int>
+template <class T>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+atomic_store(T& ref, T value) noexcept
+{
+#ifdef __CUDA_ARCH__
+  *const_cast<T volatile*>(&ref) = value;
+#else
+  __atomic_store(&ref, &value, __ATOMIC_RELAXED);
+#endif
+}
+
+// on failure, expected is updated to the current value
+template <class T>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE bool
+atomic_compare_exchange(T& ref, T& expected, T desired) noexcept
+{
+#ifdef __CUDA_ARCH__
+  T const    old = ::hpc::impl::device_atomic_cas(&ref, expected, desired);
+  bool const ok  = ::hpc::impl::same_bits(old, expected);
+  expected       = old;
+  return ok;
+#else
+  return __atomic_compare_exchange(&ref, &expected, &desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#endif
+}
+
+// atomically replaces the value with update(old) and returns old;
+// nothing is written when update returns old unchanged
+template <class T, class Update>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE T
+atomic_fetch_update(T& ref, Update update) noexcept
+{
+  T expected = ::hpc::impl::atomic_load(ref);
+  while (true) {
+    T const desired = update(expected);
+    if (desired == expected) return expected;
+    if (::hpc::impl::atomic_compare_exchange(ref, expected, desired)) return expected;
+  }
+}
+
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE int
+atomic_fetch_add(int& ref, int value) noexcept
+{
+#ifdef __CUDA_ARCH__
+  return atomicAdd(&ref, value);
+#else
+  return __atomic_fetch_add(&ref, value, __ATOMIC_RELAXED);
+#endif
+}
+
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE std::int64_t
+atomic_fetch_add(std::int64_t& ref, std::int64_t value) noexcept
+{
+#ifdef __CUDA_ARCH__
+  using ull = unsigned long long;
+  return std::int64_t(atomicAdd(reinterpret_cast<ull*>(&ref), ull(value)));
+#else
+  return __atomic_fetch_add(&ref, value, __ATOMIC_RELAXED);
+#endif
+}
+
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE double
+atomic_fetch_add(double& ref, double value) noexcept
+{
+#ifdef __CUDA_ARCH__
+  return atomicAdd(&ref, value);
+#else
+  return ::hpc::impl::atomic_fetch_update(ref, [=](double const old) { return old + value; });
+#endif
+}
+
+// lock-free atomic operations on a plain int, std::int64_t or double
+template <class T>
+class arithmetic_atomic_ref
 {
  public:
-  using value_type = int;
+  using value_type = T;
 
  private:
   value_type& m_ref;
 
  public:
-  HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit atomic_ref(value_type& ref_in) noexcept : m_ref(ref_in)
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit arithmetic_atomic_ref(value_type& ref_in) noexcept : m_ref(ref_in)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  load() const noexcept
+  {
+    return ::hpc::impl::atomic_load(m_ref);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+  store(value_type const value) const noexcept
+  {
+    ::hpc::impl::atomic_store(m_ref, value);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE bool
+  compare_exchange(value_type& expected, value_type const desired) const noexcept
+  {
+    return ::hpc::impl::atomic_compare_exchange(m_ref, expected, desired);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  fetch_add(value_type const value) const noexcept
+  {
+    return ::hpc::impl::atomic_fetch_add(m_ref, value);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  fetch_min(value_type const value) const noexcept
   {
+    return ::hpc::impl::atomic_fetch_update(m_ref, [=](value_type const old) { return value < old ? value : old; });
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  fetch_max(value_type const value) const noexcept
+  {
+    return ::hpc::impl::atomic_fetch_update(m_ref, [=](value_type const old) { return old < value ? value : old; });
   }
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
   operator++(int) const noexcept
   {
-#ifdef __CUDA_ARCH__
-    return atomicAdd(&m_ref, 1);
-#else
-    return m_ref++;
-#endif
+    return fetch_add(value_type(1));
+  }
+};
+
+}  // namespace impl
+
+// All operations use relaxed memory ordering, which is what the device atomics provide.
+template <class T>
+class atomic_ref;
+
+template <>
+class atomic_ref<int> : public ::hpc::impl::arithmetic_atomic_ref<int>
+{
+ public:
+  using ::hpc::impl::arithmetic_atomic_ref<int>::arithmetic_atomic_ref;
+};
+
+template <>
+class atomic_ref<std::int64_t> : public ::hpc::impl::arithmetic_atomic_ref<std::int64_t>
+{
+ public:
+  using ::hpc::impl::arithmetic_atomic_ref<std::int64_t>::arithmetic_atomic_ref;
+};
+
+template <>
+class atomic_ref<double> : public ::hpc::impl::arithmetic_atomic_ref<double>
+{
+ public:
+  using ::hpc::impl::arithmetic_atomic_ref<double>::arithmetic_atomic_ref;
+};
+
+#ifdef HPC_ENABLE_DIMENSIONAL_ANALYSIS
+
+// operates on the underlying value, so a quantity is exactly as lock-free as its representation
+template <class T, class Dimension>
+class atomic_ref<quantity<T, Dimension>>
+{
+ public:
+  using value_type = quantity<T, Dimension>;
+
+ private:
+  atomic_ref<T> m_impl;
+
+ public:
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE explicit atomic_ref(value_type& ref_in) noexcept
+      : m_impl(reinterpret_cast<T&>(ref_in))
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  load() const noexcept
+  {
+    return value_type(m_impl.load());
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+  store(value_type const value) const noexcept
+  {
+    m_impl.store(T(value));
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE bool
+  compare_exchange(value_type& expected, value_type const desired) const noexcept
+  {
+    T          raw_expected = T(expected);
+    bool const ok           = m_impl.compare_exchange(raw_expected, T(desired));
+    expected                = value_type(raw_expected);
+    return ok;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  fetch_add(value_type const value) const noexcept
+  {
+    return value_type(m_impl.fetch_add(T(value)));
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  fetch_min(value_type const value) const noexcept
+  {
+    return value_type(m_impl.fetch_min(T(value)));
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE value_type
+  fetch_max(value_type const value) const noexcept
+  {
+    return value_type(m_impl.fetch_max(T(value)));
   }
 };
 
+#endif
+
 }  // namespace hpc
@@ -10,13 +10,19 @@ class local_policy
 class serial_policy
 {
 };
+// multithreaded host execution on the threads of hpc::default_thread_pool()
+class parallel_policy
+{
+};
 class cuda_policy
 {
 };
 
 using host_policy = serial_policy;
-#ifdef HPC_CUDA
+#if defined(HPC_CUDA)
 using device_policy = cuda_policy;
+#elif defined(HPC_ENABLE_THREADS)
+using device_policy = parallel_policy;
 #else
 using device_policy = serial_policy;
 #endif
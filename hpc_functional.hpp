@@ -58,6 +58,16 @@ struct identity
   }
 };
 
+template <class T>
+struct bit_or
+{
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr T
+  operator()(T const& a, T const& b) noexcept
+  {
+    return a | b;
+  }
+};
+
 struct logical_or
 {
   HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
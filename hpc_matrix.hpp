@@ -56,7 +56,7 @@ class matrix
   {
   }
   matrix(row_type row_count, column_type column_count)
-      : m_data(row_count * column_count), m_rows(row_count), m_columns(column_count)
+      : m_data(::hpc::padded_size(L, row_count) * column_count), m_rows(row_count), m_columns(column_count)
   {
   }
   constexpr matrix(allocator_type const& allocator_in, execution_policy const& exec_in) noexcept
@@ -68,7 +68,9 @@ class matrix
       column_type             column_count,
       allocator_type const&   allocator_in,
       execution_policy const& exec_in)
-      : m_data(row_count * column_count, allocator_in, exec_in), m_rows(row_count), m_columns(column_count)
+      : m_data(::hpc::padded_size(L, row_count) * column_count, allocator_in, exec_in),
+        m_rows(row_count),
+        m_columns(column_count)
   {
   }
   matrix(matrix&& other) noexcept = default;
@@ -148,7 +150,7 @@ class matrix
   {
     if (row_count == rows() && column_count == columns()) return;
     m_data.clear();
-    m_data.resize(row_count * column_count);
+    m_data.resize(::hpc::padded_size(L, row_count) * column_count);
     m_rows    = row_count;
     m_columns = column_count;
   }
@@ -6,6 +6,10 @@
 #include <hpc_vector3.hpp>
 #include <tuple>
 
+#ifndef HPC_CUDA
+#include <hpc_simd.hpp>
+#endif
+
 namespace hpc {
 
 template <typename Scalar>
@@ -895,6 +899,240 @@ HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr matrix3x3<T>
   return deviatoric_part(A);
 }
 
+#ifndef HPC_CUDA
+
+// Batched tensor kernels. A matrix3x3<simd<T, W>> holds W tensors, one per lane, and the branch-free
+// kernels above (products, determinant, inverse_fast, ...) already process all lanes at once.
+// The iterative kernels below run every lane through the same iterations and freeze converged lanes.
+// They are built for host-only builds, as the GNU vector types behind simd do not exist in device code.
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr matrix3x3<T>
+                  get_lane(matrix3x3<simd<T, W>> const& A, int const lane) noexcept
+{
+  return matrix3x3<T>(
+      A(0, 0)[lane],
+      A(0, 1)[lane],
+      A(0, 2)[lane],
+      A(1, 0)[lane],
+      A(1, 1)[lane],
+      A(1, 2)[lane],
+      A(2, 0)[lane],
+      A(2, 1)[lane],
+      A(2, 2)[lane]);
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+set_lane(matrix3x3<simd<T, W>>& A, int const lane, matrix3x3<T> const& value) noexcept
+{
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      A(i, j)[lane] = value(i, j);
+    }
+  }
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr matrix3x3<simd<T, W>>
+                  select(
+                      simd_mask<T, W> const        mask,
+                      matrix3x3<simd<T, W>> const& left,
+                      matrix3x3<simd<T, W>> const& right) noexcept
+{
+  matrix3x3<simd<T, W>> result = right;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      result(i, j) = select(mask, left(i, j), right(i, j));
+    }
+  }
+  return result;
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+norm(matrix3x3<simd<T, W>> const x) noexcept
+{
+  return sqrt(inner_product(x, x));
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+norm_1(matrix3x3<simd<T, W>> const A) noexcept
+{
+  auto const v0 = abs(A(0, 0)) + abs(A(1, 0)) + abs(A(2, 0));
+  auto const v1 = abs(A(0, 1)) + abs(A(1, 1)) + abs(A(2, 1));
+  auto const v2 = abs(A(0, 2)) + abs(A(1, 2)) + abs(A(2, 2));
+  return max(max(v0, v1), v2);
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+norm_infinity(matrix3x3<simd<T, W>> const A) noexcept
+{
+  auto const v0 = abs(A(0, 0)) + abs(A(0, 1)) + abs(A(0, 2));
+  auto const v1 = abs(A(1, 0)) + abs(A(1, 1)) + abs(A(1, 2));
+  auto const v2 = abs(A(2, 0)) + abs(A(2, 1)) + abs(A(2, 2));
+  return max(max(v0, v1), v2);
+}
+
+// Denman-Beavers square root of W tensors; \p k is the number of iterations of the slowest lane.
+template <class T, int W>
+HPC_HOST_DEVICE auto
+sqrt_dbp(matrix3x3<simd<T, W>> const& A, int& k)
+{
+  using batch         = simd<T, W>;
+  auto const eps      = machine_epsilon<T>();
+  auto const tol      = 0.5 * std::sqrt(3.0) * eps;  // 3 is dim
+  auto const I        = matrix3x3<batch>::identity();
+  auto const max_iter = 32;
+  auto       X        = A;
+  auto       M        = A;
+  auto       scale    = simd_mask<T, W>(true);
+  auto       done     = simd_mask<T, W>(false);
+  k                   = 0;
+  while (k++ < max_iter) {
+    auto const d     = abs(det(M));
+    auto const g     = select(scale, 1.0 / cbrt(sqrt(d)), batch(1.0));
+    auto const Y     = X * g;
+    auto const S     = M * (g * g);
+    auto const N     = inverse(S);
+    auto const Z     = Y * (0.5 * (I + N));
+    auto const P     = 0.5 * (I + 0.5 * (S + N));
+    auto const error = norm(P - I);
+    auto const diff  = norm(Z - Y) / norm(Z);
+    M                = select(done, M, P);
+    X                = select(done, X, Z);
+    scale            = diff >= 0.01;
+    done             = done || error <= tol;
+    if (all(done)) break;
+  }
+  return X;
+}
+
+// Partial fraction Padé logarithm of W tensors near the identity, which need no pivoting to invert.
+template <class T, int W>
+HPC_HOST_DEVICE auto
+log_pade_pf(matrix3x3<simd<T, W>> const& A, int const n)
+{
+  auto const I = matrix3x3<simd<T, W>>::identity();
+  auto       X = 0.0 * A;
+  for (auto i = 0; i < n; ++i) {
+    auto const x = 0.5 * (1.0 + gauss_legendre_abscissae<T>(n, i));
+    auto const w = 0.5 * gauss_legendre_weights<T>(n, i);
+    auto const B = I + x * A;
+    X += w * A * inverse_fast(B);
+  }
+  return X;
+}
+
+// Logarithm of W tensors by inverse scaling and squaring with one Padé degree for every lane.
+// Each lane takes square roots until it lies within the range of that degree, at most max_iter of them,
+// so that a lane whose roots do not converge cannot hold up the others forever.
+template <class T, int W>
+HPC_HOST_DEVICE auto
+log(matrix3x3<simd<T, W>> const& A)
+{
+  using batch         = simd<T, W>;
+  auto const I        = matrix3x3<batch>::identity();
+  auto const m        = 8;
+  auto const theta    = pade_coefficients<T>(m - 1);
+  auto const max_iter = 64;
+  auto       X        = A;
+  auto       power    = batch(1.0);
+  for (auto iter = 0; iter < max_iter; ++iter) {
+    auto const outside = norm_1(X - I) > theta;
+    if (none(outside)) break;
+    auto k = 0;
+    X      = select(outside, sqrt_dbp(X, k), X);
+    power  = select(outside, 2.0 * power, power);
+  }
+  return power * log_pade_pf(X - I, m);
+}
+
+// Exponential of W tensors by scaling and squaring with the highest Padé order for every lane.
+// Each lane is scaled by its own power of two and squared back only that many times.
+template <class T, int W>
+HPC_HOST_DEVICE auto
+exp(matrix3x3<simd<T, W>> const& A)
+{
+  using batch      = simd<T, W>;
+  auto const order = 13;
+  auto const theta = scaling_squaring_theta<T>(order);
+  auto const norm  = norm_1(A);
+  auto       scale = batch(1.0);
+  auto       power = batch(0.0);
+  for (int lane = 0; lane < W; ++lane) {
+    if (norm[lane] > theta) {
+      auto const power_two = static_cast<int>(std::ceil(std::log2(norm[lane] / theta)));
+      power[lane]          = power_two;
+      scale[lane]          = std::ldexp(T(1.0), -power_two);
+    }
+  }
+  auto const I   = matrix3x3<batch>::identity();
+  auto const A1  = scale * A;
+  auto const A2  = A1 * A1;
+  auto const A4  = A2 * A2;
+  auto const A6  = A2 * A4;
+  auto const b0  = polynomial_coefficient<T>(order, 0);
+  auto const b1  = polynomial_coefficient<T>(order, 1);
+  auto const b2  = polynomial_coefficient<T>(order, 2);
+  auto const b3  = polynomial_coefficient<T>(order, 3);
+  auto const b4  = polynomial_coefficient<T>(order, 4);
+  auto const b5  = polynomial_coefficient<T>(order, 5);
+  auto const b6  = polynomial_coefficient<T>(order, 6);
+  auto const b7  = polynomial_coefficient<T>(order, 7);
+  auto const b8  = polynomial_coefficient<T>(order, 8);
+  auto const b9  = polynomial_coefficient<T>(order, 9);
+  auto const b10 = polynomial_coefficient<T>(order, 10);
+  auto const b11 = polynomial_coefficient<T>(order, 11);
+  auto const b12 = polynomial_coefficient<T>(order, 12);
+  auto const b13 = polynomial_coefficient<T>(order, 13);
+  auto const U   = A1 * ((A6 * (b13 * A6 + b11 * A4 + b9 * A2) + b7 * A6 + b5 * A4 + b3 * A2 + b1 * I));
+  auto const V   = A6 * (b12 * A6 + b10 * A4 + b8 * A2) + b6 * A6 + b4 * A4 + b2 * A2 + b0 * I;
+  auto       B   = inverse(V - U) * (U + V);
+  for (auto squarings = batch(0.0); any(squarings < power); squarings += 1.0) {
+    B = select(squarings < power, B * B, B);
+  }
+  return B;
+}
+
+// Polar rotation of W tensors by the scaled Newton iteration of polar_rotation. The cofactor inverse
+// replaces the full pivot one, which would branch differently in each lane.
+template <class T, int W>
+HPC_HOST_DEVICE auto
+polar_rotation(matrix3x3<simd<T, W>> const& A)
+{
+  using batch          = simd<T, W>;
+  auto const dim       = 3.0;
+  auto       scale     = simd_mask<T, W>(true);
+  auto       done      = simd_mask<T, W>(false);
+  auto const tol_scale = 0.01;
+  auto const tol_conv  = std::sqrt(dim) * machine_epsilon<T>();
+  auto       X         = A;
+  auto       gamma     = batch(2.0);
+  auto const max_iter  = 128;
+  auto       num_iter  = 0;
+  while (num_iter < max_iter) {
+    auto const Y        = inverse_fast(X);
+    auto const ratio    = (norm_1(Y) * norm_infinity(Y)) / (norm_1(X) * norm_infinity(X));
+    auto const mu       = select(scale, sqrt(sqrt(ratio)), batch(1.0));
+    auto const Z        = 0.5 * (mu * X + transpose(Y) / mu);
+    auto const D        = Z - X;
+    auto const delta    = norm(D) / norm(Z);
+    scale               = scale && !(delta < tol_scale);
+    auto const end_iter = norm(D) <= std::sqrt(tol_conv) || (delta > 0.5 * gamma && !scale);
+    X                   = select(done, X, Z);
+    gamma               = select(done, gamma, delta);
+    done                = done || end_iter;
+    if (all(done)) break;
+    num_iter++;
+  }
+  return X;
+}
+
+#endif
+
 template <class T>
 class array_traits<matrix3x3<T>>
 {
@@ -3,6 +3,7 @@
 #include <hpc_algorithm.hpp>
 #include <hpc_execution.hpp>
 #include <hpc_macros.hpp>
+#include <hpc_memory_pool.hpp>
 #include <memory>
 #include <type_traits>
 
@@ -14,7 +15,7 @@ using host_allocator = std::allocator<T>;
 #ifdef HPC_CUDA
 
 template <class T>
-class device_allocator
+class raw_device_allocator
 {
  public:
   using value_type      = T;
@@ -27,16 +28,16 @@ class device_allocator
   template <class U>
   struct rebind
   {
-    typedef ::hpc::device_allocator<U> other;
+    typedef ::hpc::raw_device_allocator<U> other;
   };
   using is_always_equal = std::true_type;
   constexpr bool
-  operator==(device_allocator const&) const noexcept
+  operator==(raw_device_allocator const&) const noexcept
   {
     return true;
   }
   constexpr bool
-  operator!=(device_allocator const&) const noexcept
+  operator!=(raw_device_allocator const&) const noexcept
   {
     return false;
   }
@@ -65,7 +66,7 @@ class device_allocator
 };
 
 template <class T>
-class pinned_allocator
+class raw_pinned_allocator
 {
  public:
   using value_type      = T;
@@ -78,16 +79,16 @@ class pinned_allocator
   template <class U>
   struct rebind
   {
-    typedef ::hpc::pinned_allocator<U> other;
+    typedef ::hpc::raw_pinned_allocator<U> other;
   };
   using is_always_equal = std::true_type;
   constexpr bool
-  operator==(pinned_allocator const&) const noexcept
+  operator==(raw_pinned_allocator const&) const noexcept
   {
     return true;
   }
   constexpr bool
-  operator!=(pinned_allocator const&) const noexcept
+  operator!=(raw_pinned_allocator const&) const noexcept
   {
     return false;
   }
@@ -118,12 +119,32 @@ class pinned_allocator
 #else
 
 template <class T>
-using pinned_allocator = std::allocator<T>;
+using raw_pinned_allocator = std::allocator<T>;
 template <class T>
-using device_allocator = std::allocator<T>;
+using raw_device_allocator = std::allocator<T>;
 
 #endif
 
+// device and pinned memory come from caching pools, so that per-step temporaries reuse their buffers
+using device_memory = raw_device_allocator<char>;
+using pinned_memory = raw_pinned_allocator<char>;
+template <class T>
+using device_allocator = pool_allocator<T, device_memory>;
+template <class T>
+using pinned_allocator = pool_allocator<T, pinned_memory>;
+
+inline memory_pool<device_memory>&
+device_pool()
+{
+  return pool_of<device_memory>();
+}
+
+inline memory_pool<pinned_memory>&
+pinned_pool()
+{
+  return pool_of<pinned_memory>();
+}
+
 template <class Range>
 HPC_NOINLINE void
 uninitialized_default_construct(serial_policy, Range&& range)
@@ -136,6 +157,18 @@ uninitialized_default_construct(serial_policy, Range&& range)
   }
 }
 
+template <class Range>
+HPC_NOINLINE void
+uninitialized_default_construct(parallel_policy policy, Range&& range)
+{
+  using range_type     = std::decay_t<Range>;
+  using reference_type = typename range_type::reference;
+  auto functor         = [](reference_type ref) {
+    ::new (static_cast<void*>(std::addressof(ref))) typename range_type::value_type;
+  };
+  ::hpc::for_each(policy, range, functor);
+}
+
 #ifdef HPC_CUDA
 
 template <class Range>
@@ -177,6 +210,16 @@ destroy(serial_policy, Range&& range)
   }
 }
 
+template <class Range>
+HPC_NOINLINE void
+destroy(parallel_policy policy, Range&& range)
+{
+  using range_type     = std::decay_t<Range>;
+  using reference_type = typename range_type::reference;
+  auto functor         = [](reference_type ref) { ::hpc::host_destroy_at(std::addressof(ref)); };
+  ::hpc::for_each(policy, range, functor);
+}
+
 #ifdef HPC_CUDA
 
 template <class Range>
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstddef>
+#include <hpc_macros.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+namespace hpc {
+
+struct pool_statistics
+{
+  // requests for memory and how many of them a cached block satisfied
+  std::size_t allocations{0};
+  std::size_t reuses{0};
+  // bytes handed out and not yet returned, and bytes kept for reuse
+  std::size_t bytes_in_use{0};
+  std::size_t bytes_cached{0};
+  // the most bytes held from the upstream allocator at any time
+  std::size_t high_water_mark{0};
+  double
+  reuse_rate() const noexcept
+  {
+    return allocations == 0 ? 0.0 : double(reuses) / double(allocations);
+  }
+};
+
+// A caching allocator of raw bytes over an upstream allocator of char. Released blocks are kept and
+// handed out again for requests that fit them with at most an eighth to spare, so buffers that are
+// allocated and freed every time step stop reaching cudaMalloc or the system allocator.
+template <class Upstream>
+class memory_pool
+{
+  struct cached_block
+  {
+    void*       data;
+    std::size_t epoch;
+  };
+  Upstream                                 m_upstream;
+  std::mutex                               m_mutex;
+  std::multimap<std::size_t, cached_block> m_cache;
+  std::unordered_map<void*, std::size_t>   m_in_use;
+  pool_statistics                          m_statistics;
+  std::size_t                              m_epoch{0};
+  static constexpr std::size_t             granularity = 256;
+
+ public:
+  memory_pool()                   = default;
+  memory_pool(memory_pool const&) = delete;
+  memory_pool&
+  operator=(memory_pool const&) = delete;
+  ~memory_pool()
+  {
+    release_cached();
+  }
+  void*
+  allocate(std::size_t const bytes)
+  {
+    auto const                  size = ((bytes + granularity - 1) / granularity) * granularity;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_statistics.allocations;
+    void*      data  = nullptr;
+    auto const found = m_cache.lower_bound(size);
+    if (found != m_cache.end() && found->first <= size + size / 8) {
+      data = found->second.data;
+      m_in_use.emplace(data, found->first);
+      m_statistics.bytes_cached -= found->first;
+      m_statistics.bytes_in_use += found->first;
+      ++m_statistics.reuses;
+      m_cache.erase(found);
+      return data;
+    }
+    data = m_upstream.allocate(size);
+    m_in_use.emplace(data, size);
+    m_statistics.bytes_in_use += size;
+    auto const held              = m_statistics.bytes_in_use + m_statistics.bytes_cached;
+    m_statistics.high_water_mark = held > m_statistics.high_water_mark ? held : m_statistics.high_water_mark;
+    return data;
+  }
+  void
+  deallocate(void* const data)
+  {
+    if (data == nullptr) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const                  found = m_in_use.find(data);
+    HPC_ASSERT(found != m_in_use.end(), "memory_pool::deallocate of a block that is not in use from this pool");
+    auto const size = found->second;
+    m_in_use.erase(found);
+    m_statistics.bytes_in_use -= size;
+    m_statistics.bytes_cached += size;
+    m_cache.emplace(size, cached_block{data, m_epoch});
+  }
+  // returns every cached block to the upstream allocator
+  void
+  release_cached()
+  {
+    release_cached_before(std::size_t(-1));
+  }
+  // returns the cached blocks last released before \p epoch to the upstream allocator
+  void
+  release_cached_before(std::size_t const epoch)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_cache.begin(); it != m_cache.end();) {
+      if (it->second.epoch < epoch) {
+        m_upstream.deallocate(static_cast<typename Upstream::value_type*>(it->second.data), it->first);
+        m_statistics.bytes_cached -= it->first;
+        it = m_cache.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // starts a new epoch and \return it; blocks released from now on are stamped with it
+  std::size_t
+  advance_epoch()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return ++m_epoch;
+  }
+  pool_statistics
+  statistics()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+  }
+  void
+  reset_statistics()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics.allocations     = 0;
+    m_statistics.reuses          = 0;
+    m_statistics.high_water_mark = m_statistics.bytes_in_use + m_statistics.bytes_cached;
+  }
+};
+
+// \return the pool shared by every pool_allocator over \p Upstream. It is never destroyed, so vectors
+// with static storage duration may outlive any other object.
+template <class Upstream>
+memory_pool<Upstream>&
+pool_of()
+{
+  static auto* const pool = new memory_pool<Upstream>();
+  return *pool;
+}
+
+// A stateless allocator that draws from the shared pool over \p Upstream
+template <class T, class Upstream>
+class pool_allocator
+{
+ public:
+  using value_type      = T;
+  using pointer         = T*;
+  using const_pointer   = T const*;
+  using reference       = T&;
+  using const_reference = T const&;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  template <class U>
+  struct rebind
+  {
+    typedef ::hpc::pool_allocator<U, Upstream> other;
+  };
+  using is_always_equal = std::true_type;
+  constexpr pool_allocator() noexcept = default;
+  template <class U>
+  constexpr pool_allocator(pool_allocator<U, Upstream> const&) noexcept
+  {
+  }
+  constexpr bool
+  operator==(pool_allocator const&) const noexcept
+  {
+    return true;
+  }
+  constexpr bool
+  operator!=(pool_allocator const&) const noexcept
+  {
+    return false;
+  }
+  T*
+  allocate(std::size_t n)
+  {
+    return static_cast<T*>(pool_of<Upstream>().allocate(n * sizeof(T)));
+  }
+  void
+  deallocate(T* p, std::size_t)
+  {
+    pool_of<Upstream>().deallocate(p);
+  }
+};
+
+// Scopes per-step scratch memory. Blocks that are released during the scope stay cached for the next
+// one, and when the scope ends the cached blocks that sat unused through all of it go back upstream, so
+// the cache follows the working set of a step instead of growing with every size ever requested.
+template <class Upstream>
+class pool_scope
+{
+  std::size_t m_epoch;
+
+ public:
+  pool_scope() : m_epoch(pool_of<Upstream>().advance_epoch())
+  {
+  }
+  pool_scope(pool_scope const&) = delete;
+  pool_scope&
+  operator=(pool_scope const&) = delete;
+  ~pool_scope()
+  {
+    pool_of<Upstream>().release_cached_before(m_epoch);
+  }
+};
+
+}  // namespace hpc
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <hpc_algorithm.hpp>
 #include <hpc_functional.hpp>
 #include <hpc_range.hpp>
+#include <hpc_thread_pool.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #ifdef HPC_CUDA
 #include <thrust/execution_policy.h>
+#include <thrust/sort.h>
 #include <thrust/transform_scan.h>
 #endif
 
@@ -55,6 +61,15 @@ reduce(serial_policy policy, Range const& range, T init)
   return transform_reduce(policy, range, init, plus<T>(), unop);
 }
 
+template <class Range, class T>
+HPC_NOINLINE T
+reduce(parallel_policy policy, Range const& range, T init)
+{
+  using input_value_type = typename Range::value_type;
+  auto const unop        = [](input_value_type const i) { return T(i); };
+  return transform_reduce(policy, range, init, plus<T>(), unop);
+}
+
 #ifdef HPC_CUDA
 
 template <class Range, class T>
@@ -110,6 +125,50 @@ transform_inclusive_scan(
   }
 }
 
+// Each chunk is scanned independently, then the running totals of the
+// preceding chunks are folded into every chunk but the first.
+template <class InputRange, class OutputRange, class BinaryOp, class UnaryOp>
+HPC_NOINLINE void
+transform_inclusive_scan(
+    parallel_policy,
+    InputRange const& input,
+    OutputRange&      output,
+    BinaryOp          binary_op,
+    UnaryOp           unary_op)
+{
+  auto const first   = input.begin();
+  auto const d_first = output.begin();
+  auto const size    = ::hpc::impl::iterator_distance(first, input.end());
+  if (size == 0) return;
+  using sum_type = std::decay_t<decltype(unary_op(*first))>;
+  ::hpc::impl::chunk_partition const              partition(size);
+  std::vector<::hpc::impl::chunk_value<sum_type>> chunk_sums(std::size_t(partition.size()), {unary_op(*first)});
+  auto scan_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    auto sum                                      = unary_op(*::hpc::impl::iterator_offset(first, begin));
+    *::hpc::impl::iterator_offset(d_first, begin) = sum;
+    for (auto i = begin + 1; i < end; ++i) {
+      auto const value                          = unary_op(*::hpc::impl::iterator_offset(first, i));
+      sum                                       = binary_op(std::move(sum), value);
+      *::hpc::impl::iterator_offset(d_first, i) = sum;
+    }
+    chunk_sums[std::size_t(chunk)].value = std::move(sum);
+  };
+  ::hpc::impl::parallel_for_chunks(partition, scan_functor);
+  if (partition.size() == 1) return;
+  for (std::size_t chunk = 1; chunk < chunk_sums.size(); ++chunk) {
+    chunk_sums[chunk].value = binary_op(chunk_sums[chunk - 1].value, chunk_sums[chunk].value);
+  }
+  auto offset_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    if (chunk == 0) return;
+    auto const offset = chunk_sums[std::size_t(chunk - 1)].value;
+    for (auto i = begin; i < end; ++i) {
+      auto const it = ::hpc::impl::iterator_offset(d_first, i);
+      *it           = binary_op(offset, *it);
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, offset_functor);
+}
+
 #ifdef HPC_CUDA
 
 namespace impl {
@@ -177,6 +236,411 @@ transform_inclusive_scan(
 
 #endif
 
+template <class InputRange, class OutputRange, class T, class BinaryOp, class UnaryOp>
+HPC_NOINLINE void
+transform_exclusive_scan(
+    serial_policy,
+    InputRange const& input,
+    OutputRange&      output,
+    T                 init,
+    BinaryOp          binary_op,
+    UnaryOp           unary_op)
+{
+  auto       first   = input.begin();
+  auto const last    = input.end();
+  auto       d_first = output.begin();
+  for (; first != last; ++first, ++d_first) {
+    auto value = unary_op(*first);
+    *d_first   = init;
+    init       = binary_op(std::move(init), std::move(value));
+  }
+}
+
+// The chunks are reduced first, then each chunk is scanned starting from the
+// combined sums of the chunks before it. Input and output may be the same range.
+template <class InputRange, class OutputRange, class T, class BinaryOp, class UnaryOp>
+HPC_NOINLINE void
+transform_exclusive_scan(
+    parallel_policy,
+    InputRange const& input,
+    OutputRange&      output,
+    T                 init,
+    BinaryOp          binary_op,
+    UnaryOp           unary_op)
+{
+  auto const first   = input.begin();
+  auto const d_first = output.begin();
+  auto const size    = ::hpc::impl::iterator_distance(first, input.end());
+  if (size == 0) return;
+  ::hpc::impl::chunk_partition const       partition(size);
+  std::vector<::hpc::impl::chunk_value<T>> chunk_sums(std::size_t(partition.size()), {init});
+  auto sum_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    T sum = unary_op(*::hpc::impl::iterator_offset(first, begin));
+    for (auto i = begin + 1; i < end; ++i) {
+      sum = binary_op(std::move(sum), unary_op(*::hpc::impl::iterator_offset(first, i)));
+    }
+    chunk_sums[std::size_t(chunk)].value = std::move(sum);
+  };
+  ::hpc::impl::parallel_for_chunks(partition, sum_functor);
+  for (auto& chunk_sum : chunk_sums) {
+    auto sum        = std::move(chunk_sum.value);
+    chunk_sum.value = init;
+    init            = binary_op(std::move(init), std::move(sum));
+  }
+  auto scan_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    T sum = chunk_sums[std::size_t(chunk)].value;
+    for (auto i = begin; i < end; ++i) {
+      auto value                                = unary_op(*::hpc::impl::iterator_offset(first, i));
+      *::hpc::impl::iterator_offset(d_first, i) = sum;
+      sum                                       = binary_op(std::move(sum), std::move(value));
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, scan_functor);
+}
+
+template <class ExecutionPolicy, class InputRange, class OutputRange, class T>
+void
+exclusive_scan(ExecutionPolicy policy, InputRange const& input, OutputRange& output, T init)
+{
+  using input_value_type = typename InputRange::value_type;
+  ::hpc::transform_exclusive_scan(policy, input, output, init, ::hpc::plus<T>(), ::hpc::cast<T, input_value_type>());
+}
+
+// Scans each run of consecutive equal keys separately
+template <class KeyRange, class ValueRange, class OutputRange, class BinaryOp>
+HPC_NOINLINE void
+inclusive_scan_by_key(
+    serial_policy,
+    KeyRange const&   keys,
+    ValueRange const& values,
+    OutputRange&      output,
+    BinaryOp          binary_op)
+{
+  auto       key      = keys.begin();
+  auto const last_key = keys.end();
+  auto       value    = values.begin();
+  auto       d_first  = output.begin();
+  if (key == last_key) return;
+  auto previous_key = *key;
+  auto sum          = *value;
+  *d_first          = sum;
+  while (++key != last_key) {
+    auto const current_key = *key;
+    auto       current     = *(++value);
+    sum                    = (current_key == previous_key) ? binary_op(std::move(sum), std::move(current)) : current;
+    *(++d_first)           = sum;
+    previous_key           = current_key;
+  }
+}
+
+// Each chunk is scanned by key independently. The run that a chunk ends with is then
+// carried into the next chunk, through every chunk that the run spans completely.
+template <class KeyRange, class ValueRange, class OutputRange, class BinaryOp>
+HPC_NOINLINE void
+inclusive_scan_by_key(
+    parallel_policy,
+    KeyRange const&   keys,
+    ValueRange const& values,
+    OutputRange&      output,
+    BinaryOp          binary_op)
+{
+  auto const key_first   = keys.begin();
+  auto const value_first = values.begin();
+  auto const d_first     = output.begin();
+  auto const size        = ::hpc::impl::iterator_distance(key_first, keys.end());
+  if (size == 0) return;
+  using sum_type = typename ValueRange::value_type;
+  ::hpc::impl::chunk_partition const partition(size);
+  auto const                         chunk_count = std::size_t(partition.size());
+  std::vector<::hpc::impl::chunk_value<sum_type>> carries(chunk_count, {*value_first});
+  std::vector<::hpc::impl::chunk_value<bool>>     single_run(chunk_count, {true});
+  std::vector<::hpc::impl::chunk_value<bool>>     carried(chunk_count, {false});
+  auto scan_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    auto previous_key = *::hpc::impl::iterator_offset(key_first, begin);
+    auto sum          = *::hpc::impl::iterator_offset(value_first, begin);
+    *::hpc::impl::iterator_offset(d_first, begin) = sum;
+    for (auto i = begin + 1; i < end; ++i) {
+      auto const current_key = *::hpc::impl::iterator_offset(key_first, i);
+      auto       current     = *::hpc::impl::iterator_offset(value_first, i);
+      if (current_key == previous_key) {
+        sum = binary_op(std::move(sum), std::move(current));
+      } else {
+        sum                                  = std::move(current);
+        single_run[std::size_t(chunk)].value = false;
+      }
+      *::hpc::impl::iterator_offset(d_first, i) = sum;
+      previous_key                              = current_key;
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, scan_functor);
+  for (std::size_t chunk = 1; chunk < chunk_count; ++chunk) {
+    auto const begin = partition.begin(std::ptrdiff_t(chunk));
+    if (!(*::hpc::impl::iterator_offset(key_first, begin - 1) == *::hpc::impl::iterator_offset(key_first, begin))) {
+      continue;
+    }
+    auto tail = *::hpc::impl::iterator_offset(d_first, begin - 1);
+    if (carried[chunk - 1].value && single_run[chunk - 1].value) {
+      tail = binary_op(carries[chunk - 1].value, std::move(tail));
+    }
+    carries[chunk].value = std::move(tail);
+    carried[chunk].value = true;
+  }
+  auto carry_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    if (!carried[std::size_t(chunk)].value) return;
+    auto const run_key = *::hpc::impl::iterator_offset(key_first, begin);
+    for (auto i = begin; i < end && *::hpc::impl::iterator_offset(key_first, i) == run_key; ++i) {
+      auto const it = ::hpc::impl::iterator_offset(d_first, i);
+      *it           = binary_op(carries[std::size_t(chunk)].value, *it);
+    }
+  };
+  ::hpc::impl::parallel_for_chunks(partition, carry_functor);
+}
+
+namespace impl {
+
+// maps an integral key to unsigned bits whose order matches the order of the keys
+template <class Key>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE auto
+radix_bits(Key const key) noexcept
+{
+  using integral_type = decltype(::hpc::weaken(key));
+  using bits_type     = std::make_unsigned_t<integral_type>;
+  constexpr auto sign_bit =
+      std::is_signed<integral_type>::value ? bits_type(bits_type(1) << (8 * sizeof(bits_type) - 1)) : bits_type(0);
+  return bits_type(bits_type(::hpc::weaken(key)) ^ sign_bit);
+}
+
+template <class ChunkFunction>
+void
+for_each_chunk(serial_policy, chunk_partition const& partition, ChunkFunction&& f)
+{
+  for (std::ptrdiff_t chunk = 0; chunk < partition.size(); ++chunk) {
+    f(chunk, partition.begin(chunk), partition.end(chunk));
+  }
+}
+
+template <class ChunkFunction>
+void
+for_each_chunk(parallel_policy, chunk_partition const& partition, ChunkFunction&& f)
+{
+  ::hpc::impl::parallel_for_chunks(partition, f);
+}
+
+// Least significant digit radix sort, a byte per pass. Every chunk counts its digits, the counts
+// give each (digit, chunk) pair its place, and the chunks then scatter in order, so the sort is stable.
+// Bytes in which all keys agree are skipped.
+template <class Policy, class KeyRange, class ValueRange>
+void
+radix_sort_by_key(Policy policy, KeyRange& keys, ValueRange& values)
+{
+  using key_type   = typename KeyRange::value_type;
+  using value_type = typename ValueRange::value_type;
+  using bits_type  = decltype(::hpc::impl::radix_bits(std::declval<key_type>()));
+  constexpr int radix = 256;
+  auto const    size  = ::hpc::impl::iterator_distance(keys.begin(), keys.end());
+  if (size < 2) return;
+  auto const first_bits  = ::hpc::impl::radix_bits(*keys.begin());
+  auto const differ_unop = [=](key_type const key) { return bits_type(::hpc::impl::radix_bits(key) ^ first_bits); };
+  auto const differ = ::hpc::transform_reduce(policy, keys, bits_type(0), ::hpc::bit_or<bits_type>(), differ_unop);
+  if (differ == bits_type(0)) return;
+  chunk_partition const       partition(size);
+  auto const                  chunk_count = partition.size();
+  std::vector<key_type>       from_keys(static_cast<std::size_t>(size));
+  std::vector<key_type>       to_keys(static_cast<std::size_t>(size));
+  std::vector<value_type>     from_values(static_cast<std::size_t>(size));
+  std::vector<value_type>     to_values(static_cast<std::size_t>(size));
+  std::vector<std::ptrdiff_t> offsets(std::size_t(chunk_count * radix));
+  auto const                  key_first   = keys.begin();
+  auto const                  value_first = values.begin();
+  auto load_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      from_keys[std::size_t(i)]   = *::hpc::impl::iterator_offset(key_first, i);
+      from_values[std::size_t(i)] = *::hpc::impl::iterator_offset(value_first, i);
+    }
+  };
+  for_each_chunk(policy, partition, load_functor);
+  for (int shift = 0; shift < int(8 * sizeof(bits_type)); shift += 8) {
+    if (((differ >> shift) & bits_type(radix - 1)) == bits_type(0)) continue;
+    auto const digit = [&](key_type const key) {
+      return std::ptrdiff_t((::hpc::impl::radix_bits(key) >> shift) & bits_type(radix - 1));
+    };
+    auto count_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+      auto const counts = offsets.data() + chunk * radix;
+      std::fill(counts, counts + radix, std::ptrdiff_t(0));
+      for (auto i = begin; i < end; ++i) ++counts[digit(from_keys[std::size_t(i)])];
+    };
+    for_each_chunk(policy, partition, count_functor);
+    std::ptrdiff_t offset = 0;
+    for (std::ptrdiff_t d = 0; d < radix; ++d) {
+      for (std::ptrdiff_t chunk = 0; chunk < chunk_count; ++chunk) {
+        auto& count = offsets[std::size_t(chunk * radix + d)];
+        auto  next  = offset + count;
+        count       = offset;
+        offset      = next;
+      }
+    }
+    auto scatter_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+      auto const chunk_offsets = offsets.data() + chunk * radix;
+      for (auto i = begin; i < end; ++i) {
+        auto const position = std::size_t(chunk_offsets[digit(from_keys[std::size_t(i)])]++);
+        to_keys[position]   = std::move(from_keys[std::size_t(i)]);
+        to_values[position] = std::move(from_values[std::size_t(i)]);
+      }
+    };
+    for_each_chunk(policy, partition, scatter_functor);
+    std::swap(from_keys, to_keys);
+    std::swap(from_values, to_values);
+  }
+  auto store_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      *::hpc::impl::iterator_offset(key_first, i)   = std::move(from_keys[std::size_t(i)]);
+      *::hpc::impl::iterator_offset(value_first, i) = std::move(from_values[std::size_t(i)]);
+    }
+  };
+  for_each_chunk(policy, partition, store_functor);
+}
+
+// Moves the items of \p range whose flags, as given by the inclusive scan \p kept of 0 or 1 per item,
+// are set to the front in order, and the others after them in order when \p keep_rest is set.
+// \return the number of flagged items.
+template <class Policy, class Range>
+std::ptrdiff_t
+stable_compact(Policy policy, Range& range, std::vector<std::ptrdiff_t> const& kept, bool const keep_rest)
+{
+  using value_type = typename Range::value_type;
+  auto const              first = range.begin();
+  auto const              size  = std::ptrdiff_t(kept.size());
+  auto const              count = kept.back();
+  chunk_partition const   partition(size);
+  std::vector<value_type> moved(static_cast<std::size_t>(size));
+  auto scatter_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      auto const is_kept = kept[std::size_t(i)] != (i == 0 ? 0 : kept[std::size_t(i - 1)]);
+      if (is_kept) {
+        moved[std::size_t(kept[std::size_t(i)] - 1)] = std::move(*::hpc::impl::iterator_offset(first, i));
+      } else if (keep_rest) {
+        moved[std::size_t(count + i - kept[std::size_t(i)])] = std::move(*::hpc::impl::iterator_offset(first, i));
+      }
+    }
+  };
+  for_each_chunk(policy, partition, scatter_functor);
+  chunk_partition const store_partition(keep_rest ? size : count);
+  auto store_functor = [&](std::ptrdiff_t, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    for (auto i = begin; i < end; ++i) {
+      *::hpc::impl::iterator_offset(first, i) = std::move(moved[std::size_t(i)]);
+    }
+  };
+  for_each_chunk(policy, store_partition, store_functor);
+  return count;
+}
+
+}  // namespace impl
+
+// Sorts \p keys, which must be integral, in ascending order and applies the same permutation to \p values.
+// Equal keys keep their relative order.
+template <class KeyRange, class ValueRange>
+HPC_NOINLINE void
+sort_by_key(serial_policy policy, KeyRange& keys, ValueRange& values)
+{
+  ::hpc::impl::radix_sort_by_key(policy, keys, values);
+}
+
+template <class KeyRange, class ValueRange>
+HPC_NOINLINE void
+sort_by_key(parallel_policy policy, KeyRange& keys, ValueRange& values)
+{
+  ::hpc::impl::radix_sort_by_key(policy, keys, values);
+}
+
+#ifdef HPC_CUDA
+
+template <class KeyRange, class ValueRange>
+HPC_NOINLINE void
+sort_by_key(cuda_policy, KeyRange& keys, ValueRange& values)
+{
+  auto const  size      = std::ptrdiff_t(keys.end() - keys.begin());
+  auto* const new_first = &(*keys.begin());
+  thrust::stable_sort_by_key(thrust::device, new_first, new_first + size, &(*values.begin()));
+}
+
+#endif
+
+// Moves the first item of every run of equal consecutive items to the front of \p range, in order,
+// and \return how many there are
+template <class Range>
+HPC_NOINLINE std::ptrdiff_t
+unique(serial_policy, Range& range)
+{
+  auto const size = ::hpc::impl::iterator_distance(range.begin(), range.end());
+  if (size == 0) return 0;
+  auto const     first = range.begin();
+  std::ptrdiff_t count = 1;
+  for (std::ptrdiff_t i = 1; i < size; ++i) {
+    auto const it = ::hpc::impl::iterator_offset(first, i);
+    if (*it == *::hpc::impl::iterator_offset(first, count - 1)) continue;
+    *::hpc::impl::iterator_offset(first, count++) = std::move(*it);
+  }
+  return count;
+}
+
+template <class Range>
+HPC_NOINLINE std::ptrdiff_t
+unique(parallel_policy policy, Range& range)
+{
+  auto const first = range.begin();
+  auto const size  = ::hpc::impl::iterator_distance(first, range.end());
+  if (size == 0) return 0;
+  std::vector<std::ptrdiff_t> kept(static_cast<std::size_t>(size));
+  auto                        is_first = [=](std::ptrdiff_t const i) -> std::ptrdiff_t {
+    if (i == 0) return 1;
+    return (*::hpc::impl::iterator_offset(first, i) == *::hpc::impl::iterator_offset(first, i - 1)) ? 0 : 1;
+  };
+  ::hpc::transform_inclusive_scan(
+      policy, ::hpc::counting_range<std::ptrdiff_t>(size), kept, ::hpc::plus<std::ptrdiff_t>(), is_first);
+  return ::hpc::impl::stable_compact(policy, range, kept, false);
+}
+
+// Moves the items of \p range that satisfy \p pred before those that do not, keeping the order
+// within each group, and \return how many satisfy it
+template <class Range, class UnaryPredicate>
+HPC_NOINLINE std::ptrdiff_t
+partition(serial_policy, Range& range, UnaryPredicate pred)
+{
+  using value_type = typename Range::value_type;
+  std::vector<value_type> rest;
+  auto const              first = range.begin();
+  auto const              size  = ::hpc::impl::iterator_distance(first, range.end());
+  std::ptrdiff_t          count = 0;
+  for (std::ptrdiff_t i = 0; i < size; ++i) {
+    auto const it = ::hpc::impl::iterator_offset(first, i);
+    if (pred(*it)) {
+      *::hpc::impl::iterator_offset(first, count++) = std::move(*it);
+    } else {
+      rest.push_back(std::move(*it));
+    }
+  }
+  for (std::size_t i = 0; i < rest.size(); ++i) {
+    *::hpc::impl::iterator_offset(first, count + std::ptrdiff_t(i)) = std::move(rest[i]);
+  }
+  return count;
+}
+
+template <class Range, class UnaryPredicate>
+HPC_NOINLINE std::ptrdiff_t
+partition(parallel_policy policy, Range& range, UnaryPredicate pred)
+{
+  auto const first = range.begin();
+  auto const size  = ::hpc::impl::iterator_distance(first, range.end());
+  if (size == 0) return 0;
+  std::vector<std::ptrdiff_t> kept(static_cast<std::size_t>(size));
+  auto                        is_kept = [=](std::ptrdiff_t const i) -> std::ptrdiff_t {
+    return pred(*::hpc::impl::iterator_offset(first, i)) ? 1 : 0;
+  };
+  ::hpc::transform_inclusive_scan(
+      policy, ::hpc::counting_range<std::ptrdiff_t>(size), kept, ::hpc::plus<std::ptrdiff_t>(), is_kept);
+  return ::hpc::impl::stable_compact(policy, range, kept, true);
+}
+
 template <class ExecutionPolicy, class InputRange, class OutputRange>
 void
 offset_scan(ExecutionPolicy policy, InputRange const& input, OutputRange& output)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <hpc_index.hpp>
 #include <hpc_iterator.hpp>
 
 namespace hpc {
@@ -136,19 +137,270 @@ HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr counting_range<T>
   return counting_range<T>(size);
 }
 
+// layout::right stores each row contiguously and layout::left each column.
+// The blocked layouts store each column of a block of 4 or 8 consecutive rows contiguously
+// (array of structures of arrays), so that loops over rows can vectorize across a block.
 enum class layout
 {
   left,
   right,
+  blocked4,
+  blocked8,
 };
 
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr std::ptrdiff_t
+block_width(layout const L) noexcept
+{
+  return (L == layout::blocked4) ? 4 : ((L == layout::blocked8) ? 8 : 1);
+}
+
+// the number of rows a layout stores for a given number of rows, i.e. rounded up to whole blocks
+template <class Index>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr Index
+padded_size(layout const L, Index const size) noexcept
+{
+  auto const width = ::hpc::block_width(L);
+  return Index(((std::ptrdiff_t(::hpc::weaken(size)) + width - 1) / width) * width);
+}
+
 namespace impl {
 
+// steps through the columns of one row of a blocked layout, one block width apart;
+// layout::left and layout::right are specialized below
 template <class Iterator, layout L, class OuterIndex, class InnerIndex>
-class inner_iterator;
+class inner_iterator
+{
+  static_assert(::hpc::block_width(L) > 1, "inner_iterator needs a blocked layout");
+  static constexpr std::ptrdiff_t width = ::hpc::block_width(L);
+  Iterator                        m_begin;
 
+ public:
+  using value_type        = typename Iterator::value_type;
+  using size_type         = InnerIndex;
+  using difference_type   = InnerIndex;
+  using reference         = typename Iterator::reference;
+  using pointer           = typename Iterator::pointer;
+  using iterator_category = std::random_access_iterator_tag;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr explicit inner_iterator(Iterator impl_in) noexcept : m_begin(impl_in)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator==(inner_iterator const& other) const noexcept
+  {
+    return m_begin == other.m_begin;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator!=(inner_iterator const& other) const noexcept
+  {
+    return m_begin != other.m_begin;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr reference
+  operator*() const noexcept
+  {
+    return *m_begin;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE inner_iterator&
+                                    operator++() noexcept
+  {
+    m_begin += OuterIndex(width) * difference_type(1);
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE inner_iterator
+  operator++(int) noexcept
+  {
+    auto ret = *this;
+    m_begin += OuterIndex(width) * difference_type(1);
+    return ret;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE inner_iterator&
+                                    operator--() noexcept
+  {
+    m_begin -= OuterIndex(width) * difference_type(1);
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE inner_iterator
+  operator--(int) noexcept
+  {
+    auto ret = *this;
+    m_begin -= OuterIndex(width) * difference_type(1);
+    return ret;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE inner_iterator&
+                                    operator+=(difference_type const n) noexcept
+  {
+    m_begin += OuterIndex(width) * n;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE inner_iterator&
+                                    operator-=(difference_type const n) noexcept
+  {
+    m_begin -= OuterIndex(width) * n;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr inner_iterator
+  operator+(difference_type const n) const noexcept
+  {
+    return inner_iterator(m_begin + (OuterIndex(width) * n));
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr inner_iterator
+  operator-(difference_type const n) const noexcept
+  {
+    return inner_iterator(m_begin - (OuterIndex(width) * n));
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr reference
+  operator[](difference_type const n) const noexcept
+  {
+    return *((*this) + n);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator<(inner_iterator const& other) const noexcept
+  {
+    return m_begin < other.m_begin;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator>(inner_iterator const& other) const noexcept
+  {
+    return m_begin > other.m_begin;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator<=(inner_iterator const& other) const noexcept
+  {
+    return m_begin <= other.m_begin;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator>=(inner_iterator const& other) const noexcept
+  {
+    return m_begin >= other.m_begin;
+  }
+};
+
+// steps through the rows of a blocked layout, each starting at its lane of its block
 template <class Iterator, layout L, class OuterIndex, class InnerIndex>
-class outer_iterator;
+class outer_iterator
+{
+  static_assert(::hpc::block_width(L) > 1, "outer_iterator needs a blocked layout");
+  static constexpr std::ptrdiff_t width = ::hpc::block_width(L);
+  using product_type                    = decltype(OuterIndex() * InnerIndex());
+  Iterator                        m_begin;
+  OuterIndex                      m_row;
+  InnerIndex                      m_inner_size;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr Iterator
+  row_begin() const noexcept
+  {
+    auto const row  = std::ptrdiff_t(::hpc::weaken(m_row));
+    auto const lane = row % width;
+    return m_begin + product_type((row - lane) * std::ptrdiff_t(::hpc::weaken(m_inner_size)) + lane);
+  }
+
+ public:
+  using inner_iterator_type = inner_iterator<Iterator, L, OuterIndex, InnerIndex>;
+  using value_type          = ::hpc::iterator_range<inner_iterator_type>;
+  using difference_type     = OuterIndex;
+  using reference           = value_type;
+  using pointer             = value_type const*;
+  using iterator_category   = std::random_access_iterator_tag;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr outer_iterator(
+      Iterator const&   begin_in,
+      OuterIndex const& row_in,
+      InnerIndex const& inner_size_in)
+      : m_begin(begin_in), m_row(row_in), m_inner_size(inner_size_in)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator==(outer_iterator const& other) const noexcept
+  {
+    return m_row == other.m_row;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator!=(outer_iterator const& other) const noexcept
+  {
+    return m_row != other.m_row;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr reference
+  operator*() const noexcept
+  {
+    auto const first = row_begin();
+    return reference(inner_iterator_type(first), inner_iterator_type(first + OuterIndex(width) * m_inner_size));
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE outer_iterator&
+                                    operator++() noexcept
+  {
+    ++m_row;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE outer_iterator
+  operator++(int) noexcept
+  {
+    auto ret = *this;
+    ++m_row;
+    return ret;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE outer_iterator&
+                                    operator--() noexcept
+  {
+    --m_row;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE outer_iterator
+  operator--(int) noexcept
+  {
+    auto ret = *this;
+    --m_row;
+    return ret;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE outer_iterator&
+                                    operator+=(difference_type const n) noexcept
+  {
+    m_row += n;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE outer_iterator&
+                                    operator-=(difference_type const n) noexcept
+  {
+    m_row -= n;
+    return *this;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr outer_iterator
+  operator+(difference_type const n) const noexcept
+  {
+    return outer_iterator(m_begin, m_row + n, m_inner_size);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr outer_iterator
+  operator-(difference_type const n) const noexcept
+  {
+    return outer_iterator(m_begin, m_row - n, m_inner_size);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr difference_type
+  operator-(outer_iterator const& other) const noexcept
+  {
+    return m_row - other.m_row;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr reference
+  operator[](difference_type const n) const noexcept
+  {
+    return *((*this) + n);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator<(outer_iterator const& other) const noexcept
+  {
+    return m_row < other.m_row;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator>(outer_iterator const& other) const noexcept
+  {
+    return m_row > other.m_row;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator<=(outer_iterator const& other) const noexcept
+  {
+    return m_row <= other.m_row;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator>=(outer_iterator const& other) const noexcept
+  {
+    return m_row >= other.m_row;
+  }
+};
 
 template <class Iterator, class OuterIndex, class InnerIndex>
 class inner_iterator<Iterator, layout::right, OuterIndex, InnerIndex>
@@ -602,8 +854,67 @@ class outer_iterator<Iterator, layout::left, OuterIndex, InnerIndex>
 
 }  // namespace impl
 
+// the rows of a blocked layout over the outer index
 template <class Iterator, layout L, class OuterIndex, class InnerIndex>
-class range_product;
+class range_product
+{
+  Iterator   m_begin;
+  OuterIndex m_outer_size;
+  InnerIndex m_inner_size;
+
+ public:
+  using iterator        = ::hpc::impl::outer_iterator<Iterator, L, OuterIndex, InnerIndex>;
+  using const_iterator  = iterator;
+  using value_type      = typename iterator::value_type;
+  using size_type       = OuterIndex;
+  using difference_type = OuterIndex;
+  using reference       = typename iterator::reference;
+  using const_reference = typename iterator::reference;
+  using pointer         = typename iterator::pointer;
+  using const_pointer   = typename iterator::pointer;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr range_product(
+      Iterator const& begin_in,
+      OuterIndex      outer_size_in,
+      InnerIndex      inner_size_in) noexcept
+      : m_begin(begin_in), m_outer_size(outer_size_in), m_inner_size(inner_size_in)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr const_iterator
+  begin() const noexcept
+  {
+    return iterator(m_begin, OuterIndex(0), m_inner_size);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr const_iterator
+  cbegin() const noexcept
+  {
+    return iterator(m_begin, OuterIndex(0), m_inner_size);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr const_iterator
+  end() const noexcept
+  {
+    return iterator(m_begin, m_outer_size, m_inner_size);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr const_iterator
+  cend() const noexcept
+  {
+    return iterator(m_begin, m_outer_size, m_inner_size);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  empty() const noexcept
+  {
+    return size() == 0;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr size_type
+  size() const noexcept
+  {
+    return m_outer_size;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr value_type
+  operator[](difference_type const n) const noexcept
+  {
+    return begin()[n];
+  }
+};
 
 template <class Iterator, class OuterIndex, class InnerIndex>
 class range_product<Iterator, layout::right, OuterIndex, InnerIndex>
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cmath>
+#include <hpc_macros.hpp>
+
+namespace hpc {
+
+namespace impl {
+
+// GNU vector types of W lanes. They keep only the alignment of T so that packs can live in
+// ordinary containers; the compiler then emits unaligned vector loads and stores.
+template <class T, int W>
+struct simd_storage
+{
+  typedef T type __attribute__((vector_size(sizeof(T) * W), aligned(alignof(T))));
+  using mask_type = decltype(type() < type());
+};
+
+}  // namespace impl
+
+// bytes in the widest vector registers of the target
+#if defined(__AVX512F__)
+constexpr int simd_register_bytes = 64;
+#elif defined(__AVX__)
+constexpr int simd_register_bytes = 32;
+#else
+constexpr int simd_register_bytes = 16;
+#endif
+
+// The result of comparing two packs, lane by lane
+template <class T, int W>
+class simd_mask
+{
+ public:
+  using storage_type = typename impl::simd_storage<T, W>::mask_type;
+
+ private:
+  storage_type m_lanes;
+
+ public:
+  HPC_ALWAYS_INLINE
+  simd_mask() noexcept = default;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr simd_mask(storage_type const lanes) noexcept : m_lanes(lanes)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd_mask(bool const value) noexcept : m_lanes(storage_type() == storage_type())
+  {
+    if (!value) m_lanes = ~m_lanes;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr storage_type
+  lanes() const noexcept
+  {
+    return m_lanes;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr bool
+  operator[](int const lane) const noexcept
+  {
+    return m_lanes[lane] != 0;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd_mask
+  operator&&(simd_mask const left, simd_mask const right) noexcept
+  {
+    return simd_mask(left.m_lanes & right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd_mask
+  operator||(simd_mask const left, simd_mask const right) noexcept
+  {
+    return simd_mask(left.m_lanes | right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd_mask
+  operator!(simd_mask const mask) noexcept
+  {
+    return simd_mask(~mask.m_lanes);
+  }
+};
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE bool
+any(simd_mask<T, W> const mask) noexcept
+{
+  bool result = false;
+  for (int lane = 0; lane < W; ++lane) result = result || mask[lane];
+  return result;
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE bool
+all(simd_mask<T, W> const mask) noexcept
+{
+  bool result = true;
+  for (int lane = 0; lane < W; ++lane) result = result && mask[lane];
+  return result;
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE bool
+none(simd_mask<T, W> const mask) noexcept
+{
+  return !any(mask);
+}
+
+// A pack of W values of T that are operated on together. Tensor code instantiated with simd<T, W>
+// processes W tensors at once, one per lane, in vector registers.
+template <class T, int W>
+class simd
+{
+ public:
+  using value_type   = T;
+  using mask_type    = simd_mask<T, W>;
+  using storage_type = typename impl::simd_storage<T, W>::type;
+
+ private:
+  storage_type m_lanes;
+
+ public:
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE static constexpr int
+  size() noexcept
+  {
+    return W;
+  }
+  HPC_ALWAYS_INLINE
+  simd() noexcept = default;
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr simd(storage_type const lanes) noexcept : m_lanes(lanes)
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr simd(T const value) noexcept : m_lanes(value - storage_type())
+  {
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr storage_type
+  lanes() const noexcept
+  {
+    return m_lanes;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr T
+  operator[](int const lane) const noexcept
+  {
+    return m_lanes[lane];
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE T&
+                                    operator[](int const lane) noexcept
+  {
+    return reinterpret_cast<T*>(&m_lanes)[lane];
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd
+  operator-(simd const x) noexcept
+  {
+    return simd(-x.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd
+  operator+(simd const left, simd const right) noexcept
+  {
+    return simd(left.m_lanes + right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd
+  operator-(simd const left, simd const right) noexcept
+  {
+    return simd(left.m_lanes - right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd
+  operator*(simd const left, simd const right) noexcept
+  {
+    return simd(left.m_lanes * right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd
+  operator/(simd const left, simd const right) noexcept
+  {
+    return simd(left.m_lanes / right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd&
+  operator+=(simd& left, simd const right) noexcept
+  {
+    left.m_lanes += right.m_lanes;
+    return left;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd&
+  operator-=(simd& left, simd const right) noexcept
+  {
+    left.m_lanes -= right.m_lanes;
+    return left;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd&
+  operator*=(simd& left, simd const right) noexcept
+  {
+    left.m_lanes *= right.m_lanes;
+    return left;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend simd&
+  operator/=(simd& left, simd const right) noexcept
+  {
+    left.m_lanes /= right.m_lanes;
+    return left;
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend mask_type
+  operator<(simd const left, simd const right) noexcept
+  {
+    return mask_type(left.m_lanes < right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend mask_type
+  operator<=(simd const left, simd const right) noexcept
+  {
+    return mask_type(left.m_lanes <= right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend mask_type
+  operator>(simd const left, simd const right) noexcept
+  {
+    return mask_type(left.m_lanes > right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend mask_type
+  operator>=(simd const left, simd const right) noexcept
+  {
+    return mask_type(left.m_lanes >= right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend mask_type
+  operator==(simd const left, simd const right) noexcept
+  {
+    return mask_type(left.m_lanes == right.m_lanes);
+  }
+  HPC_ALWAYS_INLINE HPC_HOST_DEVICE friend mask_type
+  operator!=(simd const left, simd const right) noexcept
+  {
+    return mask_type(left.m_lanes != right.m_lanes);
+  }
+};
+
+// a pack that fills one vector register of the target
+template <class T>
+using native_simd = simd<T, int(simd_register_bytes / sizeof(T))>;
+
+// \return the lanes of \p left where \p mask is set and the lanes of \p right elsewhere
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+select(simd_mask<T, W> const mask, simd<T, W> const left, simd<T, W> const right) noexcept
+{
+  return simd<T, W>(mask.lanes() ? left.lanes() : right.lanes());
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+max(simd<T, W> const& left, simd<T, W> const& right) noexcept
+{
+  return select(left < right, right, left);
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+min(simd<T, W> const& left, simd<T, W> const& right) noexcept
+{
+  return select(right < left, right, left);
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+abs(simd<T, W> const x) noexcept
+{
+  return select(x < T(0), -x, x);
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+sqrt(simd<T, W> const x) noexcept
+{
+  simd<T, W> result;
+  for (int lane = 0; lane < W; ++lane) result[lane] = std::sqrt(x[lane]);
+  return result;
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+cbrt(simd<T, W> const x) noexcept
+{
+  simd<T, W> result;
+  for (int lane = 0; lane < W; ++lane) result[lane] = std::cbrt(x[lane]);
+  return result;
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+log(simd<T, W> const x) noexcept
+{
+  simd<T, W> result;
+  for (int lane = 0; lane < W; ++lane) result[lane] = std::log(x[lane]);
+  return result;
+}
+
+}  // namespace hpc
@@ -397,6 +397,33 @@ HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr symmetric3x3<T>
   return top / determinant(x);
 }
 
+#ifndef HPC_CUDA
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE constexpr symmetric3x3<T>
+                  get_lane(symmetric3x3<simd<T, W>> const& x, int const lane) noexcept
+{
+  return symmetric3x3<T>(x(S_XX)[lane], x(S_YY)[lane], x(S_ZZ)[lane], x(S_XY)[lane], x(S_YZ)[lane], x(S_XZ)[lane]);
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+set_lane(symmetric3x3<simd<T, W>>& x, int const lane, symmetric3x3<T> const& value) noexcept
+{
+  for (int i = 0; i < 6; ++i) {
+    x(i)[lane] = value(i);
+  }
+}
+
+template <class T, int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE simd<T, W>
+norm(symmetric3x3<simd<T, W>> const x) noexcept
+{
+  return sqrt(inner_product(x, x));
+}
+
+#endif
+
 template <class T>
 class array_traits<symmetric3x3<T>>
 {
@@ -0,0 +1,447 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <hpc_index.hpp>
+#include <hpc_macros.hpp>
+#include <hpc_range.hpp>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace hpc {
+
+namespace impl {
+
+// true while the calling thread is executing a task on behalf of a thread_pool,
+// used to run nested parallel algorithms serially instead of deadlocking
+inline bool&
+in_parallel_region() noexcept
+{
+  static thread_local bool value = false;
+  return value;
+}
+
+}  // namespace impl
+
+// A fork-join pool of persistent worker threads.
+// run(task) calls task(thread) once for every thread in [0, size()),
+// with thread 0 being the calling thread, and returns when all calls have returned.
+class thread_pool
+{
+  std::vector<std::thread> m_workers;
+  std::mutex               m_run_mutex;
+  std::mutex               m_mutex;
+  std::condition_variable  m_wake;
+  std::condition_variable  m_done;
+  std::function<void(int)> m_task;
+  std::uint64_t            m_epoch{0};
+  int                      m_busy{0};
+  bool                     m_stop{false};
+
+  void
+  work(int const thread)
+  {
+    std::uint64_t seen_epoch = 0;
+    ::hpc::impl::in_parallel_region() = true;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [&] { return m_stop || m_epoch != seen_epoch; });
+        if (m_stop) return;
+        seen_epoch = m_epoch;
+      }
+      m_task(thread);
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0) m_done.notify_one();
+      }
+    }
+  }
+
+ public:
+  explicit thread_pool(int const num_threads)
+  {
+    auto const num_workers = std::max(num_threads, 1) - 1;
+    m_workers.reserve(std::size_t(num_workers));
+    for (int worker = 0; worker < num_workers; ++worker) {
+      m_workers.emplace_back([this, worker] { work(worker + 1); });
+    }
+  }
+  thread_pool(thread_pool const&) = delete;
+  thread_pool&
+  operator=(thread_pool const&) = delete;
+  ~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) worker.join();
+  }
+  int
+  size() const noexcept
+  {
+    return int(m_workers.size()) + 1;
+  }
+  void
+  run(std::function<void(int)> const& task)
+  {
+    auto& in_parallel_region = ::hpc::impl::in_parallel_region();
+    if (m_workers.empty() || in_parallel_region) {
+      for (int thread = 0; thread < size(); ++thread) task(thread);
+      return;
+    }
+    std::lock_guard<std::mutex> run_lock(m_run_mutex);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_task = task;
+      m_busy = int(m_workers.size());
+      ++m_epoch;
+    }
+    m_wake.notify_all();
+    in_parallel_region = true;
+    task(0);
+    in_parallel_region = false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&] { return m_busy == 0; });
+  }
+};
+
+// HPC_NUM_THREADS if set, otherwise the number of hardware threads
+inline int
+default_num_threads() noexcept
+{
+  char const* const env = std::getenv("HPC_NUM_THREADS");
+  if (env != nullptr) {
+    int const n = std::atoi(env);
+    if (n > 0) return n;
+  }
+  return std::max(int(std::thread::hardware_concurrency()), 1);
+}
+
+inline thread_pool&
+default_thread_pool()
+{
+  static thread_pool pool(::hpc::default_num_threads());
+  return pool;
+}
+
+// Per-thread counters kept by a work_stealing_scheduler.
+// busy_seconds is only accumulated while timing is enabled.
+class scheduler_statistics
+{
+ public:
+  std::vector<std::uint64_t> chunks;
+  std::vector<std::uint64_t> steals;
+  std::vector<double>        busy_seconds;
+  // slowest thread over average thread busy time; 1 is perfect balance
+  double
+  imbalance() const noexcept
+  {
+    double total   = 0.0;
+    double slowest = 0.0;
+    for (auto const seconds : busy_seconds) {
+      total += seconds;
+      slowest = std::max(slowest, seconds);
+    }
+    if (total == 0.0) return 1.0;
+    return slowest * double(busy_seconds.size()) / total;
+  }
+};
+
+// Allocates storage aligned to alignof(T). Before C++17, std::allocator ignores an alignas wider than
+// alignof(std::max_align_t), which would let a cache-line-aligned type straddle two lines.
+template <class T>
+class aligned_allocator
+{
+ public:
+  using value_type      = T;
+  using is_always_equal = std::true_type;
+  aligned_allocator()   = default;
+  template <class U>
+  aligned_allocator(aligned_allocator<U> const&) noexcept
+  {
+  }
+  template <class U>
+  struct rebind
+  {
+    typedef ::hpc::aligned_allocator<U> other;
+  };
+  constexpr bool
+  operator==(aligned_allocator const&) const noexcept
+  {
+    return true;
+  }
+  constexpr bool
+  operator!=(aligned_allocator const&) const noexcept
+  {
+    return false;
+  }
+  T*
+  allocate(std::size_t n)
+  {
+    constexpr std::size_t alignment = std::max(alignof(T), sizeof(void*));
+    void*                 ptr       = nullptr;
+    if (posix_memalign(&ptr, alignment, n * sizeof(T)) != 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+  }
+  void
+  deallocate(T* p, std::size_t)
+  {
+    std::free(p);
+  }
+};
+
+// Distributes the chunks of a counting_range among the threads of a pool.
+// Each thread starts with a contiguous block of chunks and takes them from the front;
+// a thread that runs out steals the back half of the largest remaining block.
+class work_stealing_scheduler
+{
+  // one cache line per thread; the range [first, last) is packed as (first << 32) | last
+  class alignas(64) slot
+  {
+   public:
+    std::atomic<std::uint64_t> range{0};
+    std::uint64_t              chunks{0};
+    std::uint64_t              steals{0};
+    double                     busy_seconds{0.0};
+  };
+  thread_pool&                               m_pool;
+  std::vector<slot, aligned_allocator<slot>> m_slots;
+  std::mutex                                 m_mutex;
+  bool                                       m_timing{false};
+
+  static std::uint64_t
+  pack(std::uint64_t const first, std::uint64_t const last) noexcept
+  {
+    return (first << 32) | last;
+  }
+  static std::uint64_t
+  first_of(std::uint64_t const range) noexcept
+  {
+    return range >> 32;
+  }
+  static std::uint64_t
+  last_of(std::uint64_t const range) noexcept
+  {
+    return range & 0xFFFFFFFFu;
+  }
+  // takes the next chunk from the front of the thread's own block
+  bool
+  pop(slot& own, std::uint64_t& chunk) noexcept
+  {
+    auto range = own.range.load(std::memory_order_acquire);
+    while (first_of(range) < last_of(range)) {
+      auto const next = pack(first_of(range) + 1, last_of(range));
+      if (own.range.compare_exchange_weak(range, next, std::memory_order_acq_rel)) {
+        chunk = first_of(range);
+        return true;
+      }
+    }
+    return false;
+  }
+  // moves the back half of the largest block of another thread into the thread's own block
+  bool
+  steal(int const thief) noexcept
+  {
+    auto const thread_count = int(m_slots.size());
+    while (true) {
+      int           victim = -1;
+      std::uint64_t range  = 0;
+      for (int offset = 1; offset < thread_count; ++offset) {
+        auto const candidate       = (thief + offset) % thread_count;
+        auto const candidate_range = m_slots[std::size_t(candidate)].range.load(std::memory_order_acquire);
+        auto const remaining       = last_of(candidate_range) - first_of(candidate_range);
+        if (first_of(candidate_range) < last_of(candidate_range) &&
+            (victim == -1 || remaining > last_of(range) - first_of(range))) {
+          victim = candidate;
+          range  = candidate_range;
+        }
+      }
+      if (victim == -1) return false;
+      auto const first  = first_of(range);
+      auto const last   = last_of(range);
+      auto const middle = first + (last - first) / 2;
+      auto&      from   = m_slots[std::size_t(victim)].range;
+      if (from.compare_exchange_strong(range, pack(first, middle), std::memory_order_acq_rel)) {
+        m_slots[std::size_t(thief)].range.store(pack(middle, last), std::memory_order_release);
+        ++m_slots[std::size_t(thief)].steals;
+        return true;
+      }
+    }
+  }
+  template <class ChunkFunction>
+  void
+  run_chunk(slot& own, std::uint64_t const chunk, ChunkFunction& f)
+  {
+    ++own.chunks;
+    if (!m_timing) {
+      f(std::ptrdiff_t(chunk));
+      return;
+    }
+    auto const start = std::chrono::steady_clock::now();
+    f(std::ptrdiff_t(chunk));
+    own.busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+ public:
+  explicit work_stealing_scheduler(thread_pool& pool_in) : m_pool(pool_in), m_slots(std::size_t(pool_in.size()))
+  {
+  }
+  work_stealing_scheduler(work_stealing_scheduler const&) = delete;
+  work_stealing_scheduler&
+  operator=(work_stealing_scheduler const&) = delete;
+  // calls f(chunk) exactly once for every chunk in the range
+  template <class ChunkFunction>
+  void
+  for_each_chunk(::hpc::counting_range<std::ptrdiff_t> const& range, ChunkFunction&& f)
+  {
+    auto const chunk_first = std::uint64_t(*range.begin());
+    auto const chunk_last  = std::uint64_t(*range.end());
+    if (::hpc::impl::in_parallel_region()) {
+      for (auto chunk = chunk_first; chunk < chunk_last; ++chunk) f(std::ptrdiff_t(chunk));
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_slots.size() == 1 || chunk_last - chunk_first <= 1) {
+      ::hpc::impl::in_parallel_region() = true;
+      for (auto chunk = chunk_first; chunk < chunk_last; ++chunk) run_chunk(m_slots[0], chunk, f);
+      ::hpc::impl::in_parallel_region() = false;
+      return;
+    }
+    auto const thread_count = std::uint64_t(m_slots.size());
+    auto const chunk_count  = chunk_last - chunk_first;
+    for (std::uint64_t thread = 0; thread < thread_count; ++thread) {
+      auto const first = chunk_first + (chunk_count * thread) / thread_count;
+      auto const last  = chunk_first + (chunk_count * (thread + 1)) / thread_count;
+      m_slots[thread].range.store(pack(first, last), std::memory_order_relaxed);
+    }
+    m_pool.run([&](int const thread) {
+      auto&         own   = m_slots[std::size_t(thread)];
+      std::uint64_t chunk = 0;
+      do {
+        while (pop(own, chunk)) run_chunk(own, chunk, f);
+      } while (steal(thread));
+    });
+  }
+  void
+  enable_timing(bool const timing) noexcept
+  {
+    m_timing = timing;
+  }
+  scheduler_statistics
+  statistics()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    scheduler_statistics        result;
+    for (auto const& own : m_slots) {
+      result.chunks.push_back(own.chunks);
+      result.steals.push_back(own.steals);
+      result.busy_seconds.push_back(own.busy_seconds);
+    }
+    return result;
+  }
+  void
+  reset_statistics()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& own : m_slots) {
+      own.chunks       = 0;
+      own.steals       = 0;
+      own.busy_seconds = 0.0;
+    }
+  }
+};
+
+inline work_stealing_scheduler&
+default_scheduler()
+{
+  static work_stealing_scheduler scheduler(::hpc::default_thread_pool());
+  return scheduler;
+}
+
+namespace impl {
+
+// Splits [0, size) into contiguous chunks of at least grain_size items.
+// The split depends only on the size, not on the number of threads,
+// so reductions and scans give the same answer for any thread count.
+class chunk_partition
+{
+  std::ptrdiff_t m_size;
+  std::ptrdiff_t m_count;
+
+ public:
+  static constexpr std::ptrdiff_t grain_size      = 1024;
+  static constexpr std::ptrdiff_t max_chunk_count = 1024;
+  explicit chunk_partition(std::ptrdiff_t const size_in) noexcept
+      : m_size(size_in), m_count((size_in + grain_size - 1) / grain_size)
+  {
+    if (m_count < 1) m_count = 1;
+    if (m_count > max_chunk_count) m_count = max_chunk_count;
+  }
+  std::ptrdiff_t
+  size() const noexcept
+  {
+    return m_count;
+  }
+  std::ptrdiff_t
+  begin(std::ptrdiff_t const chunk) const noexcept
+  {
+    return (m_size * chunk) / m_count;
+  }
+  std::ptrdiff_t
+  end(std::ptrdiff_t const chunk) const noexcept
+  {
+    return (m_size * (chunk + 1)) / m_count;
+  }
+};
+
+template <class Iterator>
+HPC_ALWAYS_INLINE std::ptrdiff_t
+iterator_distance(Iterator const& first, Iterator const& last) noexcept
+{
+  return std::ptrdiff_t(::hpc::weaken(last - first));
+}
+
+template <class Iterator>
+HPC_ALWAYS_INLINE Iterator
+iterator_offset(Iterator const& first, std::ptrdiff_t const n) noexcept
+{
+  using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+  return first + difference_type(n);
+}
+
+// one partial result per chunk; wrapped so that std::vector<bool> is never used
+template <class T>
+class chunk_value
+{
+ public:
+  T value;
+};
+
+// Calls f(chunk, first, last) for every chunk of the partition,
+// distributing the chunks among the threads of the default pool.
+template <class ChunkFunction>
+void
+parallel_for_chunks(chunk_partition const& partition, ChunkFunction&& f)
+{
+  auto chunk_functor = [&](std::ptrdiff_t const chunk) { f(chunk, partition.begin(chunk), partition.end(chunk)); };
+  ::hpc::default_scheduler().for_each_chunk(::hpc::counting_range<std::ptrdiff_t>(partition.size()), chunk_functor);
+}
+
+}  // namespace impl
+
+}  // namespace hpc
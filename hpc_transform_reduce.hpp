@@ -1,6 +1,9 @@
 #pragma once
 
 #include <hpc_execution.hpp>
+#include <hpc_thread_pool.hpp>
+#include <utility>
+#include <vector>
 
 #ifdef HPC_CUDA
 
@@ -35,6 +38,29 @@ transform_reduce(serial_policy, Range const& range, T init, BinaryOp binary_op,
   return init;
 }
 
+template <class Range, class T, class BinaryOp, class UnaryOp>
+HPC_NOINLINE T
+transform_reduce(parallel_policy, Range const& range, T init, BinaryOp binary_op, UnaryOp unary_op)
+{
+  auto const first = range.begin();
+  auto const size  = ::hpc::impl::iterator_distance(first, range.end());
+  if (size == 0) return init;
+  ::hpc::impl::chunk_partition const       partition(size);
+  std::vector<::hpc::impl::chunk_value<T>> partial_sums(std::size_t(partition.size()), {init});
+  auto chunk_functor = [&](std::ptrdiff_t const chunk, std::ptrdiff_t const begin, std::ptrdiff_t const end) {
+    T sum = unary_op(*::hpc::impl::iterator_offset(first, begin));
+    for (auto i = begin + 1; i < end; ++i) {
+      sum = binary_op(std::move(sum), unary_op(*::hpc::impl::iterator_offset(first, i)));
+    }
+    partial_sums[std::size_t(chunk)].value = std::move(sum);
+  };
+  ::hpc::impl::parallel_for_chunks(partition, chunk_functor);
+  for (auto& partial_sum : partial_sums) {
+    init = binary_op(std::move(init), std::move(partial_sum.value));
+  }
+  return init;
+}
+
 #ifdef HPC_CUDA
 
 namespace impl {
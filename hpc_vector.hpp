@@ -5,6 +5,7 @@
 #include <hpc_index.hpp>
 #include <hpc_iterator.hpp>
 #include <hpc_memory.hpp>
+#include <hpc_numeric.hpp>
 
 namespace hpc {
 
@@ -211,6 +212,18 @@ copy(vector<T, A, P, I> const& from, vector<T, A, P, I>& to)
   hpc::copy(from.get_execution_policy(), from, to);
 }
 
+#ifndef HPC_CUDA
+
+// without CUDA, device and pinned vectors share host memory and differ only in execution policy
+template <class T, class A, class FromPolicy, class ToPolicy, class I>
+void
+copy(vector<T, A, FromPolicy, I> const& from, vector<T, A, ToPolicy, I>& to)
+{
+  hpc::copy(to.get_execution_policy(), from, to);
+}
+
+#endif
+
 #ifdef HPC_CUDA
 
 template <class T, class Index>
@@ -265,4 +278,62 @@ copy(device_vector<T, Index> const& from, pinned_vector<T, Index>& to)
 
 #endif
 
+namespace impl {
+
+template <class T, class A, class P, class I>
+T
+back(vector<T, A, P, I> const& v)
+{
+  return v.data()[weaken(v.size()) - 1];
+}
+
+#ifdef HPC_CUDA
+
+template <class T, class I>
+T
+back(device_vector<T, I> const& v)
+{
+  T value;
+#ifndef NDEBUG
+  auto const err =
+#endif
+      cudaMemcpy(&value, v.data() + (weaken(v.size()) - 1), sizeof(T), cudaMemcpyDeviceToHost);
+  assert(cudaSuccess == err);
+  return value;
+}
+
+#endif
+
+}  // namespace impl
+
+// Resizes \p output to the items of \p input that satisfy \p pred and copies them there in order.
+// The predicate is evaluated once per item: an inclusive scan of it gives each kept item its position,
+// and the last entry of the scan is the number kept.
+template <class ExecutionPolicy, class InputRange, class T, class A, class P, class I, class UnaryPredicate>
+void
+copy_if(ExecutionPolicy policy, InputRange const& input, vector<T, A, P, I>& output, UnaryPredicate pred)
+{
+  using input_value_type = typename InputRange::value_type;
+  using offset_allocator = typename std::allocator_traits<A>::template rebind_alloc<I>;
+  auto const size        = std::ptrdiff_t(input.size());
+  if (size == 0) {
+    output.resize(I(0));
+    return;
+  }
+  vector<I, offset_allocator, P, std::ptrdiff_t> offsets(size);
+  auto const unop = [=] HPC_DEVICE(input_value_type const item) { return pred(item) ? I(1) : I(0); };
+  ::hpc::transform_inclusive_scan(policy, input, offsets, ::hpc::plus<I>(), unop);
+  output.resize(::hpc::impl::back(offsets));
+  auto const first             = input.begin();
+  auto const items_to_offsets  = offsets.cbegin();
+  auto const outputs_to_values = output.begin();
+  auto       functor           = [=] HPC_DEVICE(std::ptrdiff_t const item) {
+    auto const offset = items_to_offsets[item];
+    if (offset != (item == 0 ? I(0) : items_to_offsets[item - 1])) {
+      outputs_to_values[offset - I(1)] = first[item];
+    }
+  };
+  ::hpc::for_each(policy, ::hpc::counting_range<std::ptrdiff_t>(size), functor);
+}
+
 }  // namespace hpc
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <hpc_functional.hpp>
 #include <hpc_limits.hpp>
 #include <hpc_macros.hpp>
 #include <hpc_math.hpp>
@@ -111,5 +112,88 @@ ViscoplasticHardeningRate(Properties const props, double const delta_eqps, doubl
   return Hvis;
 }
 
+// A view of a hardening curve tabulated at knots of equivalent plastic strain that start at zero and
+// increase. Between knots the flow strength is the cubic Hermite interpolant of the tabulated strength
+// and hardening rate, the hardening rate is its derivative and the potential its integral. Past the
+// last knot the strength grows at the last rate. An empty table selects the power law of Properties.
+// The knots are found through equal buckets of eqps, each holding the last knot at or before its start.
+struct HardeningTable
+{
+  double const* eqps{nullptr};
+  double const* strength{nullptr};
+  double const* rate{nullptr};
+  double const* potential{nullptr};
+  int const*    bucket_knots{nullptr};
+  double        buckets_per_eqps{0.0};
+  int           size{0};
+};
+
+// The interval of a table that holds some eqps, as the coefficients of its strength in the
+// normalized coordinate t along the interval
+struct TableSegment
+{
+  int    knot;
+  double h;
+  double t;
+  double c0;
+  double c1;
+  double c2;
+  double c3;
+};
+
+// \return the segment of \p table that holds \p eqps, which is before the last knot
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE TableSegment
+FindTableSegment(HardeningTable const table, double const eqps)
+{
+  int first = table.bucket_knots[int(hpc::max(eqps, 0.0) * table.buckets_per_eqps)];
+  while (table.eqps[first + 1] <= eqps) ++first;
+  double const h  = table.eqps[first + 1] - table.eqps[first];
+  double const Y0 = table.strength[first];
+  double const Y1 = table.strength[first + 1];
+  double const H0 = h * table.rate[first];
+  double const H1 = h * table.rate[first + 1];
+  return TableSegment{
+      first, h, (eqps - table.eqps[first]) / h, Y0, H0, 3.0 * (Y1 - Y0) - 2.0 * H0 - H1, 2.0 * (Y0 - Y1) + H0 + H1};
+}
+
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE double
+HardeningPotential(Properties const props, HardeningTable const table, double const eqps)
+{
+  if (table.size == 0) return HardeningPotential(props, eqps);
+
+  int const last = table.size - 1;
+  if (eqps >= table.eqps[last]) {
+    double const d = eqps - table.eqps[last];
+    return table.potential[last] + d * (table.strength[last] + 0.5 * d * table.rate[last]);
+  }
+  auto const   s = FindTableSegment(table, eqps);
+  double const t = s.t;
+  return table.potential[s.knot] + s.h * t * (s.c0 + t * (0.5 * s.c1 + t * (s.c2 / 3.0 + t * (0.25 * s.c3))));
+}
+
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE double
+FlowStrength(Properties const props, HardeningTable const table, double const eqps)
+{
+  if (table.size == 0) return FlowStrength(props, eqps);
+
+  int const last = table.size - 1;
+  if (eqps >= table.eqps[last]) return table.strength[last] + table.rate[last] * (eqps - table.eqps[last]);
+  auto const   s = FindTableSegment(table, eqps);
+  double const t = s.t;
+  return s.c0 + t * (s.c1 + t * (s.c2 + t * s.c3));
+}
+
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE double
+HardeningRate(Properties const props, HardeningTable const table, double const eqps)
+{
+  if (table.size == 0) return HardeningRate(props, eqps);
+
+  int const last = table.size - 1;
+  if (eqps >= table.eqps[last]) return table.rate[last];
+  auto const   s = FindTableSegment(table, eqps);
+  double const t = s.t;
+  return (s.c1 + t * (2.0 * s.c2 + t * (3.0 * s.c3))) / s.h;
+}
+
 }  // namespace j2
 }  // namespace lgr
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cmath>
+#include <hpc_macros.hpp>
+#include <hpc_vector.hpp>
+#include <j2/hardening.hpp>
+#include <utility>
+#include <vector>
+
+namespace lgr {
+
+namespace j2 {
+
+// Owns the knots of a tabulated hardening curve. Kernels read the device copy through table(),
+// and host code reads the host copy through host_table().
+class HardeningCurve
+{
+  std::vector<double>        m_eqps;
+  std::vector<double>        m_strength;
+  std::vector<double>        m_rate;
+  std::vector<double>        m_potential;
+  std::vector<int>           m_bucket_knots;
+  double                     m_buckets_per_eqps{0.0};
+  hpc::device_vector<double> m_device_eqps;
+  hpc::device_vector<double> m_device_strength;
+  hpc::device_vector<double> m_device_rate;
+  hpc::device_vector<double> m_device_potential;
+  hpc::device_vector<int>    m_device_bucket_knots;
+
+  template <class T>
+  static hpc::device_vector<T>
+  to_device(std::vector<T> const& from)
+  {
+    auto const            size = std::ptrdiff_t(from.size());
+    hpc::pinned_vector<T> pinned(size);
+    for (std::ptrdiff_t i = 0; i < size; ++i) pinned[i] = from[std::size_t(i)];
+    hpc::device_vector<T> to(size);
+    hpc::copy(pinned, to);
+    return to;
+  }
+
+ public:
+  HardeningCurve() = default;
+  HardeningCurve(std::vector<double> eqps, std::vector<double> strength, std::vector<double> rate)
+      : m_eqps(std::move(eqps)), m_strength(std::move(strength)), m_rate(std::move(rate)), m_potential(m_eqps.size())
+  {
+    HPC_ASSERT(m_eqps.size() >= 2, "a hardening curve needs at least two knots");
+    HPC_ASSERT(m_strength.size() == m_eqps.size() && m_rate.size() == m_eqps.size(), "mismatched hardening curve");
+    HPC_ASSERT(m_eqps.front() == 0.0, "a hardening curve must start at zero plastic strain");
+    m_potential[0] = 0.0;
+    for (std::size_t i = 0; i + 1 < m_eqps.size(); ++i) {
+      double const h = m_eqps[i + 1] - m_eqps[i];
+      HPC_ASSERT(h > 0.0, "hardening curve knots must increase");
+      m_potential[i + 1] =
+          m_potential[i] + h * (0.5 * (m_strength[i] + m_strength[i + 1]) + h * (m_rate[i] - m_rate[i + 1]) / 12.0);
+    }
+    auto const buckets = 4 * m_eqps.size();
+    m_buckets_per_eqps = double(buckets) / m_eqps.back();
+    m_bucket_knots.resize(buckets);
+    int knot = 0;
+    for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+      while (m_eqps[knot + 1] <= double(bucket) / m_buckets_per_eqps) ++knot;
+      m_bucket_knots[bucket] = knot;
+    }
+    m_device_eqps         = to_device(m_eqps);
+    m_device_strength     = to_device(m_strength);
+    m_device_rate         = to_device(m_rate);
+    m_device_potential    = to_device(m_potential);
+    m_device_bucket_knots = to_device(m_bucket_knots);
+  }
+  // \return a view of the knots in device memory, for capture by device kernels
+  HardeningTable
+  table() const noexcept
+  {
+    return HardeningTable{
+        m_device_eqps.data(),
+        m_device_strength.data(),
+        m_device_rate.data(),
+        m_device_potential.data(),
+        m_device_bucket_knots.data(),
+        m_buckets_per_eqps,
+        int(m_eqps.size())};
+  }
+  // \return a view of the knots in host memory, for evaluating the curve on the host
+  HardeningTable
+  host_table() const noexcept
+  {
+    return HardeningTable{
+        m_eqps.data(),
+        m_strength.data(),
+        m_rate.data(),
+        m_potential.data(),
+        m_bucket_knots.data(),
+        m_buckets_per_eqps,
+        int(m_eqps.size())};
+  }
+  int
+  size() const noexcept
+  {
+    return int(m_eqps.size());
+  }
+};
+
+// Tabulates the power law of \p props on [0, max_eqps], bisecting each interval until the interpolated
+// flow strength is within the relative \p tolerance of the law at the quarter points of the interval
+inline HardeningCurve
+TabulatePowerLaw(Properties const props, double const max_eqps, double const tolerance)
+{
+  std::vector<double> eqps{0.0};
+  std::vector<double> strength{FlowStrength(props, 0.0)};
+  std::vector<double> rate{HardeningRate(props, 0.0)};
+  // right ends of the intervals left to check, the next one last
+  std::vector<double> pending{max_eqps};
+  double const        min_width = max_eqps * 1.0e-12;
+  while (!pending.empty()) {
+    double const a  = eqps.back();
+    double const b  = pending.back();
+    double const h  = b - a;
+    double const Ya = strength.back();
+    double const Yb = FlowStrength(props, b);
+    double const Ha = h * rate.back();
+    double const Hb = h * HardeningRate(props, b);
+    double const c2 = 3.0 * (Yb - Ya) - 2.0 * Ha - Hb;
+    double const c3 = 2.0 * (Ya - Yb) + Ha + Hb;
+    bool         accurate{true};
+    for (double const t : {0.25, 0.5, 0.75}) {
+      double const Y = FlowStrength(props, a + t * h);
+      accurate       = accurate && std::abs(Ya + t * (Ha + t * (c2 + t * c3)) - Y) <= tolerance * std::abs(Y);
+    }
+    if (accurate || h <= min_width) {
+      eqps.push_back(b);
+      strength.push_back(Yb);
+      rate.push_back(Hb / h);
+      pending.pop_back();
+    } else {
+      pending.push_back(a + 0.5 * h);
+    }
+  }
+  return HardeningCurve(std::move(eqps), std::move(strength), std::move(rate));
+}
+
+// Tabulates a user-supplied flow strength curve. The hardening rates at the knots are the monotone
+// (Fritsch-Carlson) estimates, so the interpolant does not overshoot the data.
+inline HardeningCurve
+TabulateCurve(std::vector<double> eqps, std::vector<double> strength)
+{
+  auto const n = eqps.size();
+  HPC_ASSERT(n >= 2 && strength.size() == n, "a hardening curve needs at least two knots");
+  std::vector<double> slope(n - 1);
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    HPC_ASSERT(eqps[i + 1] > eqps[i], "hardening curve knots must increase");
+    slope[i] = (strength[i + 1] - strength[i]) / (eqps[i + 1] - eqps[i]);
+  }
+  std::vector<double> rate(n);
+  rate.front() = slope.front();
+  rate.back()  = slope.back();
+  for (std::size_t i = 1; i + 1 < n; ++i) {
+    if (slope[i - 1] * slope[i] <= 0.0) {
+      rate[i] = 0.0;
+    } else {
+      double const h0 = eqps[i] - eqps[i - 1];
+      double const h1 = eqps[i + 1] - eqps[i];
+      double const w0 = 2.0 * h1 + h0;
+      double const w1 = h1 + 2.0 * h0;
+      rate[i]         = (w0 + w1) / (w0 / slope[i - 1] + w1 / slope[i]);
+    }
+  }
+  return HardeningCurve(std::move(eqps), std::move(strength), std::move(rate));
+}
+
+}  // namespace j2
+}  // namespace lgr
@@ -1,10 +1,22 @@
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <hpc_vector3.hpp>
+#include <iomanip>
 #include <iostream>
+#include <lgr_distributed.hpp>
 #include <lgr_domain.hpp>
 #include <lgr_input.hpp>
+#include <lgr_layout.hpp>
 #include <lgr_physics.hpp>
+#include <map>
 #include <memory>
+#include <otm_materials.hpp>
+#include <string>
+#include <vector>
 
 namespace lgr {
 
@@ -547,10 +559,8 @@ swinging_cube(bool stabilize)
   run(in);
 }
 
-HPC_NOINLINE void
-twisting_column();
-void
-twisting_column()
+HPC_NOINLINE inline input
+twisting_column_input()
 {
   constexpr material_index body(0);
   constexpr material_index nmaterials(1);
@@ -604,9 +614,229 @@ twisting_column()
   in.enable_nodal_pressure[body] = false;
   in.c_tau[body]                 = 0.5;
   in.CFL                         = 0.9;
-  run(in);
+  return in;
+}
+
+HPC_NOINLINE void
+twisting_column();
+void
+twisting_column()
+{
+  run(twisting_column_input());
+}
+
+// times the twisting column, without file output, with each way of assembling nodal forces
+HPC_NOINLINE void
+benchmark_force_assembly();
+void
+benchmark_force_assembly()
+{
+  for (auto const assembly : {GATHER_FORCE_ASSEMBLY, COLORED_SCATTER_FORCE_ASSEMBLY}) {
+    auto in                    = twisting_column_input();
+    in.force_assembly          = assembly;
+    in.num_file_output_periods = 0;
+    in.output_to_command_line  = false;
+    auto const start           = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = (assembly == GATHER_FORCE_ASSEMBLY) ? "gather" : "colored scatter";
+    std::cout << "twisting_column with " << name << " force assembly: " << duration.count() << " ms\n";
+  }
+}
+
+// times the twisting column, without file output, with and without the fused per-point kernels,
+// and estimates the point and element-node bytes each midpoint step moves through memory
+HPC_NOINLINE void
+benchmark_fused_point_kernels();
+void
+benchmark_fused_point_kernels()
+{
+  constexpr std::size_t nodes_in_tet = 4;
+  constexpr std::size_t scalar       = sizeof(double);
+  constexpr std::size_t vector       = sizeof(hpc::velocity<double>);
+  constexpr std::size_t symmetric    = sizeof(hpc::symmetric_stress<double>);
+  constexpr std::size_t full         = sizeof(hpc::deformation_gradient<double>);
+  // the byte counts are tallied by hand from the fields each kernel reads and writes, not measured
+  // element nodes, their velocities and the basis gradients
+  constexpr std::size_t grad_v = nodes_in_tet * (sizeof(node_index) + vector + vector);
+  // update_symm_grad_v, stress_power, update_e, update_symm_grad_v, zeroing sigma and G, neo_Hookean, update_c,
+  // update_element_force, and update_element_dt on the last pass
+  constexpr std::size_t unfused_pass = (grad_v + symmetric) + (2 * symmetric + scalar) + 4 * scalar +
+                                       (grad_v + symmetric) + (symmetric + scalar) + (full + symmetric + 2 * scalar) +
+                                       4 * scalar + (symmetric + scalar + 2 * nodes_in_tet * vector);
+  constexpr std::size_t unfused_step = 2 * unfused_pass + 4 * scalar;
+  // fused_update_e, and fused_update_point_force, which reads the basis gradients only for the force
+  constexpr std::size_t fused_pass = (grad_v + symmetric + 3 * scalar) +
+                                     (nodes_in_tet * vector + full + symmetric) + (5 * scalar + nodes_in_tet * vector);
+  constexpr std::size_t fused_step = 2 * fused_pass + 2 * scalar;
+  for (auto const fused : {false, true}) {
+    auto in                       = twisting_column_input();
+    in.enable_fused_point_kernels = fused;
+    in.num_file_output_periods    = 0;
+    in.output_to_command_line     = false;
+    auto const start              = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = fused ? "fused" : "unfused";
+    auto const bytes    = fused ? fused_step : unfused_step;
+    std::cout << "twisting_column with " << name << " point kernels: " << duration.count() << " ms, estimated " << bytes
+              << " bytes per point per step\n";
+  }
 }
 
+// times the kernels of update_element_force and variational_J2 on synthetic linear tet data
+// stored in the given layout
+template <hpc::layout L>
+HPC_NOINLINE void
+benchmark_tensor_layout(char const* name)
+{
+  constexpr std::ptrdiff_t                                                       points = 1 << 17;
+  constexpr std::ptrdiff_t                                                       nodes  = 4;
+  constexpr int                                                                  repeat = 20;
+  hpc::counting_range<std::ptrdiff_t> const                                      point_range(points);
+  hpc::device_array_vector<hpc::symmetric_stress<double>, std::ptrdiff_t, L>     sigma(points);
+  hpc::device_array_vector<hpc::stress<double>, std::ptrdiff_t>                  sigma_full(points);
+  hpc::device_array_vector<hpc::basis_gradient<double>, std::ptrdiff_t, L>       grad_N(points * nodes);
+  hpc::device_array_vector<hpc::force<double>, std::ptrdiff_t>                   element_f(points * nodes);
+  hpc::device_array_vector<hpc::deformation_gradient<double>, std::ptrdiff_t, L> F_total(points);
+  hpc::device_array_vector<hpc::deformation_gradient<double>, std::ptrdiff_t, L> Fp_total(points);
+  hpc::device_vector<hpc::volume<double>, std::ptrdiff_t>                        V(points, 1.0e-3);
+  hpc::device_vector<hpc::strain<double>, std::ptrdiff_t>                        ep(points, 0.0);
+  hpc::fill(hpc::device_policy(), sigma, hpc::symmetric_stress<double>(1.0e6, 2.0e6, 3.0e6, 0.5e6, 0.2e6, 0.1e6));
+  hpc::fill(hpc::device_policy(), grad_N, hpc::basis_gradient<double>(1.0, -2.0, 3.0));
+  hpc::fill(
+      hpc::device_policy(), F_total, hpc::deformation_gradient<double>(1.0, 0.02, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0));
+  hpc::fill(hpc::device_policy(), Fp_total, hpc::deformation_gradient<double>::identity());
+  auto const points_to_sigma       = sigma.cbegin();
+  auto const points_to_V           = V.cbegin();
+  auto const point_nodes_to_grad_N = grad_N.cbegin();
+  auto const point_nodes_to_f      = element_f.begin();
+  auto       force_functor         = [=] HPC_DEVICE(std::ptrdiff_t const point) {
+    auto const sigma_point = points_to_sigma[point].load();
+    auto const V_point     = points_to_V[point];
+    for (std::ptrdiff_t node = 0; node < nodes; ++node) {
+      auto const point_node        = point * nodes + node;
+      auto const grad_N_point      = point_nodes_to_grad_N[point_node].load();
+      point_nodes_to_f[point_node] = -(sigma_point * grad_N_point) * V_point;
+    }
+  };
+  auto const     points_to_F          = F_total.cbegin();
+  auto const     points_to_Fp         = Fp_total.begin();
+  auto const     points_to_ep         = ep.begin();
+  auto const     points_to_sigma_full = sigma_full.begin();
+  j2::Properties props{1.0e9, 1.0e9, 1.0e6, 4.0, 1.0e-2, 1.0e6, 2.0, 1.0e-1};
+  auto           J2_functor = [=] HPC_DEVICE(std::ptrdiff_t const point) {
+    auto const F           = points_to_F[point].load();
+    auto       sigma_point = hpc::stress<double>::zero();
+    auto       K           = hpc::pressure<double>(0.0);
+    auto       G           = hpc::pressure<double>(0.0);
+    auto       W           = hpc::energy_density<double>(0.0);
+    auto       Fp          = points_to_Fp[point].load();
+    auto       ep_point    = points_to_ep[point];
+    variational_J2_point(F, props, hpc::time<double>(1.0e-6), sigma_point, K, G, W, Fp, ep_point);
+    points_to_sigma_full[point] = sigma_point;
+  };
+  auto const force_start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < repeat; ++i) hpc::for_each(hpc::device_policy(), point_range, force_functor);
+  auto const force_stop = std::chrono::high_resolution_clock::now();
+  auto const J2_start   = force_stop;
+  for (int i = 0; i < repeat; ++i) hpc::for_each(hpc::device_policy(), point_range, J2_functor);
+  auto const J2_stop = std::chrono::high_resolution_clock::now();
+  auto const nanoseconds_per_point = [&](auto const start, auto const stop) {
+    auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+    return double(duration.count()) / double(repeat * points);
+  };
+  std::cout << name << " layout: element force " << nanoseconds_per_point(force_start, force_stop)
+            << " ns per point, variational J2 " << nanoseconds_per_point(J2_start, J2_stop) << " ns per point\n";
+}
+
+HPC_NOINLINE void
+benchmark_tensor_layouts();
+void
+benchmark_tensor_layouts()
+{
+  std::cout << std::fixed << std::setprecision(2);
+  benchmark_tensor_layout<hpc::layout::right>("right");
+  benchmark_tensor_layout<hpc::layout::blocked4>("blocked4");
+  benchmark_tensor_layout<hpc::layout::blocked8>("blocked8");
+}
+
+#ifndef HPC_CUDA
+
+// times one 3x3 tensor kernel on scalar tensors and on batches of tensors held in simd lanes,
+// and reports the largest difference between the two, relative to tensors of unit norm or larger
+template <class Batch, class Kernel>
+HPC_NOINLINE void
+benchmark_batched_tensor_kernel(
+    char const*                                name,
+    std::vector<hpc::matrix3x3<double>> const& tensors,
+    std::vector<hpc::matrix3x3<Batch>> const&  batches,
+    Kernel const                               kernel)
+{
+  constexpr int                       repeat = 10;
+  constexpr int                       width  = Batch::size();
+  std::vector<hpc::matrix3x3<double>> results(tensors.size());
+  std::vector<hpc::matrix3x3<Batch>>  batch_results(batches.size());
+  auto const                          scalar_start = std::chrono::high_resolution_clock::now();
+  for (int r = 0; r < repeat; ++r) {
+    for (std::size_t i = 0; i < tensors.size(); ++i) results[i] = kernel(tensors[i]);
+  }
+  auto const scalar_stop = std::chrono::high_resolution_clock::now();
+  auto const batch_start = scalar_stop;
+  for (int r = 0; r < repeat; ++r) {
+    for (std::size_t i = 0; i < batches.size(); ++i) batch_results[i] = kernel(batches[i]);
+  }
+  auto const batch_stop = std::chrono::high_resolution_clock::now();
+  auto       difference = 0.0;
+  for (std::size_t i = 0; i < tensors.size(); ++i) {
+    auto const lane = hpc::get_lane(batch_results[i / width], int(i % width));
+    difference      = hpc::max(difference, hpc::norm(lane - results[i]) / hpc::max(hpc::norm(results[i]), 1.0));
+  }
+  auto const nanoseconds_per_tensor = [&](auto const start, auto const stop) {
+    auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+    return double(duration.count()) / double(repeat * tensors.size());
+  };
+  auto const scalar_time = nanoseconds_per_tensor(scalar_start, scalar_stop);
+  auto const batch_time  = nanoseconds_per_tensor(batch_start, batch_stop);
+  std::cout << std::setw(18) << name << ": scalar " << scalar_time << " ns, batched " << batch_time
+            << " ns per tensor, speedup " << scalar_time / batch_time << ", difference " << std::scientific
+            << difference << std::fixed << "\n";
+}
+
+// times the scalar and simd-batched 3x3 tensor kernels on deformation-gradient-like tensors
+HPC_NOINLINE void
+benchmark_batched_tensor_kernels();
+void
+benchmark_batched_tensor_kernels()
+{
+  using batch                         = hpc::native_simd<double>;
+  constexpr int                       count = 1 << 14;
+  auto const                          G     = hpc::matrix3x3<double>(0.5, 0.3, 0.1, -0.2, -0.4, 0.05, 0.1, 0.0, 0.2);
+  std::vector<hpc::matrix3x3<double>> tensors(count);
+  std::vector<hpc::matrix3x3<batch>>  batches(count / batch::size());
+  for (int i = 0; i < count; ++i) {
+    tensors[i] = hpc::matrix3x3<double>::identity() + (double(i % 101) / 100.0) * G;
+    hpc::set_lane(batches[i / batch::size()], i % batch::size(), tensors[i]);
+  }
+  std::cout << std::fixed << std::setprecision(2);
+  benchmark_batched_tensor_kernel(
+      "determinant", tensors, batches, [](auto const& A) { return hpc::determinant(A) * A; });
+  benchmark_batched_tensor_kernel("inverse", tensors, batches, [](auto const& A) { return hpc::inverse(A); });
+  benchmark_batched_tensor_kernel("symmetric inverse", tensors, batches, [](auto const& A) {
+    using symmetric = hpc::symmetric3x3<typename std::decay_t<decltype(A)>::scalar_type>;
+    return hpc::inverse(symmetric(A)).full();
+  });
+  benchmark_batched_tensor_kernel("exp", tensors, batches, [](auto const& A) { return hpc::exp(A); });
+  benchmark_batched_tensor_kernel("log", tensors, batches, [](auto const& A) { return hpc::log(A); });
+  benchmark_batched_tensor_kernel("sqrt", tensors, batches, [](auto const& A) { return hpc::sqrt(A); });
+  benchmark_batched_tensor_kernel(
+      "polar_rotation", tensors, batches, [](auto const& A) { return hpc::polar_rotation(A); });
+}
+
+#endif
+
 HPC_NOINLINE void
 Noh_1D();
 void
@@ -798,10 +1028,8 @@ twisting_composite_column()
   run(in);
 }
 
-HPC_NOINLINE void
-twisting_composite_column_J2();
-void
-twisting_composite_column_J2()
+HPC_NOINLINE inline input
+twisting_composite_column_J2_input()
 {
   constexpr material_index body(0);
   constexpr material_index nmaterials(1);
@@ -863,9 +1091,275 @@ twisting_composite_column_J2()
   in.zero_acceleration_conditions.push_back({y_min, z_axis});
   in.enable_J_averaging = true;
   in.CFL                = 0.05;
+  return in;
+}
+
+HPC_NOINLINE void
+twisting_composite_column_J2();
+void
+twisting_composite_column_J2()
+{
+  run(twisting_composite_column_J2_input());
+}
+
+// times the first hundredth of the J2 twisting composite column, without file output, with the scalar and
+// the simd-batched return mapping
+HPC_NOINLINE void
+benchmark_batched_J2();
+void
+benchmark_batched_J2()
+{
+  for (auto const batched : {false, true}) {
+    auto in                    = twisting_composite_column_J2_input();
+    in.enable_batched_J2       = batched;
+    in.end_time                = 0.001;
+    in.num_file_output_periods = 0;
+    in.output_to_command_line  = false;
+    auto const start           = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = batched ? "batched" : "scalar";
+    std::cout << "twisting_composite_column_J2 with " << name << " return mapping: " << duration.count() << " ms\n";
+  }
+}
+
+// times the first hundredth of the J2 twisting composite column, without file output, with the power
+// law hardening and with its table
+HPC_NOINLINE void
+benchmark_tabulated_hardening();
+void
+benchmark_tabulated_hardening()
+{
+  constexpr material_index body(0);
+  for (auto const tabulated : {false, true}) {
+    auto in                    = twisting_composite_column_J2_input();
+    in.end_time                = 0.001;
+    in.num_file_output_periods = 0;
+    in.output_to_command_line  = false;
+    if (tabulated) {
+      j2::Properties const props{
+          in.K0[body],
+          in.G0[body],
+          in.Y0[body],
+          in.n[body],
+          in.eps0[body],
+          in.Svis0[body],
+          in.m[body],
+          in.eps_dot0[body]};
+      in.hardening_curve[body] = j2::TabulatePowerLaw(props, 1.0, 1.0e-10);
+    }
+    auto const start = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = tabulated ? "tabulated" : "power law";
+    std::cout << "twisting_composite_column_J2 with " << name << " hardening: " << duration.count() << " ms\n";
+  }
+}
+
+// a copper block of four layers, each its own material with nodal pressure and energy, whose bottom
+// layer is thrown into the others
+HPC_NOINLINE inline input
+layered_block_input()
+{
+  constexpr material_index nmaterials(4);
+  constexpr material_index nboundaries(0);
+  input                    in(nmaterials, nboundaries);
+  in.name                           = "layered_block";
+  in.element                        = TETRAHEDRON;
+  in.elements_along_x               = 12;
+  in.x_domain_size                  = 1.0e-3;
+  in.elements_along_y               = 12;
+  in.y_domain_size                  = 1.0e-3;
+  in.elements_along_z               = 24;
+  in.z_domain_size                  = 2.0e-3;
+  in.end_time                       = 1.0e-7;
+  in.num_file_output_periods        = 10;
+  in.CFL                            = 0.5;
+  in.enable_viscosity               = true;
+  in.linear_artificial_viscosity    = 0.5;
+  in.quadratic_artificial_viscosity = 2.0;
+  auto const   rho                  = hpc::density<double>(8.93e+03);
+  auto const   nu                   = hpc::adimensional<double>(0.343);
+  auto const   E                    = hpc::pressure<double>(130.6e09);
+  double const layer                = in.z_domain_size / double(hpc::weaken(nmaterials));
+  double const eps                  = layer * 1.0e-3;
+  for (auto const material : in.materials) {
+    in.enable_nodal_pressure[material]    = true;
+    in.enable_nodal_energy[material]      = true;
+    in.enable_neo_Hookean[material]       = true;
+    in.enable_Mie_Gruneisen_eos[material] = true;
+    in.use_global_tau[material]           = true;
+    in.c_tau[material]                    = 0.0;
+    in.rho0[material]                     = rho;
+    in.K0[material]                       = E / (3.0 * (1.0 - 2.0 * nu));
+    in.G0[material]                       = E / (2.0 * (1.0 + nu));
+    in.gamma[material]                    = 1.99;
+    in.s[material]                        = 1.489;
+    in.e0[material]                       = 0.0;
+    if (material != material_index(0)) {
+      double const bottom  = layer * double(hpc::weaken(material));
+      in.domains[material] = box_domain({-eps, -eps, bottom}, {1.0e-3 + eps, 1.0e-3 + eps, bottom + layer});
+    }
+  }
+  in.initial_v = [=](hpc::counting_range<node_index> const                              nodes,
+                     hpc::device_array_vector<hpc::position<double>, node_index> const& x_vector,
+                     hpc::device_array_vector<hpc::velocity<double>, node_index>*       v_vector) {
+    auto const nodes_to_x = x_vector.cbegin();
+    auto const nodes_to_v = v_vector->begin();
+    auto       functor    = [=] HPC_DEVICE(node_index const node) {
+      auto const x     = nodes_to_x[node].load();
+      auto const speed = x(2) < layer - eps ? 200.0 : 0.0;
+      nodes_to_v[node] = hpc::velocity<double>(0.0, 0.0, speed);
+    };
+    hpc::for_each(hpc::device_policy(), nodes, functor);
+  };
+  return in;
+}
+
+HPC_NOINLINE void
+layered_block();
+void
+layered_block()
+{
+  run(layered_block_input());
+}
+
+// the layered block with the nodal kernels of its four materials fused, to compare with layered_block
+HPC_NOINLINE void
+layered_block_fused();
+void
+layered_block_fused()
+{
+  auto in                       = layered_block_input();
+  in.name                       = "layered_block_fused";
+  in.enable_fused_nodal_kernels = true;
   run(in);
 }
 
+// times the layered block, without file output, with the nodal kernels run per material and fused
+HPC_NOINLINE void
+benchmark_fused_nodal_kernels();
+void
+benchmark_fused_nodal_kernels()
+{
+  for (auto const fused : {false, true}) {
+    auto in                       = layered_block_input();
+    in.enable_fused_nodal_kernels = fused;
+    in.num_file_output_periods    = 0;
+    in.output_to_command_line     = false;
+    auto const start              = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = fused ? "fused" : "per-material";
+    std::cout << "layered_block with " << name << " nodal kernels: " << duration.count() << " ms\n";
+  }
+}
+
+// times a finer layered block, without file output, in the generator's numbering and in Hilbert order
+HPC_NOINLINE void
+benchmark_mesh_ordering();
+void
+benchmark_mesh_ordering()
+{
+  for (auto const ordering : {INPUT_MESH_ORDERING, HILBERT_MESH_ORDERING}) {
+    auto in                    = layered_block_input();
+    in.mesh_ordering           = ordering;
+    in.elements_along_x        = 40;
+    in.elements_along_y        = 40;
+    in.elements_along_z        = 80;
+    in.end_time                = 1.0e-8;
+    in.num_file_output_periods = 0;
+    in.output_to_command_line  = false;
+    auto const start           = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = (ordering == INPUT_MESH_ORDERING) ? "input" : "Hilbert";
+    std::cout << "layered_block 40x40x80 in " << name << " mesh ordering: " << duration.count() << " ms\n";
+  }
+}
+
+// times a finer layered block, without file output, with the basis gradients stored per point node and
+// recomputed from the nodal positions by each kernel that reads them
+HPC_NOINLINE void
+benchmark_grad_N_recompute();
+void
+benchmark_grad_N_recompute()
+{
+  constexpr std::size_t stored_bytes = 4 * sizeof(hpc::basis_gradient<point_storage>);
+  for (auto const recompute : {false, true}) {
+    auto in                    = layered_block_input();
+    in.recompute_grad_N        = recompute;
+    in.elements_along_x        = 40;
+    in.elements_along_y        = 40;
+    in.elements_along_z        = 80;
+    in.end_time                = 1.0e-8;
+    in.num_file_output_periods = 0;
+    in.output_to_command_line  = false;
+    auto const start           = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop     = std::chrono::high_resolution_clock::now();
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto const name     = recompute ? "recomputed" : "stored";
+    auto const bytes    = recompute ? std::size_t(0) : stored_bytes;
+    std::cout << "layered_block 40x40x80 with " << name << " basis gradients: " << duration.count() << " ms, "
+              << bytes << " bytes of grad_N per point\n";
+  }
+}
+
+// times a layered block with each file output format against one without file output, and reports the
+// time the output adds to the run, which is less than the time spent writing when the background writer
+// has a core of its own, and the rate that makes
+HPC_NOINLINE void
+benchmark_vtk_output();
+void
+benchmark_vtk_output()
+{
+  auto const time_run = [](output_format_kind const format, int const num_file_output_periods) {
+    auto in                    = layered_block_input();
+    in.output_format           = format;
+    in.elements_along_x        = 16;
+    in.elements_along_y        = 16;
+    in.elements_along_z        = 32;
+    in.end_time                = 1.0e-8;
+    in.num_file_output_periods = num_file_output_periods;
+    in.output_to_command_line  = false;
+    auto const start           = std::chrono::high_resolution_clock::now();
+    run(in);
+    auto const stop = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+  };
+  constexpr int                   periods  = 10;
+  auto const                      baseline = time_run(ASCII_VTK_OUTPUT_FORMAT, 0);
+  std::vector<output_format_kind> formats{ASCII_VTK_OUTPUT_FORMAT, RAW_VTU_OUTPUT_FORMAT};
+#ifdef LGR_ENABLE_ZLIB
+  formats.push_back(ZLIB_VTU_OUTPUT_FORMAT);
+#endif
+  char const* names[] = {"ASCII VTK", "raw VTU", "zlib VTU"};
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "layered_block 16x16x32 without file output: " << baseline * 1.0e3 << " ms\n";
+  for (auto const format : formats) {
+    auto const  seconds   = time_run(format, periods) - baseline;
+    auto const  extension = (format == ASCII_VTK_OUTPUT_FORMAT) ? ".vtk" : ".vtu";
+    std::size_t bytes     = 0;
+    for (int index = 0; index <= periods; ++index) {
+      auto const    filename = "layered_block_" + std::to_string(index) + extension;
+      std::ifstream file(filename, std::ios::binary | std::ios::ate);
+      if (!file.is_open()) continue;
+      bytes += std::size_t(file.tellg());
+      file.close();
+      std::remove(filename.c_str());
+    }
+    auto const megabytes = double(bytes) / 1.0e6;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "layered_block 16x16x32 in " << names[format] << ": " << megabytes << " MB adding "
+              << seconds * 1.0e3 << " ms to the run, " << megabytes / seconds << " MB/s\n";
+  }
+}
+
 HPC_NOINLINE void
 flyer_target_stabilized_tet();
 void
@@ -1900,6 +2394,94 @@ triple_point()
   run(in);
 }
 
+// Compares two legacy VTK files written by the same problem, such as by a build configured with
+// LGR_POINT_STORAGE=float and by one that stores everything in double, or by runs with and without fused nodal
+// kernels. Prints the largest difference in each field relative to the largest magnitude of that field in
+// \p reference_filename. Returns whether the files agree on everything that is not a number and no field differs
+// by more than \p tolerance relative to its magnitude or \p absolute_tolerance, whichever is larger; the latter
+// keeps fields that are only roundoff from failing.
+HPC_NOINLINE bool
+compare_vtk_files(
+    std::string const& filename,
+    std::string const& reference_filename,
+    double const       tolerance,
+    double const       absolute_tolerance);
+bool
+compare_vtk_files(
+    std::string const& filename,
+    std::string const& reference_filename,
+    double const       tolerance,
+    double const       absolute_tolerance)
+{
+  std::ifstream stream(filename.c_str());
+  std::ifstream reference_stream(reference_filename.c_str());
+  if (!stream.is_open() || !reference_stream.is_open()) {
+    std::cout << "could not open " << (stream.is_open() ? reference_filename : filename) << "\n";
+    return false;
+  }
+  class field_difference
+  {
+   public:
+    double difference{0.0};
+    double magnitude{0.0};
+  };
+  std::map<std::string, field_difference> differences;
+  std::vector<std::string>                fields;
+  std::string                             field = "header";
+  std::string                             token;
+  std::string                             reference_token;
+  bool                                    named_next = false;
+  // the sizes that follow a section or field keyword, which must match exactly
+  int sizes_next = 0;
+  while (reference_stream >> reference_token) {
+    if (!(stream >> token)) {
+      std::cout << filename << " ends before " << reference_filename << "\n";
+      return false;
+    }
+    char*        end             = nullptr;
+    double const reference_value = std::strtod(reference_token.c_str(), &end);
+    auto const   is_number       = (*end == '\0');
+    if (!is_number || sizes_next > 0) {
+      if (token != reference_token) {
+        std::cout << "found \"" << token << "\" where " << reference_filename << " has \"" << reference_token << "\"\n";
+        return false;
+      }
+      if (is_number) --sizes_next;
+      if (named_next) field = token;
+      named_next = (token == "SCALARS" || token == "VECTORS" || token == "TENSORS");
+      if (token == "POINTS" || token == "CELLS") field = token;
+      if (token == "POINTS" || token == "CELL_TYPES" || token == "POINT_DATA" || token == "CELL_DATA") sizes_next = 1;
+      if (token == "CELLS") sizes_next = 2;
+      if (token == "SCALARS") sizes_next = 1;
+      continue;
+    }
+    double const value = std::strtod(token.c_str(), nullptr);
+    if (std::isnan(value) != std::isnan(reference_value)) {
+      std::cout << "found " << value << " where " << reference_filename << " has " << reference_value << "\n";
+      return false;
+    }
+    if (differences.count(field) == 0) fields.push_back(field);
+    auto& field_entry      = differences[field];
+    field_entry.difference = std::max(field_entry.difference, std::abs(value - reference_value));
+    field_entry.magnitude  = std::max(field_entry.magnitude, std::abs(reference_value));
+  }
+  if (stream >> token) {
+    std::cout << reference_filename << " ends before " << filename << "\n";
+    return false;
+  }
+  bool within_tolerance = true;
+  std::cout << std::scientific << std::setprecision(3);
+  for (auto const& name : fields) {
+    auto const& field_entry = differences[name];
+    auto const  relative    = field_entry.magnitude > 0.0 ? field_entry.difference / field_entry.magnitude : 0.0;
+    auto const  exceeds     = field_entry.difference > std::max(tolerance * field_entry.magnitude, absolute_tolerance);
+    if (exceeds) within_tolerance = false;
+    std::cout << std::left << std::setw(24) << name << std::right << " max difference " << field_entry.difference
+              << " relative " << relative << (exceeds ? " above tolerance" : "") << "\n";
+  }
+  return within_tolerance;
+}
+
 }  // namespace lgr
 
 HPC_NOINLINE void
@@ -1928,9 +2510,41 @@ run_for_average()
 int
 main(int ac, char* av[])
 {
-  std::string const problem = ac > 1 ? av[1] : "";
+  lgr::distributed_scope const distributed(&ac, &av);
+  std::string const            problem = ac > 1 ? av[1] : "";
   HPC_TRAP_FPE();
-  if (problem == "composite_Noh_3D")
+  if (problem == "compare_vtk") {
+    if (ac < 4) {
+      std::cout << "usage: lgr compare_vtk <file> <reference file> [relative tolerance] [absolute tolerance]\n";
+      return 1;
+    }
+    auto const tolerance          = ac > 4 ? std::atof(av[4]) : 1.0e-6;
+    auto const absolute_tolerance = ac > 5 ? std::atof(av[5]) : 0.0;
+    return lgr::compare_vtk_files(av[2], av[3], tolerance, absolute_tolerance) ? 0 : 1;
+  }
+  if (problem == "benchmark_batched_J2")
+    lgr::benchmark_batched_J2();
+#ifndef HPC_CUDA
+  else if (problem == "benchmark_batched_tensor_kernels")
+    lgr::benchmark_batched_tensor_kernels();
+#endif
+  else if (problem == "benchmark_force_assembly")
+    lgr::benchmark_force_assembly();
+  else if (problem == "benchmark_fused_nodal_kernels")
+    lgr::benchmark_fused_nodal_kernels();
+  else if (problem == "benchmark_fused_point_kernels")
+    lgr::benchmark_fused_point_kernels();
+  else if (problem == "benchmark_grad_N_recompute")
+    lgr::benchmark_grad_N_recompute();
+  else if (problem == "benchmark_mesh_ordering")
+    lgr::benchmark_mesh_ordering();
+  else if (problem == "benchmark_tabulated_hardening")
+    lgr::benchmark_tabulated_hardening();
+  else if (problem == "benchmark_tensor_layouts")
+    lgr::benchmark_tensor_layouts();
+  else if (problem == "benchmark_vtk_output")
+    lgr::benchmark_vtk_output();
+  else if (problem == "composite_Noh_3D")
     lgr::composite_Noh_3D();
   else if (problem == "Cooks_membrane")
     lgr::Cooks_membrane();
@@ -1946,6 +2560,10 @@ main(int ac, char* av[])
     lgr::flyer_target_stabilized_tet();
   else if (problem == "gas_expansion")
     lgr::gas_expansion();
+  else if (problem == "layered_block")
+    lgr::layered_block();
+  else if (problem == "layered_block_fused")
+    lgr::layered_block_fused();
   else if (problem == "Noh_1D")
     lgr::Noh_1D();
   else if (problem == "Noh_2D_0_0")
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <lgr_adapt.hpp>
 #include <lgr_adapt_util.hpp>
+#include <lgr_basis_gradients.hpp>
 #include <lgr_element_specific_inline.hpp>
 #include <lgr_input.hpp>
 #include <lgr_meshing.hpp>
@@ -97,18 +98,17 @@ HPC_NOINLINE inline void
 update_tetrahedron_quality(state& s)
 {
   auto const points_to_V           = s.V.cbegin();
-  auto const point_nodes_to_grad_N = s.grad_N.cbegin();
+  auto const points_to_grad_N      = basis_gradients(s);
   auto const elements_to_quality   = s.quality.begin();
-  auto const points_to_point_nodes = s.points * s.nodes_in_element;
   auto const nodes_in_element      = s.nodes_in_element;
   auto const elements_to_points    = s.elements * s.points_in_element;
   auto       functor               = [=] HPC_DEVICE(element_index const element) {
     constexpr point_in_element_index    fp(0);
-    auto const                          point       = elements_to_points[element][fp];
-    auto const                          point_nodes = points_to_point_nodes[point];
-    decltype(1.0 / hpc::area<double>()) sum_g_i_sq  = 0.0;
+    auto const                          point        = elements_to_points[element][fp];
+    auto const                          point_grad_N = points_to_grad_N(element, point);
+    decltype(1.0 / hpc::area<double>()) sum_g_i_sq   = 0.0;
     for (auto const i : nodes_in_element) {
-      auto const grad_N = point_nodes_to_grad_N[point_nodes[i]].load();
+      auto const grad_N = point_grad_N[i];
       auto const g_i_sq = (grad_N * grad_N);
       sum_g_i_sq += g_i_sq;
     }
@@ -885,7 +885,7 @@ adapt(input const& in, state& s)
   } else {
     transfer_nodal_energy(in, a, s);
   }
-  transfer_point_data(s, a, s.F_total);
+  if (!s.F_total.empty()) transfer_point_data(s, a, s.F_total);
   interpolate_nodal_data(a, s.x);
   interpolate_nodal_data(a, s.v);
   interpolate_nodal_data(a, s.h_adapt);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace lgr {
+
+// Runs one file write at a time on a thread of its own, so that the time step loop can go on while a
+// captured state is formatted and written. A write handed over while the previous one is still running
+// waits for it, which holds the solver back when it outputs faster than the files are written.
+class background_writer
+{
+  std::thread                  m_thread;
+  std::mutex                   m_mutex;
+  std::condition_variable      m_changed;
+  std::function<std::size_t()> m_write;
+  std::size_t                  m_bytes{0};
+  bool                         m_pending{false};
+  bool                         m_stop{false};
+
+  void
+  work()
+  {
+    while (true) {
+      std::function<std::size_t()> write;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [&] { return m_stop || m_pending; });
+        if (!m_pending) return;
+        write = m_write;
+      }
+      auto const bytes = write();
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bytes   += bytes;
+        m_write   = nullptr;
+        m_pending = false;
+      }
+      m_changed.notify_all();
+    }
+  }
+
+ public:
+  background_writer() = default;
+  background_writer(background_writer const&) = delete;
+  background_writer&
+  operator=(background_writer const&) = delete;
+  ~background_writer()
+  {
+    if (!m_thread.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+  }
+  // waits for the write before it, then returns while \p write runs; \p write returns the bytes it wrote
+  void
+  submit(std::function<std::size_t()> write)
+  {
+    if (!m_thread.joinable()) m_thread = std::thread([this] { work(); });
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_changed.wait(lock, [&] { return !m_pending; });
+      m_write   = std::move(write);
+      m_pending = true;
+    }
+    m_changed.notify_all();
+  }
+  // waits for the writes submitted so far and returns the number of bytes they wrote
+  std::size_t
+  finish()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [&] { return !m_pending; });
+    return m_bytes;
+  }
+};
+
+}  // namespace lgr
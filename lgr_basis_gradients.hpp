@@ -0,0 +1,98 @@
+#pragma once
+
+#include <hpc_array.hpp>
+#include <hpc_macros.hpp>
+#include <lgr_element_specific_inline.hpp>
+#include <lgr_state.hpp>
+#include <utility>
+
+namespace lgr {
+
+// The basis gradients of the nodes of one point, either loaded from state::grad_N or computed up front
+// from the current positions of a linear tetrahedron.
+class point_basis_gradients
+{
+ public:
+  using grad_N_iterator       = decltype(std::declval<state const&>().grad_N.cbegin());
+  using point_nodes_range     = decltype((std::declval<state const&>().points *
+                                      std::declval<state const&>().nodes_in_element)[point_index()]);
+  using tetrahedron_gradients = hpc::array<hpc::basis_gradient<double>, 4>;
+
+ private:
+  grad_N_iterator       m_grad_N;
+  point_nodes_range     m_point_nodes;
+  tetrahedron_gradients m_tetrahedron;
+  bool                  m_recomputed;
+
+ public:
+  HPC_HOST_DEVICE
+  point_basis_gradients(grad_N_iterator const grad_N_in, point_nodes_range const point_nodes_in) noexcept
+      : m_grad_N(grad_N_in), m_point_nodes(point_nodes_in), m_recomputed(false)
+  {
+  }
+  HPC_HOST_DEVICE
+  point_basis_gradients(
+      grad_N_iterator const       grad_N_in,
+      point_nodes_range const     point_nodes_in,
+      tetrahedron_gradients const tetrahedron_in) noexcept
+      : m_grad_N(grad_N_in), m_point_nodes(point_nodes_in), m_tetrahedron(tetrahedron_in), m_recomputed(true)
+  {
+  }
+  HPC_HOST_DEVICE hpc::basis_gradient<double>
+                  operator[](node_in_element_index const i) const noexcept
+  {
+    if (m_recomputed) return m_tetrahedron[hpc::weaken(i)];
+    return m_grad_N[m_point_nodes[i]].load();
+  }
+};
+
+// What the kernels read the basis gradients through. Unless state::grad_N is allocated, which it is not for
+// linear tetrahedra with input::recompute_grad_N, the gradients are recomputed from the nodal positions
+// each time a point is visited.
+class basis_gradients
+{
+  using x_iterator                     = decltype(std::declval<state const&>().x.cbegin());
+  using element_nodes_iterator         = decltype(std::declval<state const&>().elements_to_nodes.cbegin());
+  using elements_to_element_nodes_type = decltype(std::declval<state const&>().elements *
+                                                  std::declval<state const&>().nodes_in_element);
+  using points_to_point_nodes_type     = decltype(std::declval<state const&>().points *
+                                              std::declval<state const&>().nodes_in_element);
+
+  point_basis_gradients::grad_N_iterator m_grad_N;
+  x_iterator                             m_nodes_to_x;
+  element_nodes_iterator                 m_element_nodes_to_nodes;
+  elements_to_element_nodes_type         m_elements_to_element_nodes;
+  points_to_point_nodes_type             m_points_to_point_nodes;
+  bool                                   m_recompute;
+
+ public:
+  explicit basis_gradients(state const& s)
+      : m_grad_N(s.grad_N.cbegin()),
+        m_nodes_to_x(s.x.cbegin()),
+        m_element_nodes_to_nodes(s.elements_to_nodes.cbegin()),
+        m_elements_to_element_nodes(s.elements * s.nodes_in_element),
+        m_points_to_point_nodes(s.points * s.nodes_in_element),
+        m_recompute(s.grad_N.empty())
+  {
+  }
+  HPC_HOST_DEVICE bool
+  recomputed() const noexcept
+  {
+    return m_recompute;
+  }
+  HPC_HOST_DEVICE point_basis_gradients
+                  operator()(element_index const element, point_index const point) const noexcept
+  {
+    auto const point_nodes = m_points_to_point_nodes[point];
+    if (!m_recompute) return point_basis_gradients(m_grad_N, point_nodes);
+    auto const                           element_nodes = m_elements_to_element_nodes[element];
+    hpc::array<hpc::position<double>, 4> x;
+    for (int i = 0; i < 4; ++i) {
+      auto const node = m_element_nodes_to_nodes[element_nodes[node_in_element_index(i)]];
+      x[i]            = m_nodes_to_x[node].load();
+    }
+    return point_basis_gradients(m_grad_N, point_nodes, tetrahedron_basis_gradients(x, tetrahedron_volume(x)));
+  }
+};
+
+}  // namespace lgr
@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <hpc_algorithm.hpp>
+#include <hpc_macros.hpp>
+#include <hpc_numeric.hpp>
+#include <iostream>
+#include <lgr_distributed.hpp>
+#include <lgr_meshing.hpp>
+#include <lgr_renumber.hpp>
+#include <lgr_state.hpp>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#ifdef LGR_ENABLE_MPI
+#include <mpi.h>
+#endif
+
+namespace lgr {
+
+distributed_scope::distributed_scope(int* argc, char*** argv)
+{
+#ifdef LGR_ENABLE_MPI
+  MPI_Init(argc, argv);
+#else
+  static_cast<void>(argc);
+  static_cast<void>(argv);
+#endif
+}
+
+distributed_scope::~distributed_scope()
+{
+#ifdef LGR_ENABLE_MPI
+  MPI_Finalize();
+#endif
+}
+
+int
+distributed_rank()
+{
+  int rank = 0;
+#ifdef LGR_ENABLE_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+  return rank;
+}
+
+int
+distributed_size()
+{
+  int size = 1;
+#ifdef LGR_ENABLE_MPI
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+  return size;
+}
+
+hpc::time<double>
+global_minimum(hpc::time<double> const local)
+{
+  double global = double(local);
+#ifdef LGR_ENABLE_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &global, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  return global;
+}
+
+std::string
+rank_file_prefix(std::string const& prefix)
+{
+  if (distributed_size() == 1) return prefix;
+  std::stringstream stream;
+  stream << prefix << "_rank" << distributed_rank();
+  return stream.str();
+}
+
+HPC_NOINLINE inline hpc::device_vector<int, element_index>
+partition_elements(state const& s, int const ranks)
+{
+  auto const                             order = hilbert_element_order(s);
+  hpc::device_vector<int, element_index> element_parts(s.elements.size());
+  auto const                             sorted_to_elements = order.cbegin();
+  auto const                             elements_to_parts  = element_parts.begin();
+  auto const                             num_elements       = std::int64_t(hpc::weaken(s.elements.size()));
+  auto                                   functor            = [=] HPC_DEVICE(element_index const sorted) {
+    auto const part                               = (std::int64_t(hpc::weaken(sorted)) * ranks) / num_elements;
+    elements_to_parts[sorted_to_elements[sorted]] = int(part);
+  };
+  hpc::for_each(hpc::device_policy(), s.elements, functor);
+  return element_parts;
+}
+
+HPC_NOINLINE inline hpc::device_vector<int, node_index>
+assign_node_owners(state const& s, hpc::device_vector<int, element_index> const& element_parts, int const ranks)
+{
+  hpc::device_vector<int, node_index> node_owners(s.nodes.size());
+  auto const                          nodes_to_node_elements    = s.nodes_to_node_elements.cbegin();
+  auto const                          node_elements_to_elements = s.node_elements_to_elements.cbegin();
+  auto const                          elements_to_parts         = element_parts.cbegin();
+  auto const                          nodes_to_owners           = node_owners.begin();
+  auto                                functor                   = [=] HPC_DEVICE(node_index const node) {
+    int owner = ranks;
+    for (auto const node_element : nodes_to_node_elements[node]) {
+      auto const part = elements_to_parts[node_elements_to_elements[node_element]];
+      owner           = (part < owner) ? part : owner;
+    }
+    nodes_to_owners[node] = owner;
+  };
+  hpc::for_each(hpc::device_policy(), s.nodes, functor);
+  return node_owners;
+}
+
+// keeps the values of \p data at the entities listed in \p kept_to_old, in that order
+template <class Index, class Range>
+HPC_NOINLINE void
+keep_data(hpc::device_vector<Index, Index> const& kept_to_old, Range& data)
+{
+  using value_type = typename Range::value_type;
+  Range      kept_data(kept_to_old.size());
+  auto const kept_to_old_begin = kept_to_old.cbegin();
+  auto const old_data_begin    = data.cbegin();
+  auto const kept_data_begin   = kept_data.begin();
+  auto       functor           = [=] HPC_DEVICE(Index const kept) {
+    kept_data_begin[kept] = value_type(old_data_begin[kept_to_old_begin[kept]]);
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<Index>(kept_to_old.size()), functor);
+  data = std::move(kept_data);
+}
+
+void
+decompose_mesh(state& s, int const rank, int const ranks)
+{
+  if (ranks == 1) return;
+  auto const element_parts             = partition_elements(s, ranks);
+  auto       node_owners               = assign_node_owners(s, element_parts, ranks);
+  auto const elements_to_parts         = element_parts.cbegin();
+  auto const nodes_to_owners           = node_owners.cbegin();
+  auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
+  auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
+  auto const nodes_to_node_elements    = s.nodes_to_node_elements.cbegin();
+  auto const node_elements_to_elements = s.node_elements_to_elements.cbegin();
+  auto       is_kept_element           = [=] HPC_DEVICE(element_index const element) -> int {
+    if (elements_to_parts[element] == rank) return 1;
+    for (auto const element_node : elements_to_element_nodes[element]) {
+      if (nodes_to_owners[element_nodes_to_nodes[element_node]] == rank) return 1;
+    }
+    return 0;
+  };
+  auto is_kept_node = [=] HPC_DEVICE(node_index const node) -> int {
+    for (auto const node_element : nodes_to_node_elements[node]) {
+      if (is_kept_element(node_elements_to_elements[node_element])) return 1;
+    }
+    return 0;
+  };
+  hpc::device_vector<element_index, element_index> kept_to_old_elements;
+  hpc::copy_if(hpc::device_policy(), s.elements, kept_to_old_elements, is_kept_element);
+  hpc::device_vector<node_index, node_index> kept_to_old_nodes;
+  hpc::copy_if(hpc::device_policy(), s.nodes, kept_to_old_nodes, is_kept_node);
+  hpc::counting_range<element_index> const   kept_elements(kept_to_old_elements.size());
+  hpc::counting_range<node_index> const      kept_nodes(kept_to_old_nodes.size());
+  hpc::device_vector<node_index, node_index> old_to_kept_nodes(s.nodes.size());
+  auto const                                 kept_to_old_nodes_begin = kept_to_old_nodes.cbegin();
+  auto const                                 old_nodes_to_kept_nodes = old_to_kept_nodes.begin();
+  auto                                       node_functor            = [=] HPC_DEVICE(node_index const kept_node) {
+    old_nodes_to_kept_nodes[kept_to_old_nodes_begin[kept_node]] = kept_node;
+  };
+  hpc::for_each(hpc::device_policy(), kept_nodes, node_functor);
+  hpc::device_vector<node_index, element_node_index> kept_element_nodes_to_nodes(
+      kept_elements.size() * s.nodes_in_element.size());
+  auto const kept_to_old_elements_begin        = kept_to_old_elements.cbegin();
+  auto const old_to_kept_nodes_begin           = old_to_kept_nodes.cbegin();
+  auto const kept_elements_to_element_nodes    = kept_elements * s.nodes_in_element;
+  auto const kept_element_nodes_to_nodes_begin = kept_element_nodes_to_nodes.begin();
+  auto const nodes_in_element                  = s.nodes_in_element;
+  auto       element_functor                   = [=] HPC_DEVICE(element_index const kept_element) {
+    auto const old_element_nodes  = elements_to_element_nodes[kept_to_old_elements_begin[kept_element]];
+    auto const kept_element_nodes = kept_elements_to_element_nodes[kept_element];
+    for (auto const node_in_element : nodes_in_element) {
+      node_index const old_node = element_nodes_to_nodes[old_element_nodes[node_in_element]];
+      kept_element_nodes_to_nodes_begin[kept_element_nodes[node_in_element]] = old_to_kept_nodes_begin[old_node];
+    }
+  };
+  hpc::for_each(hpc::device_policy(), kept_elements, element_functor);
+  keep_data(kept_to_old_nodes, node_owners);
+  keep_data(kept_to_old_nodes, s.x);
+  if (s.material.size() == s.elements.size()) keep_data(kept_to_old_elements, s.material);
+  s.elements_to_nodes = std::move(kept_element_nodes_to_nodes);
+  s.global_nodes      = std::move(kept_to_old_nodes);
+  s.node_owners       = std::move(node_owners);
+  s.elements.resize(kept_elements.size());
+  s.nodes.resize(kept_nodes.size());
+  s.points.resize(s.elements.size() * s.points_in_element.size());
+  propagate_connectivity(s);
+}
+
+// Sorts out the elements around the sent nodes, whose forces are needed first, from the others, and the nodes
+// that are neither sent nor received.
+HPC_NOINLINE inline void
+split_halo_interior(state& s)
+{
+  auto&                               halo = s.halo;
+  hpc::device_vector<int, node_index> node_roles(s.nodes.size());
+  hpc::fill(hpc::device_policy(), node_roles, 0);
+  auto const nodes_to_roles         = node_roles.begin();
+  auto const send_nodes_to_nodes    = halo.send_nodes.cbegin();
+  auto const receive_nodes_to_nodes = halo.receive_nodes.cbegin();
+  auto       send_functor           = [=] HPC_DEVICE(int const send_node) {
+    nodes_to_roles[send_nodes_to_nodes[send_node]] = 1;
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(halo.send_nodes.size()), send_functor);
+  auto receive_functor = [=] HPC_DEVICE(int const receive_node) {
+    nodes_to_roles[receive_nodes_to_nodes[receive_node]] = 2;
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(halo.receive_nodes.size()), receive_functor);
+  auto const roles                     = node_roles.cbegin();
+  auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
+  auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
+  auto       is_boundary_element       = [=] HPC_DEVICE(element_index const element) -> int {
+    for (auto const element_node : elements_to_element_nodes[element]) {
+      if (roles[element_nodes_to_nodes[element_node]] == 1) return 1;
+    }
+    return 0;
+  };
+  auto is_interior_element = [=] HPC_DEVICE(element_index const element) -> int {
+    return 1 - is_boundary_element(element);
+  };
+  auto is_boundary_node = [=] HPC_DEVICE(node_index const node) -> int { return (roles[node] == 1) ? 1 : 0; };
+  auto is_interior_node = [=] HPC_DEVICE(node_index const node) -> int { return (roles[node] == 0) ? 1 : 0; };
+  hpc::copy_if(hpc::device_policy(), s.elements, halo.boundary_elements, is_boundary_element);
+  hpc::copy_if(hpc::device_policy(), s.elements, halo.interior_elements, is_interior_element);
+  hpc::copy_if(hpc::device_policy(), s.nodes, halo.boundary_nodes, is_boundary_node);
+  hpc::copy_if(hpc::device_policy(), s.nodes, halo.interior_nodes, is_interior_node);
+}
+
+void
+build_halo(state& s)
+{
+  s.halo = node_halo();
+  if (s.global_nodes.size() != s.nodes.size()) return;
+#ifdef LGR_ENABLE_MPI
+  auto const                                 rank  = distributed_rank();
+  auto const                                 ranks = distributed_size();
+  hpc::pinned_vector<node_index, node_index> pinned_global_nodes(s.nodes.size());
+  hpc::copy(s.global_nodes, pinned_global_nodes);
+  hpc::pinned_vector<int, node_index> pinned_owners(s.nodes.size());
+  hpc::copy(s.node_owners, pinned_owners);
+  auto const nodes_to_global_nodes = pinned_global_nodes.cbegin();
+  auto const nodes_to_owners       = pinned_owners.cbegin();
+  auto const by_owner_then_global  = [=](node_index const a, node_index const b) {
+    if (nodes_to_owners[a] != nodes_to_owners[b]) return nodes_to_owners[a] < nodes_to_owners[b];
+    return nodes_to_global_nodes[a] < nodes_to_global_nodes[b];
+  };
+  std::vector<node_index> copies;
+  std::vector<node_index> owned;
+  for (auto const node : s.nodes) {
+    if (nodes_to_owners[node] == rank) {
+      owned.push_back(node);
+    } else {
+      copies.push_back(node);
+    }
+  }
+  std::sort(copies.begin(), copies.end(), by_owner_then_global);
+  std::sort(owned.begin(), owned.end(), by_owner_then_global);
+  // each rank asks the owners for the global nodes it copies, which tells the owners what to send
+  std::vector<int> receive_counts(static_cast<std::size_t>(ranks), 0);
+  for (auto const node : copies) ++receive_counts[std::size_t(nodes_to_owners[node])];
+  std::vector<int> send_counts(static_cast<std::size_t>(ranks));
+  MPI_Alltoall(receive_counts.data(), 1, MPI_INT, send_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+  std::vector<int> receive_displacements(std::size_t(ranks + 1), 0);
+  std::vector<int> send_displacements(std::size_t(ranks + 1), 0);
+  std::partial_sum(receive_counts.begin(), receive_counts.end(), receive_displacements.begin() + 1);
+  std::partial_sum(send_counts.begin(), send_counts.end(), send_displacements.begin() + 1);
+  std::vector<int> requested(copies.size());
+  for (std::size_t i = 0; i < copies.size(); ++i) requested[i] = hpc::weaken(nodes_to_global_nodes[copies[i]]);
+  std::vector<int> requests(std::size_t(send_displacements.back()));
+  MPI_Alltoallv(
+      requested.data(),
+      receive_counts.data(),
+      receive_displacements.data(),
+      MPI_INT,
+      requests.data(),
+      send_counts.data(),
+      send_displacements.data(),
+      MPI_INT,
+      MPI_COMM_WORLD);
+  hpc::pinned_vector<node_index, int> send_nodes(int(requests.size()));
+  for (std::size_t i = 0; i < requests.size(); ++i) {
+    auto const is_before = [=](node_index const node, int const global) {
+      return hpc::weaken(nodes_to_global_nodes[node]) < global;
+    };
+    auto const it = std::lower_bound(owned.begin(), owned.end(), requests[i], is_before);
+    if (it == owned.end() || hpc::weaken(nodes_to_global_nodes[*it]) != requests[i]) {
+      HPC_ERROR_EXIT("a rank asked for a node this rank does not own");
+    }
+    send_nodes[int(i)] = *it;
+  }
+  hpc::pinned_vector<node_index, int> receive_nodes(int(copies.size()));
+  for (std::size_t i = 0; i < copies.size(); ++i) receive_nodes[int(i)] = copies[i];
+  auto& halo = s.halo;
+  halo.send_offsets.push_back(0);
+  halo.receive_offsets.push_back(0);
+  for (int other = 0; other < ranks; ++other) {
+    auto const r = std::size_t(other);
+    if (send_counts[r] == 0 && receive_counts[r] == 0) continue;
+    halo.ranks.push_back(other);
+    halo.send_offsets.push_back(send_displacements[r + 1]);
+    halo.receive_offsets.push_back(receive_displacements[r + 1]);
+  }
+  halo.send_nodes.resize(send_nodes.size());
+  hpc::copy(send_nodes, halo.send_nodes);
+  halo.receive_nodes.resize(receive_nodes.size());
+  hpc::copy(receive_nodes, halo.receive_nodes);
+  split_halo_interior(s);
+#endif
+}
+
+#ifdef LGR_ENABLE_MPI
+
+class halo_messages
+{
+ public:
+  std::vector<MPI_Request>              requests;
+  std::shared_ptr<void>                 send_buffer;
+  std::shared_ptr<void>                 receive_buffer;
+  std::chrono::steady_clock::time_point posted;
+};
+
+#else
+
+class halo_messages
+{
+};
+
+#endif
+
+// Posts the owners' values of \p data at the sent nodes and the receives of the copies. Data that is not sized for
+// the mesh belongs to a material without that field and is left alone.
+template <class Range>
+HPC_NOINLINE void
+start_halo_exchange(state& s, Range& data)
+{
+  auto& halo = s.halo;
+  if (halo.ranks.empty() || data.size() != s.nodes.size()) return;
+  assert(!halo.messages);
+  halo.messages = std::make_shared<halo_messages>();
+#ifdef LGR_ENABLE_MPI
+  using value_type = typename Range::value_type;
+  hpc::device_vector<value_type, int> send_buffer(halo.send_nodes.size());
+  auto const                          send_nodes_to_nodes = halo.send_nodes.cbegin();
+  auto const                          nodes_to_data       = data.cbegin();
+  auto const                          send_buffer_begin   = send_buffer.begin();
+  auto                                pack_functor        = [=] HPC_DEVICE(int const send_node) {
+    send_buffer_begin[send_node] = value_type(nodes_to_data[send_nodes_to_nodes[send_node]]);
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(halo.send_nodes.size()), pack_functor);
+  auto const pinned_send_buffer    = std::make_shared<hpc::pinned_vector<value_type, int>>(send_buffer.size());
+  auto const pinned_receive_buffer = std::make_shared<hpc::pinned_vector<value_type, int>>(halo.receive_nodes.size());
+  hpc::copy(send_buffer, *pinned_send_buffer);
+  auto& messages = *halo.messages;
+  for (std::size_t i = 0; i < halo.ranks.size(); ++i) {
+    auto const count = int(sizeof(value_type)) * (halo.receive_offsets[i + 1] - halo.receive_offsets[i]);
+    if (count == 0) continue;
+    messages.requests.emplace_back();
+    MPI_Irecv(
+        pinned_receive_buffer->data() + halo.receive_offsets[i],
+        count,
+        MPI_BYTE,
+        halo.ranks[i],
+        0,
+        MPI_COMM_WORLD,
+        &messages.requests.back());
+  }
+  for (std::size_t i = 0; i < halo.ranks.size(); ++i) {
+    auto const count = int(sizeof(value_type)) * (halo.send_offsets[i + 1] - halo.send_offsets[i]);
+    if (count == 0) continue;
+    messages.requests.emplace_back();
+    MPI_Isend(
+        pinned_send_buffer->data() + halo.send_offsets[i],
+        count,
+        MPI_BYTE,
+        halo.ranks[i],
+        0,
+        MPI_COMM_WORLD,
+        &messages.requests.back());
+  }
+  messages.send_buffer    = pinned_send_buffer;
+  messages.receive_buffer = pinned_receive_buffer;
+  messages.posted         = std::chrono::steady_clock::now();
+#endif
+}
+
+// Waits for the messages posted by start_halo_exchange and overwrites the copies of other ranks' nodes in \p data
+// with the owners' values.
+template <class Range>
+HPC_NOINLINE void
+finish_halo_exchange(state& s, Range& data)
+{
+  auto& halo = s.halo;
+  if (halo.ranks.empty() || data.size() != s.nodes.size()) return;
+  assert(halo.messages);
+#ifdef LGR_ENABLE_MPI
+  using value_type     = typename Range::value_type;
+  auto&      messages  = *halo.messages;
+  auto const waiting   = std::chrono::steady_clock::now();
+  MPI_Waitall(int(messages.requests.size()), messages.requests.data(), MPI_STATUSES_IGNORE);
+  auto const received  = std::chrono::steady_clock::now();
+  halo.overlapped_time = halo.overlapped_time + std::chrono::duration<double>(waiting - messages.posted).count();
+  halo.waiting_time    = halo.waiting_time + std::chrono::duration<double>(received - waiting).count();
+  auto const& pinned_receive_buffer =
+      *std::static_pointer_cast<hpc::pinned_vector<value_type, int>>(messages.receive_buffer);
+  hpc::device_vector<value_type, int> receive_buffer(pinned_receive_buffer.size());
+  hpc::copy(pinned_receive_buffer, receive_buffer);
+  auto const receive_nodes_to_nodes = halo.receive_nodes.cbegin();
+  auto const receive_buffer_begin   = receive_buffer.cbegin();
+  auto const nodes_to_data          = data.begin();
+  auto       unpack_functor         = [=] HPC_DEVICE(int const receive_node) {
+    nodes_to_data[receive_nodes_to_nodes[receive_node]] = receive_buffer_begin[receive_node];
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(halo.receive_nodes.size()), unpack_functor);
+#endif
+  halo.messages.reset();
+}
+
+template <class Range>
+void
+exchange_halo(state& s, Range& data)
+{
+  start_halo_exchange(s, data);
+  finish_halo_exchange(s, data);
+}
+
+template <class Range, class MaterialIndex>
+void
+exchange_halo(state& s, hpc::host_vector<Range, MaterialIndex>& material_data)
+{
+  for (auto& data : material_data) exchange_halo(s, data);
+}
+
+void
+exchange_nodal_force(state& s)
+{
+  exchange_halo(s, s.f);
+}
+
+void
+start_nodal_force_exchange(state& s)
+{
+  start_halo_exchange(s, s.f);
+}
+
+void
+finish_nodal_force_exchange(state& s)
+{
+  finish_halo_exchange(s, s.f);
+}
+
+void
+exchange_nodal_mass(state& s)
+{
+  exchange_halo(s, s.mass);
+  exchange_halo(s, s.material_mass);
+}
+
+void
+exchange_p_h_dot(state& s)
+{
+  exchange_halo(s, s.p_h_dot);
+}
+
+void
+exchange_p_h_dot(state& s, material_index const material)
+{
+  exchange_halo(s, s.p_h_dot[material]);
+}
+
+void
+exchange_e_h_dot(state& s)
+{
+  exchange_halo(s, s.e_h_dot);
+}
+
+void
+exchange_e_h_dot(state& s, material_index const material)
+{
+  exchange_halo(s, s.e_h_dot[material]);
+}
+
+void
+exchange_nodal_density(state& s)
+{
+  exchange_halo(s, s.rho_h);
+}
+
+void
+exchange_nodal_density(state& s, material_index const material)
+{
+  exchange_halo(s, s.rho_h[material]);
+}
+
+void
+report_halo_overlap(state& s)
+{
+  double times[2] = {s.halo.overlapped_time, s.halo.waiting_time};
+#ifdef LGR_ENABLE_MPI
+  MPI_Allreduce(MPI_IN_PLACE, times, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  if (distributed_rank() == 0) {
+    std::cout << "halo exchange overlapped " << times[0] << " s of computation, waited " << times[1] << " s\n";
+  }
+  s.halo.overlapped_time = 0.0;
+  s.halo.waiting_time    = 0.0;
+}
+
+}  // namespace lgr
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <hpc_dimensional.hpp>
+#include <lgr_mesh_indices.hpp>
+#include <string>
+
+namespace lgr {
+
+class state;
+
+// MPI is initialized for the lifetime of this object when lgr is built with it; otherwise there is one rank
+class distributed_scope
+{
+ public:
+  distributed_scope(int* argc, char*** argv);
+  ~distributed_scope();
+  distributed_scope(distributed_scope const&) = delete;
+  distributed_scope&
+  operator=(distributed_scope const&) = delete;
+};
+
+int
+distributed_rank();
+int
+distributed_size();
+
+hpc::time<double>
+global_minimum(hpc::time<double> const local);
+
+// \p prefix, made distinct for each rank when there are several
+std::string
+rank_file_prefix(std::string const& prefix);
+
+// Keeps the part of the mesh that \p rank of \p ranks works on. The elements are split into contiguous
+// stretches of a Hilbert curve through their centroids, and each node is owned by the lowest rank among the
+// stretches around it. A rank keeps its own elements, every element around a node it owns and the nodes of
+// these, so that gathers over the elements of an owned node see all of them; the other nodes it keeps are
+// copies of nodes owned elsewhere.
+void
+decompose_mesh(state& s, int const rank, int const ranks);
+
+// Pairs the copies of other ranks' nodes with their owners; called once the node numbering is final.
+void
+build_halo(state& s);
+
+// Refresh the copies of other ranks' nodes with the values their owners gathered.
+void
+exchange_nodal_force(state& s);
+void
+exchange_nodal_mass(state& s);
+// The nodal force exchange in two halves, so that computation can go on while the messages are in flight.
+void
+start_nodal_force_exchange(state& s);
+void
+finish_nodal_force_exchange(state& s);
+void
+exchange_p_h_dot(state& s);
+void
+exchange_p_h_dot(state& s, material_index const material);
+void
+exchange_e_h_dot(state& s);
+void
+exchange_e_h_dot(state& s, material_index const material);
+void
+exchange_nodal_density(state& s);
+void
+exchange_nodal_density(state& s, material_index const material);
+
+// Prints, on the first rank, the most time any rank computed while its halo messages were in flight and spent
+// waiting for them since the last report.
+void
+report_halo_overlap(state& s);
+
+}  // namespace lgr
@@ -62,18 +62,7 @@ collect_set(
     IsInFunctor                      is_in_functor,
     hpc::device_vector<Index, int>&  set_items)
 {
-  hpc::device_vector<int, Index> offsets(range.size());
-  hpc::transform_inclusive_scan(hpc::device_policy(), range, offsets, hpc::plus<int>(), is_in_functor);
-  int const set_size = hpc::transform_reduce(hpc::device_policy(), range, int(0), hpc::plus<int>(), is_in_functor);
-  set_items.resize(set_size);
-  auto const set_items_to_items = set_items.begin();
-  auto const items_to_offsets   = offsets.cbegin();
-  auto       functor            = [=] HPC_DEVICE(Index const item) {
-    if (is_in_functor(item) != 0) {
-      set_items_to_items[items_to_offsets[item] - 1] = item;
-    }
-  };
-  hpc::for_each(hpc::device_policy(), range, functor);
+  hpc::copy_if(hpc::device_policy(), range, set_items, is_in_functor);
 }
 
 void
@@ -160,6 +149,57 @@ collect_element_sets(input const& in, state& s)
   }
 }
 
+void
+collect_material_node_elements(input const& in, state& s)
+{
+  s.material_nodes_to_node_elements.resize(in.materials.size());
+  s.material_node_elements_to_elements.resize(in.materials.size());
+  s.material_node_elements_to_nodes_in_element.resize(in.materials.size());
+  auto const nodes_to_node_elements            = s.nodes_to_node_elements.cbegin();
+  auto const node_elements_to_elements         = s.node_elements_to_elements.cbegin();
+  auto const node_elements_to_nodes_in_element = s.node_elements_to_nodes_in_element.cbegin();
+  auto const elements_to_material              = s.material.cbegin();
+  for (auto const material : in.materials) {
+    if (!(in.enable_nodal_pressure[material] || in.enable_nodal_energy[material])) continue;
+    auto const&                                 set_nodes          = s.node_sets[material];
+    auto const                                  set_nodes_to_nodes = set_nodes.cbegin();
+    hpc::counting_range<int> const              set_node_range(set_nodes.size());
+    hpc::device_vector<node_element_index, int> counts_vector(set_nodes.size());
+    auto const                                  set_nodes_to_count = counts_vector.begin();
+    auto                                        count_functor      = [=] HPC_DEVICE(int const set_node) {
+      node_index const   node = set_nodes_to_nodes[set_node];
+      node_element_index count(0);
+      for (auto const node_element : nodes_to_node_elements[node]) {
+        element_index const element = node_elements_to_elements[node_element];
+        if (elements_to_material[element] == material) ++count;
+      }
+      set_nodes_to_count[set_node] = count;
+    };
+    hpc::for_each(hpc::device_policy(), set_node_range, count_functor);
+    auto const count = hpc::reduce(hpc::device_policy(), counts_vector, node_element_index(0));
+    s.material_nodes_to_node_elements[material].assign_sizes(counts_vector);
+    s.material_node_elements_to_elements[material].resize(count);
+    s.material_node_elements_to_nodes_in_element[material].resize(count);
+    auto const set_nodes_to_material_node_elements = s.material_nodes_to_node_elements[material].cbegin();
+    auto const material_node_elements_to_elements  = s.material_node_elements_to_elements[material].begin();
+    auto const material_node_elements_to_nodes_in_element =
+        s.material_node_elements_to_nodes_in_element[material].begin();
+    auto fill_functor = [=] HPC_DEVICE(int const set_node) {
+      node_index const node                  = set_nodes_to_nodes[set_node];
+      auto             material_node_element = *(set_nodes_to_material_node_elements[set_node].begin());
+      for (auto const node_element : nodes_to_node_elements[node]) {
+        element_index const element = node_elements_to_elements[node_element];
+        if (elements_to_material[element] != material) continue;
+        material_node_elements_to_elements[material_node_element] = element;
+        material_node_elements_to_nodes_in_element[material_node_element] =
+            node_elements_to_nodes_in_element[node_element];
+        ++material_node_element;
+      }
+    };
+    hpc::for_each(hpc::device_policy(), set_node_range, fill_functor);
+  }
+}
+
 std::unique_ptr<domain>
 epsilon_around_plane_domain(plane const& p, double eps)
 {
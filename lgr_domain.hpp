@@ -245,5 +245,7 @@ void
 collect_element_sets(input const& in, state& s);
 void
 collect_node_sets(input const& in, state& s);
+void
+collect_material_node_elements(input const& in, state& s);
 
 }  // namespace lgr
@@ -1,5 +1,7 @@
 #include <lgr_bar.hpp>
+#include <lgr_basis_gradients.hpp>
 #include <lgr_composite_tetrahedron.hpp>
+#include <lgr_distributed.hpp>
 #include <lgr_element_specific.hpp>
 #include <lgr_input.hpp>
 #include <lgr_state.hpp>
@@ -33,17 +35,17 @@ initialize_grad_N(input const& in, state& s)
 HPC_NOINLINE inline void
 update_h_min_height(input const&, state& s)
 {
-  auto const point_nodes_to_grad_N = s.grad_N.cbegin();
+  auto const points_to_grad_N      = basis_gradients(s);
   auto const elements_to_h_min     = s.h_min.begin();
-  auto const points_to_point_nodes = s.points * s.nodes_in_element;
+  auto const nodes_in_element      = s.nodes_in_element;
   auto const elements_to_points    = s.elements * s.points_in_element;
   auto       functor               = [=] HPC_DEVICE(element_index const element) {
     constexpr point_in_element_index fp(0);
-    auto const                       point       = elements_to_points[element][fp];
-    hpc::length<double>              min_height  = hpc::numeric_limits<double>::max();
-    auto const                       point_nodes = points_to_point_nodes[point];
-    for (auto const point_node : point_nodes) {
-      auto const grad_N = point_nodes_to_grad_N[point_node].load();
+    auto const                       point        = elements_to_points[element][fp];
+    hpc::length<double>              min_height   = hpc::numeric_limits<double>::max();
+    auto const                       point_grad_N = points_to_grad_N(element, point);
+    for (auto const node_in_element : nodes_in_element) {
+      auto const grad_N = point_grad_N[node_in_element];
       auto const height = 1.0 / norm(grad_N);
       min_height        = hpc::min(min_height, height);
     }
@@ -150,6 +152,7 @@ update_nodal_mass(input const& in, state& s)
     };
     hpc::for_each(hpc::device_policy(), s.node_sets[material], functor);
   }
+  exchange_nodal_mass(s);
 }
 
 }  // namespace lgr
@@ -5,6 +5,7 @@
 #include <hpc_range_sum.hpp>
 #include <hpc_vector.hpp>
 #include <hpc_vector3.hpp>
+#include <j2/tabulated_hardening.hpp>
 #include <lgr_domain.hpp>
 #include <map>
 #include <string>
@@ -31,6 +32,32 @@ enum h_min_kind
   INBALL_DIAMETER,
 };
 
+enum force_assembly_kind
+{
+  // each node gathers the per-element-node forces of its adjacent elements
+  GATHER_FORCE_ASSEMBLY,
+  // elements of one color share no nodes and scatter their forces directly into the nodes
+  COLORED_SCATTER_FORCE_ASSEMBLY,
+};
+
+enum mesh_ordering_kind
+{
+  // nodes and elements keep the numbering of the mesh generator, the mesh file or the adaptation
+  INPUT_MESH_ORDERING,
+  // nodes and elements are numbered along a Hilbert curve after the mesh is loaded and after each adaptation
+  HILBERT_MESH_ORDERING,
+};
+
+enum output_format_kind
+{
+  // legacy VTK files in ASCII, one value per line
+  ASCII_VTK_OUTPUT_FORMAT,
+  // XML VTU files whose arrays are appended in binary
+  RAW_VTU_OUTPUT_FORMAT,
+  // XML VTU files whose appended arrays are compressed with zlib, for a build with LGR_ENABLE_ZLIB
+  ZLIB_VTU_OUTPUT_FORMAT,
+};
+
 class zero_boundary_condition
 {
  public:
@@ -53,6 +80,9 @@ class input
   element_kind                                                   element{TETRAHEDRON};
   time_integrator_kind                                           time_integrator = MIDPOINT_PREDICTOR_CORRECTOR;
   h_min_kind                                                     h_min           = INBALL_DIAMETER;
+  force_assembly_kind                                            force_assembly  = GATHER_FORCE_ASSEMBLY;
+  mesh_ordering_kind                                             mesh_ordering   = INPUT_MESH_ORDERING;
+  output_format_kind                                             output_format   = ASCII_VTK_OUTPUT_FORMAT;
   hpc::counting_range<material_index>                            materials;
   hpc::counting_range<material_index>                            boundaries;
   hpc::time<double>                                              end_time{0.0};
@@ -74,6 +104,7 @@ class input
   bool                                                           do_output{true};
   bool                                                           output_to_command_line{true};
   bool                                                           debug_output{false};
+  std::string                                                    kernel_timings_file;
   hpc::host_vector<hpc::density<double>, material_index>         rho0;
   hpc::host_vector<hpc::specific_energy<double>, material_index> e0;
   hpc::host_vector<bool, material_index>                         enable_neo_Hookean;
@@ -107,6 +138,9 @@ class input
   hpc::host_vector<hpc::adimensional<double>, material_index> m;
   hpc::host_vector<hpc::strain_rate<double>, material_index>  eps_dot0;
 
+  // tabulated flow strength, used instead of the power law when not empty
+  hpc::host_vector<j2::HardeningCurve, material_index> hardening_curve;
+
   // Damage
   hpc::host_vector<bool, material_index>   allow_no_tension;
   hpc::host_vector<bool, material_index>   allow_no_shear;
@@ -131,6 +165,16 @@ class input
   bool                enable_p_averaging             = false;
   bool                enable_adapt                   = false;
   bool                enable_comptet_stabilization   = false;
+  bool                enable_fused_point_kernels     = false;
+  bool                enable_batched_J2              = false;
+  bool                enable_fused_nodal_kernels     = false;
+  // leave state::grad_N unallocated and have the kernels recompute the basis gradients of linear tetrahedra
+  bool                recompute_grad_N               = false;
+  // leave unallocated the fields that no enabled physics reads, such as the plastic state without J2 plasticity
+  bool                skip_unused_fields             = false;
+  bool                print_state_memory             = false;
+  // print the high-water mark and reuse rate of the memory pools after the final time
+  bool                print_memory_pools             = false;
   hpc::length<double> max_node_neighbor_distance{1.0};
   hpc::length<double> max_point_neighbor_distance{1.0};
   std::function<void(
@@ -182,6 +226,7 @@ class input
         Svis0(material_count_in),
         m(material_count_in),
         eps_dot0(material_count_in),
+        hardening_curve(material_count_in),
         allow_no_tension(material_count_in, true),
         allow_no_shear(material_count_in, false),
         set_stress_to_zero(material_count_in, false),
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <hpc_range.hpp>
+
+#ifndef LGR_TENSOR_LAYOUT
+#define LGR_TENSOR_LAYOUT right
+#endif
+
+#ifndef LGR_POINT_STORAGE
+#define LGR_POINT_STORAGE double
+#endif
+
+namespace lgr {
+
+// Storage layout of the per-point tensor fields grad_N, F_total, Fp_total and sigma.
+// Configuring with LGR_TENSOR_LAYOUT=blocked4 or blocked8 interleaves the components of 4 or 8
+// consecutive points, which lets the compiler vectorize point loops across a block.
+constexpr hpc::layout tensor_layout = hpc::layout::LGR_TENSOR_LAYOUT;
+
+// Scalar in which grad_N, K, G, c, nu_art and element_dt keep their values. The kernels still load and compute in
+// double; configuring with LGR_POINT_STORAGE=float halves those fields at the cost of rounding the gradients to
+// float each time update_reference pushes them forward. V and N stay double: the nodal density divides the mass by
+// a sum of V, so a float V shows up as a pressure error of K times the float epsilon, and the OTM shape functions
+// must keep their partition of unity to conserve mass and momentum.
+using point_storage = LGR_POINT_STORAGE;
+
+}  // namespace lgr
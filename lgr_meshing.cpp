@@ -1,8 +1,10 @@
 #include <cassert>
 #include <hpc_atomic.hpp>
+#include <hpc_numeric.hpp>
 #include <lgr_input.hpp>
 #include <lgr_meshing.hpp>
 #include <lgr_state.hpp>
+#include <vector>
 
 namespace lgr {
 
@@ -27,51 +29,28 @@ propagate_connectivity(state& s)
   };
   hpc::for_each(hpc::device_policy(), s.elements, count_functor);
   s.nodes_to_node_elements.assign_sizes(counts_vector);
-  hpc::fill(hpc::device_policy(), counts_vector, int(0));
-  auto const nodes_to_node_elements    = s.nodes_to_node_elements.cbegin();
-  auto const node_elements_to_elements = s.node_elements_to_elements.begin();
-#ifndef NDEBUG
-  auto const num_node_elements = s.node_elements_to_elements.size();
-#endif
+  // the element nodes, stably sorted by node, list the elements of each node in element order, so every node's
+  // list comes out sorted without sorting it; element node e * nodes_in_element + i is node i of element e
+  static_assert(hpc::device_layout == hpc::layout::right, "element nodes are numbered element by element");
+  hpc::device_vector<node_index, element_node_index> sorted_nodes(s.elements_to_nodes.size());
+  hpc::copy(s.elements_to_nodes, sorted_nodes);
+  hpc::device_vector<element_node_index, element_node_index> sorted_to_element_nodes(s.elements_to_nodes.size());
+  hpc::copy(
+      hpc::device_policy(),
+      hpc::counting_range<element_node_index>(s.elements_to_nodes.size()),
+      sorted_to_element_nodes);
+  hpc::sort_by_key(hpc::device_policy(), sorted_nodes, sorted_to_element_nodes);
+  auto const sorted_to_element_nodes_begin     = sorted_to_element_nodes.cbegin();
+  auto const node_elements_to_elements         = s.node_elements_to_elements.begin();
   auto const node_elements_to_nodes_in_element = s.node_elements_to_nodes_in_element.begin();
-  auto const nodes_in_element                  = s.nodes_in_element;
-  auto       fill_functor                      = [=] HPC_DEVICE(element_index const element) {
-    auto const element_nodes = elements_to_element_nodes[element];
-    for (auto const node_in_element : nodes_in_element) {
-      element_node_index const element_node = element_nodes[node_in_element];
-      node_index const         node         = element_nodes_to_nodes[element_node];
-      hpc::atomic_ref<int>     count(nodes_to_count[node]);
-      int const                offset              = count++;
-      auto const               node_elements_range = nodes_to_node_elements[node];
-      auto const               node_element        = node_elements_range[node_element_index(offset)];
-      assert(node_element < num_node_elements);
-      node_elements_to_elements[node_element]         = element;
-      node_elements_to_nodes_in_element[node_element] = node_in_element;
-    }
+  auto const nodes_in_element                  = std::ptrdiff_t(hpc::weaken(s.nodes_in_element.size()));
+  auto       fill_functor                      = [=] HPC_DEVICE(node_element_index const node_element) {
+    auto const element_node = std::ptrdiff_t(
+        hpc::weaken(sorted_to_element_nodes_begin[element_node_index(hpc::weaken(node_element))]));
+    node_elements_to_elements[node_element]         = element_index(element_node / nodes_in_element);
+    node_elements_to_nodes_in_element[node_element] = node_in_element_index(element_node % nodes_in_element);
   };
-  hpc::for_each(hpc::device_policy(), s.elements, fill_functor);
-  auto sort_functor = [=] HPC_DEVICE(node_index const node) {
-    auto const                                    node_elements = nodes_to_node_elements[node];
-    hpc::counting_range<node_element_index> const except_last(node_elements.begin(), node_elements.end() - 1);
-    for (auto const node_element : except_last) {
-      hpc::counting_range<node_element_index> const remaining(node_element + 1, node_elements.end());
-      element_index                                 min_element(node_elements_to_elements[node_element]);
-      auto                                          min_node_element = node_element;
-      for (auto const node_element2 : remaining) {
-        auto const element = node_elements_to_elements[node_element2];
-        if (element < min_element) {
-          min_element      = element;
-          min_node_element = node_element2;
-        }
-      }
-      hpc::swap(node_elements_to_elements[node_element], node_elements_to_elements[min_node_element]);
-      hpc::swap(node_elements_to_nodes_in_element[node_element], node_elements_to_nodes_in_element[min_node_element]);
-    }
-    for (node_element_index i(*(node_elements.begin())); i < (*(node_elements.end())) - 1; ++i) {
-      assert(node_elements_to_elements[i] < node_elements_to_elements[i + 1]);
-    }
-  };
-  hpc::for_each(hpc::device_policy(), s.nodes, sort_functor);
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<node_element_index>(node_element_count), fill_functor);
   s.points.resize(s.elements.size() * s.points_in_element.size());
 }
 
@@ -404,4 +383,64 @@ build_mesh(input const& in, state& s)
   propagate_connectivity(s);
 }
 
+void
+color_elements(state& s)
+{
+  // greedy coloring on the host: each element takes the smallest color not used by an earlier element sharing a node
+  auto const num_elements = std::ptrdiff_t(hpc::weaken(s.elements.size()));
+  hpc::pinned_vector<node_index, element_node_index> element_nodes_to_nodes(s.elements_to_nodes.size());
+  hpc::copy(s.elements_to_nodes, element_nodes_to_nodes);
+  // the node to element adjacency that propagate_connectivity built, rebuilt on the host from its range sizes
+  hpc::device_vector<int, node_index> counts_vector(s.nodes.size());
+  auto const                          nodes_to_node_elements = s.nodes_to_node_elements.cbegin();
+  auto const                          nodes_to_count         = counts_vector.begin();
+  auto                                count_functor          = [=] HPC_DEVICE(node_index const node) {
+    nodes_to_count[node] = int(hpc::weaken(nodes_to_node_elements[node].size()));
+  };
+  hpc::for_each(hpc::device_policy(), s.nodes, count_functor);
+  hpc::pinned_vector<int, node_index> pinned_counts(s.nodes.size());
+  hpc::copy(counts_vector, pinned_counts);
+  hpc::pinned_range_sum<node_element_index, node_index> pinned_nodes_to_node_elements(pinned_counts);
+  hpc::pinned_vector<element_index, node_element_index> node_elements_to_elements(s.node_elements_to_elements.size());
+  hpc::copy(s.node_elements_to_elements, node_elements_to_elements);
+  auto const                  elements_to_element_nodes = s.elements * s.nodes_in_element;
+  std::vector<int>            element_colors(std::size_t(num_elements), -1);
+  std::vector<std::ptrdiff_t> color_blocked_by;
+  std::vector<int>            color_sizes;
+  for (auto const element : s.elements) {
+    auto const e = std::ptrdiff_t(hpc::weaken(element));
+    for (auto const element_node : elements_to_element_nodes[element]) {
+      node_index const node = element_nodes_to_nodes[element_node];
+      for (auto const node_element : pinned_nodes_to_node_elements[node]) {
+        auto const neighbor       = node_elements_to_elements[node_element];
+        auto const neighbor_color = element_colors[std::size_t(hpc::weaken(neighbor))];
+        if (neighbor_color != -1) color_blocked_by[std::size_t(neighbor_color)] = e;
+      }
+    }
+    int color = 0;
+    while (color < int(color_sizes.size()) && color_blocked_by[std::size_t(color)] == e) ++color;
+    if (color == int(color_sizes.size())) {
+      color_sizes.push_back(0);
+      color_blocked_by.push_back(-1);
+    }
+    element_colors[std::size_t(e)] = color;
+    ++color_sizes[std::size_t(color)];
+  }
+  int const num_colors = int(color_sizes.size());
+  hpc::host_vector<hpc::pinned_vector<element_index, int>, int> pinned_colors(num_colors);
+  for (int color = 0; color < num_colors; ++color) {
+    pinned_colors[color].resize(color_sizes[std::size_t(color)]);
+    color_sizes[std::size_t(color)] = 0;
+  }
+  for (auto const element : s.elements) {
+    auto const color                                        = element_colors[std::size_t(hpc::weaken(element))];
+    pinned_colors[color][color_sizes[std::size_t(color)]++] = element;
+  }
+  s.element_colors.resize(num_colors);
+  for (int color = 0; color < num_colors; ++color) {
+    s.element_colors[color].resize(pinned_colors[color].size());
+    hpc::copy(pinned_colors[color], s.element_colors[color]);
+  }
+}
+
 }  // namespace lgr
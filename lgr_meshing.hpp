@@ -9,5 +9,7 @@ void
 build_mesh(input const& in, state& s);
 void
 propagate_connectivity(state& s);
+void
+color_elements(state& s);
 
 }  // namespace lgr
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <j2/hardening.hpp>
 #include <lgr_adapt.hpp>
+#include <lgr_basis_gradients.hpp>
+#include <lgr_distributed.hpp>
 #include <lgr_element_specific.hpp>
 #include <lgr_exodus.hpp>
 #include <lgr_input.hpp>
@@ -12,8 +14,11 @@
 #include <lgr_physics.hpp>
 #include <lgr_physics_util.hpp>
 #include <lgr_print.hpp>
+#include <lgr_renumber.hpp>
 #include <lgr_stabilized.hpp>
 #include <lgr_state.hpp>
+#include <lgr_state_fields.hpp>
+#include <lgr_timers.hpp>
 #include <lgr_vtk.hpp>
 #include <otm_materials.hpp>
 
@@ -37,6 +42,7 @@ advance_time(
 HPC_NOINLINE inline void
 update_u(state& s, hpc::time<double> const dt)
 {
+  LGR_TIME_KERNEL("update_u", "nodes", s.nodes.size());
   auto const nodes_to_u = s.u.begin();
   auto const nodes_to_v = s.v.cbegin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
@@ -51,6 +57,7 @@ update_u(state& s, hpc::time<double> const dt)
 HPC_NOINLINE inline void
 explicit_newmark_predict(state& s, hpc::time<double> const dt)
 {
+  LGR_TIME_KERNEL("explicit_newmark_predict", "nodes", s.nodes.size());
   auto const nodes_to_u = s.u.begin();
   auto const nodes_to_v = s.v.begin();
   auto const nodes_to_a = s.a.cbegin();
@@ -70,6 +77,7 @@ explicit_newmark_predict(state& s, hpc::time<double> const dt)
 HPC_NOINLINE inline void
 explicit_newmark_correct(state& s, hpc::time<double> const dt)
 {
+  LGR_TIME_KERNEL("explicit_newmark_correct", "nodes", s.nodes.size());
   auto const nodes_to_u = s.u.begin();
   auto const nodes_to_v = s.v.begin();
   auto const nodes_to_a = s.a.cbegin();
@@ -92,6 +100,7 @@ update_v(
     hpc::time<double> const                                            dt,
     hpc::device_array_vector<hpc::velocity<double>, node_index> const& old_v_vector)
 {
+  LGR_TIME_KERNEL("update_v", "nodes", s.nodes.size());
   auto const nodes_to_v     = s.v.begin();
   auto const nodes_to_old_v = old_v_vector.cbegin();
   auto const nodes_to_a     = s.a.cbegin();
@@ -107,6 +116,7 @@ update_v(
 HPC_NOINLINE inline void
 update_a(state& s)
 {
+  LGR_TIME_KERNEL("update_a", "nodes", s.nodes.size());
   auto const nodes_to_f = s.f.cbegin();
   auto const nodes_to_m = s.mass.cbegin();
   auto const nodes_to_a = s.a.begin();
@@ -122,6 +132,7 @@ update_a(state& s)
 HPC_NOINLINE inline void
 update_x(state& s)
 {
+  LGR_TIME_KERNEL("update_x", "nodes", s.nodes.size());
   auto const nodes_to_u = s.u.cbegin();
   auto const nodes_to_x = s.x.begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
@@ -136,6 +147,8 @@ update_x(state& s)
 HPC_NOINLINE inline void
 update_p(state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_p", "elements", s.element_sets[material].size());
+  assert(has_fields(s, update_p_fields));
   auto const points_to_sigma    = s.sigma.cbegin();
   auto const points_to_p        = s.p.begin();
   auto const elements_to_points = s.elements * s.points_in_element;
@@ -152,6 +165,7 @@ update_p(state& s, material_index const material)
 HPC_NOINLINE inline void
 update_reference(state& s)
 {
+  LGR_TIME_KERNEL("update_reference", "elements", s.elements.size());
   auto const elements_to_element_nodes  = s.elements * s.nodes_in_element;
   auto const elements_to_element_points = s.elements * s.points_in_element;
   auto const points_to_point_nodes      = s.points * s.nodes_in_element;
@@ -159,33 +173,49 @@ update_reference(state& s)
   auto const nodes_to_u                 = s.u.cbegin();
   auto const points_to_F_total          = s.F_total.begin();
   auto const point_nodes_to_grad_N      = s.grad_N.begin();
+  auto const points_to_grad_N           = basis_gradients(s);
   auto const points_to_V                = s.V.begin();
   auto const points_to_rho              = s.rho.begin();
   auto const nodes_in_element           = s.nodes_in_element;
+  auto const track_F_total              = !s.F_total.empty();
   auto       functor                    = [=] HPC_DEVICE(element_index const element) {
     auto const element_nodes  = elements_to_element_nodes[element];
     auto const element_points = elements_to_element_points[element];
     for (auto const point : element_points) {
       auto const point_nodes = points_to_point_nodes[point];
       auto       F_incr      = hpc::deformation_gradient<double>::identity();
-      for (auto const node_in_element : nodes_in_element) {
-        auto const element_node = element_nodes[node_in_element];
-        auto const point_node   = point_nodes[node_in_element];
-        auto const node         = element_nodes_to_nodes[element_node];
-        auto const u            = nodes_to_u[node].load();
-        auto const old_grad_N   = point_nodes_to_grad_N[point_node].load();
-        F_incr                  = F_incr + outer_product(u, old_grad_N);
+      if (points_to_grad_N.recomputed()) {
+        // x has already moved by u, and the gradients at the new positions give the inverse increment exactly
+        auto const grad_N         = points_to_grad_N(element, point);
+        auto       F_incr_inverse = hpc::deformation_gradient<double>::identity();
+        for (auto const node_in_element : nodes_in_element) {
+          auto const node = element_nodes_to_nodes[element_nodes[node_in_element]];
+          auto const u    = nodes_to_u[node].load();
+          F_incr_inverse  = F_incr_inverse - outer_product(u, grad_N[node_in_element]);
+        }
+        F_incr = inverse(F_incr_inverse);
+      } else {
+        for (auto const node_in_element : nodes_in_element) {
+          auto const element_node = element_nodes[node_in_element];
+          auto const point_node   = point_nodes[node_in_element];
+          auto const node         = element_nodes_to_nodes[element_node];
+          auto const u            = nodes_to_u[node].load();
+          auto const old_grad_N   = point_nodes_to_grad_N[point_node].load();
+          F_incr                  = F_incr + outer_product(u, old_grad_N);
+        }
+        auto const F_inverse_transpose = transpose(inverse(F_incr));
+        for (auto const point_node : point_nodes) {
+          auto const old_grad_N             = point_nodes_to_grad_N[point_node].load();
+          auto const new_grad_N             = F_inverse_transpose * old_grad_N;
+          point_nodes_to_grad_N[point_node] = new_grad_N;
+        }
       }
-      auto const F_inverse_transpose = transpose(inverse(F_incr));
-      for (auto const point_node : point_nodes) {
-        auto const old_grad_N             = point_nodes_to_grad_N[point_node].load();
-        auto const new_grad_N             = F_inverse_transpose * old_grad_N;
-        point_nodes_to_grad_N[point_node] = new_grad_N;
+      if (track_F_total) {
+        auto const old_F_total   = points_to_F_total[point].load();
+        auto const new_F_total   = F_incr * old_F_total;
+        points_to_F_total[point] = new_F_total;
       }
-      auto const old_F_total   = points_to_F_total[point].load();
-      auto const new_F_total   = F_incr * old_F_total;
-      points_to_F_total[point] = new_F_total;
-      auto const J             = determinant(F_incr);
+      auto const J = determinant(F_incr);
       assert(J > 0.0);
       auto const old_V = points_to_V[point];
       auto const new_V = J * old_V;
@@ -202,16 +232,18 @@ update_reference(state& s)
 HPC_NOINLINE inline void
 update_element_dt(state& s)
 {
+  LGR_TIME_KERNEL("update_element_dt", "elements", s.elements.size());
   auto const points_to_c        = s.c.cbegin();
   auto const elements_to_h_min  = s.h_min.cbegin();
   auto const points_to_nu_art   = s.nu_art.cbegin();
   auto const points_to_dt       = s.element_dt.begin();
   auto const elements_to_points = s.elements * s.points_in_element;
+  auto const viscous            = !s.nu_art.empty();
   auto       functor            = [=] HPC_DEVICE(element_index const element) {
     auto const h_min = elements_to_h_min[element];
     for (auto const point : elements_to_points[element]) {
-      auto const c         = points_to_c[point];
-      auto const nu_art    = points_to_nu_art[point];
+      auto const c         = points_to_c[point].load();
+      auto const nu_art    = viscous ? points_to_nu_art[point].load() : hpc::kinematic_viscosity<double>(0.0);
       auto const h_sq      = h_min * h_min;
       auto const c_sq      = c * c;
       auto const nu_art_sq = nu_art * nu_art;
@@ -223,9 +255,31 @@ update_element_dt(state& s)
   hpc::for_each(hpc::device_policy(), s.elements, functor);
 }
 
+HPC_ALWAYS_INLINE HPC_DEVICE void
+neo_Hookean_point(
+    hpc::deformation_gradient<double> const& F,
+    hpc::pressure<double> const              K0,
+    hpc::pressure<double> const              G0,
+    hpc::symmetric_stress<double>&           sigma,
+    hpc::pressure<double>&                   K)
+{
+  auto const J       = determinant(F);
+  auto const Jinv    = 1.0 / J;
+  auto const half_K0 = 0.5 * K0;
+  auto const Jm13    = 1.0 / cbrt(J);
+  auto const Jm23    = Jm13 * Jm13;
+  auto const Jm53    = (Jm23 * Jm23) * Jm13;
+  auto const B       = self_times_transpose(F);
+  auto const devB    = deviatoric_part(B);
+  sigma              = half_K0 * (J - Jinv) + (G0 * Jm53) * devB;
+  K                  = half_K0 * (J + Jinv);
+}
+
 HPC_NOINLINE inline void
 neo_Hookean(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("neo_Hookean", "elements", s.element_sets[material].size());
+  assert(has_fields(s, neo_Hookean_fields));
   auto const points_to_F_total  = s.F_total.cbegin();
   auto const points_to_sigma    = s.sigma.begin();
   auto const points_to_K        = s.K.begin();
@@ -235,18 +289,11 @@ neo_Hookean(input const& in, state& s, material_index const material)
   auto const elements_to_points = s.elements * s.points_in_element;
   auto       functor            = [=] HPC_DEVICE(element_index const element) {
     for (auto const point : elements_to_points[element]) {
-      auto const F           = points_to_F_total[point].load();
-      auto const J           = determinant(F);
-      auto const Jinv        = 1.0 / J;
-      auto const half_K0     = 0.5 * K0;
-      auto const Jm13        = 1.0 / cbrt(J);
-      auto const Jm23        = Jm13 * Jm13;
-      auto const Jm53        = (Jm23 * Jm23) * Jm13;
-      auto const B           = self_times_transpose(F);
-      auto const devB        = deviatoric_part(B);
-      auto const sigma       = half_K0 * (J - Jinv) + (G0 * Jm53) * devB;
+      auto const F     = points_to_F_total[point].load();
+      auto       sigma = hpc::symmetric_stress<double>::zero();
+      auto       K     = hpc::pressure<double>(0.0);
+      neo_Hookean_point(F, K0, G0, sigma, K);
       points_to_sigma[point] = sigma;
-      auto const K           = half_K0 * (J + Jinv);
       points_to_K[point]     = K;
       points_to_G[point]     = G0;
     }
@@ -257,6 +304,8 @@ neo_Hookean(input const& in, state& s, material_index const material)
 HPC_NOINLINE inline void
 variational_J2(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("variational_J2", "elements", s.element_sets[material].size());
+  assert(has_fields(s, variational_J2_fields));
   auto const dt                 = s.dt;
   auto const points_to_F_total  = s.F_total.cbegin();
   auto const points_to_sigma    = s.sigma.begin();
@@ -272,6 +321,7 @@ variational_J2(input const& in, state& s, material_index const material)
   auto const Svis0              = in.Svis0[material];
   auto const m                  = in.m[material];
   auto const eps_dot0           = in.eps_dot0[material];
+  auto const table              = in.hardening_curve[material].table();
   auto const elements_to_points = s.elements * s.points_in_element;
   auto       functor            = [=] HPC_DEVICE(element_index const element) {
     for (auto const point : elements_to_points[element]) {
@@ -283,7 +333,7 @@ variational_J2(input const& in, state& s, material_index const material)
       j2::Properties props{K, G, Y0, n, eps0, Svis0, m, eps_dot0};
       auto           Fp = points_to_Fp[point].load();
       auto           ep = points_to_ep[point];
-      variational_J2_point(F, props, dt, sigma_full, Keff, Geff, W, Fp, ep);
+      variational_J2_point(F, props, table, dt, sigma_full, Keff, Geff, W, Fp, ep);
       auto const sigma       = hpc::symmetric_stress<double>(sigma_full);
       points_to_sigma[point] = sigma;
       points_to_K[point]     = Keff;
@@ -295,9 +345,86 @@ variational_J2(input const& in, state& s, material_index const material)
   hpc::for_each(hpc::device_policy(), s.element_sets[material], functor);
 }
 
+#ifndef HPC_CUDA
+
+// variational_J2 over tiles of native_simd<double>::size() points of the material, with the return
+// mapping of a tile done in simd lanes. The lanes past the last point repeat it and are not stored.
+HPC_NOINLINE inline void
+batched_variational_J2(input const& in, state& s, material_index const material)
+{
+  LGR_TIME_KERNEL("batched_variational_J2", "elements", s.element_sets[material].size());
+  assert(has_fields(s, variational_J2_fields));
+  using batch         = hpc::native_simd<double>;
+  constexpr int width = batch::size();
+
+  auto const dt                 = s.dt;
+  auto const points_to_F_total  = s.F_total.cbegin();
+  auto const points_to_sigma    = s.sigma.begin();
+  auto const points_to_K        = s.K.begin();
+  auto const points_to_G        = s.G.begin();
+  auto const points_to_Fp       = s.Fp_total.begin();
+  auto const points_to_ep       = s.ep.begin();
+  auto const elements_to_points = s.elements * s.points_in_element;
+  auto const set_elements       = s.element_sets[material].cbegin();
+  auto const points_per_element = int(s.points_in_element.size());
+  auto const point_count        = int(s.element_sets[material].size()) * points_per_element;
+  auto const tiles              = hpc::counting_range<int>((point_count + width - 1) / width);
+  auto const table              = in.hardening_curve[material].table();
+  j2::Properties const props{
+      in.K0[material],
+      in.G0[material],
+      in.Y0[material],
+      in.n[material],
+      in.eps0[material],
+      in.Svis0[material],
+      in.m[material],
+      in.eps_dot0[material]};
+  auto functor = [=] HPC_DEVICE(int const tile) {
+    point_index tile_points[width];
+    auto        F  = hpc::matrix3x3<batch>::zero();
+    auto        Fp = hpc::matrix3x3<batch>::zero();
+    auto        ep = batch(0.0);
+    for (int lane = 0; lane < width; ++lane) {
+      auto const k       = hpc::min(tile * width + lane, point_count - 1);
+      auto const element = set_elements[k / points_per_element];
+      auto const point   = elements_to_points[element][point_in_element_index(k % points_per_element)];
+      hpc::set_lane(F, lane, points_to_F_total[point].load());
+      hpc::set_lane(Fp, lane, points_to_Fp[point].load());
+      ep[lane]          = points_to_ep[point];
+      tile_points[lane] = point;
+    }
+    auto sigma = hpc::matrix3x3<batch>::zero();
+    auto W     = batch(0.0);
+    variational_J2_batch(F, props, table, dt, sigma, W, Fp, ep);
+    auto const lanes = hpc::min(width, point_count - tile * width);
+    for (int lane = 0; lane < lanes; ++lane) {
+      auto const point       = tile_points[lane];
+      points_to_sigma[point] = hpc::symmetric_stress<double>(hpc::get_lane(sigma, lane));
+      points_to_K[point]     = props.K;
+      points_to_G[point]     = props.G;
+      points_to_Fp[point]    = hpc::get_lane(Fp, lane);
+      points_to_ep[point]    = ep[lane];
+    }
+  };
+  hpc::for_each(hpc::device_policy(), tiles, functor);
+}
+
+#else
+
+// device builds have no simd lanes to batch points in
+HPC_NOINLINE inline void
+batched_variational_J2(input const& in, state& s, material_index const material)
+{
+  variational_J2(in, s, material);
+}
+
+#endif
+
 HPC_NOINLINE inline void
 Mie_Gruneisen_eos(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("Mie_Gruneisen_eos", "elements", s.element_sets[material].size());
+  assert(has_fields(s, Mie_Gruneisen_eos_fields));
   auto const points_to_sigma    = s.sigma.begin();
   auto const points_to_K        = s.K.begin();
   auto const points_to_dp_de    = s.dp_de.begin();
@@ -333,6 +460,8 @@ Mie_Gruneisen_eos(input const& in, state& s, material_index const material)
 HPC_NOINLINE inline void
 ideal_gas(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("ideal_gas", "elements", s.element_sets[material].size());
+  assert(has_fields(s, ideal_gas_fields));
   auto const points_to_rho      = s.rho.cbegin();
   auto const points_to_e        = s.e.cbegin();
   auto const points_to_sigma    = s.sigma.begin();
@@ -364,40 +493,56 @@ kappa_prime(hpc::pressure<double> const mu, hpc::adimensional<double> const x)
   return 200.0 * mu * std::log(x) / x;
 }
 
+template <class ElementRange>
 HPC_NOINLINE inline void
-update_element_force(state& s)
+update_element_force(state& s, ElementRange const& elements)
 {
+  LGR_TIME_KERNEL("update_element_force", "elements", elements.size());
+  assert(has_fields(s, element_force_fields));
   auto const comptet_stabilize     = s.use_comptet_stabilization;
   auto const points_to_K           = s.K.cbegin();
   auto const points_to_JavgJ       = s.JavgJ.cbegin();
   auto const points_to_sigma       = s.sigma.cbegin();
   auto const points_to_V           = s.V.cbegin();
-  auto const point_nodes_to_grad_N = s.grad_N.cbegin();
+  auto const points_to_grad_N      = basis_gradients(s);
   auto const point_nodes_to_f      = s.element_f.begin();
   auto const points_to_point_nodes = s.points * s.nodes_in_element;
-  auto       functor               = [=] HPC_DEVICE(point_index const point) {
-    auto const sigma       = points_to_sigma[point].load();
-    auto const V           = points_to_V[point];
-    auto const point_nodes = points_to_point_nodes[point];
-    for (auto const point_node : point_nodes) {
-      auto const grad_N = point_nodes_to_grad_N[point_node].load();
-      if (comptet_stabilize == true) {
-        auto const JavgJ = points_to_JavgJ[point];
-        auto const K     = points_to_K[point];
-        auto const f = -((sigma - kappa_prime(K, JavgJ) * hpc::symmetric_stress<double>::identity()) * grad_N) * V;
-        point_nodes_to_f[point_node] = f;
-      } else {
-        auto const f                 = -(sigma * grad_N) * V;
-        point_nodes_to_f[point_node] = f;
+  auto const elements_to_points    = s.elements * s.points_in_element;
+  auto const nodes_in_element      = s.nodes_in_element;
+  auto       functor               = [=] HPC_DEVICE(element_index const element) {
+    for (auto const point : elements_to_points[element]) {
+      auto const sigma        = points_to_sigma[point].load();
+      auto const V            = points_to_V[point];
+      auto const point_nodes  = points_to_point_nodes[point];
+      auto const point_grad_N = points_to_grad_N(element, point);
+      for (auto const node_in_element : nodes_in_element) {
+        auto const point_node = point_nodes[node_in_element];
+        auto const grad_N     = point_grad_N[node_in_element];
+        if (comptet_stabilize == true) {
+          auto const JavgJ = points_to_JavgJ[point];
+          auto const K     = points_to_K[point].load();
+          auto const f = -((sigma - kappa_prime(K, JavgJ) * hpc::symmetric_stress<double>::identity()) * grad_N) * V;
+          point_nodes_to_f[point_node] = f;
+        } else {
+          auto const f                 = -(sigma * grad_N) * V;
+          point_nodes_to_f[point_node] = f;
+        }
       }
     }
   };
-  hpc::for_each(hpc::device_policy(), s.points, functor);
+  hpc::for_each(hpc::device_policy(), elements, functor);
+}
+
+HPC_NOINLINE inline void
+update_element_force(state& s)
+{
+  update_element_force(s, s.elements);
 }
 
 HPC_NOINLINE inline void
 assemble_contact_force(state& s)
 {
+  LGR_TIME_KERNEL("assemble_contact_force", "nodes", s.nodes.size());
   auto const nodes_to_x    = s.x.cbegin();
   auto const nodes_to_mass = s.mass.cbegin();
   auto const nodes_to_f    = s.f.begin();
@@ -417,9 +562,12 @@ assemble_contact_force(state& s)
   hpc::for_each(hpc::device_policy(), s.nodes, functor);
 }
 
+template <class NodeRange>
 HPC_NOINLINE inline void
-assemble_internal_force(state& s)
+assemble_internal_force(state& s, NodeRange const& nodes)
 {
+  LGR_TIME_KERNEL("assemble_internal_force", "nodes", nodes.size());
+  assert(has_fields(s, element_force_fields));
   auto const nodes_to_node_elements            = s.nodes_to_node_elements.cbegin();
   auto const node_elements_to_elements         = s.node_elements_to_elements.cbegin();
   auto const node_elements_to_nodes_in_element = s.node_elements_to_nodes_in_element.cbegin();
@@ -444,7 +592,53 @@ assemble_internal_force(state& s)
     auto const f_new = f_old + node_f;
     nodes_to_f[node] = f_new;
   };
-  hpc::for_each(hpc::device_policy(), s.nodes, functor);
+  hpc::for_each(hpc::device_policy(), nodes, functor);
+}
+
+HPC_NOINLINE inline void
+assemble_internal_force(state& s)
+{
+  assemble_internal_force(s, s.nodes);
+}
+
+HPC_NOINLINE inline void
+scatter_internal_force(state& s)
+{
+  LGR_TIME_KERNEL("scatter_internal_force", "elements", s.elements.size());
+  auto const comptet_stabilize         = s.use_comptet_stabilization;
+  auto const points_to_K               = s.K.cbegin();
+  auto const points_to_JavgJ           = s.JavgJ.cbegin();
+  auto const points_to_sigma           = s.sigma.cbegin();
+  auto const points_to_V               = s.V.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
+  auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
+  auto const nodes_to_f                = s.f.begin();
+  auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
+  auto const elements_to_points        = s.elements * s.points_in_element;
+  auto const nodes_in_element          = s.nodes_in_element;
+  auto       functor                   = [=] HPC_DEVICE(element_index const element) {
+    auto const element_nodes = elements_to_element_nodes[element];
+    for (auto const point : elements_to_points[element]) {
+      auto sigma = points_to_sigma[point].load();
+      if (comptet_stabilize == true) {
+        auto const JavgJ = points_to_JavgJ[point];
+        auto const K     = points_to_K[point].load();
+        sigma            = sigma - kappa_prime(K, JavgJ) * hpc::symmetric_stress<double>::identity();
+      }
+      auto const V            = points_to_V[point];
+      auto const point_grad_N = points_to_grad_N(element, point);
+      for (auto const node_in_element : nodes_in_element) {
+        auto const grad_N = point_grad_N[node_in_element];
+        auto const node   = element_nodes_to_nodes[element_nodes[node_in_element]];
+        auto const f_old  = nodes_to_f[node].load();
+        auto const f_new  = f_old - (sigma * grad_N) * V;
+        nodes_to_f[node]  = f_new;
+      }
+    }
+  };
+  for (auto const& color : s.element_colors) {
+    hpc::for_each(hpc::device_policy(), color, functor);
+  }
 }
 
 HPC_NOINLINE inline void
@@ -453,15 +647,33 @@ assemble_external_force(state&)
   // Just a stub for now
 }
 
+void
+update_internal_force(input const& in, state& s)
+{
+  hpc::fill(hpc::device_policy(), s.f, hpc::force<double>::zero());
+  switch (in.force_assembly) {
+    case GATHER_FORCE_ASSEMBLY:
+      update_element_force(s);
+      assemble_internal_force(s);
+      break;
+    case COLORED_SCATTER_FORCE_ASSEMBLY: scatter_internal_force(s); break;
+  }
+}
+
 HPC_NOINLINE inline void
-update_nodal_force(state& s)
+update_nodal_force(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("update_nodal_force", "nodes", s.nodes.size());
   hpc::fill(hpc::device_policy(), s.f, hpc::force<double>::zero());
-  assemble_internal_force(s);
+  switch (in.force_assembly) {
+    case GATHER_FORCE_ASSEMBLY: assemble_internal_force(s); break;
+    case COLORED_SCATTER_FORCE_ASSEMBLY: scatter_internal_force(s); break;
+  }
   assemble_external_force(s);
   if (s.use_penalty_contact == true) {
     assemble_contact_force(s);
   }
+  exchange_nodal_force(s);
 }
 
 HPC_NOINLINE inline void
@@ -470,6 +682,7 @@ zero_displacement(
     hpc::vector3<double> const                                   axis,
     hpc::device_array_vector<hpc::position<double>, node_index>* u_vector)
 {
+  LGR_TIME_KERNEL("zero_displacement", "nodes", domain.size());
   auto const nodes_to_u = u_vector->begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
     auto const old_u = nodes_to_u[node].load();
@@ -485,6 +698,7 @@ zero_velocity(
     hpc::vector3<double> const                                   axis,
     hpc::device_array_vector<hpc::position<double>, node_index>* v_vector)
 {
+  LGR_TIME_KERNEL("zero_velocity", "nodes", domain.size());
   auto const nodes_to_v = v_vector->begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
     auto const old_v = nodes_to_v[node].load();
@@ -500,6 +714,7 @@ zero_acceleration(
     hpc::vector3<double> const                                       axis,
     hpc::device_array_vector<hpc::acceleration<double>, node_index>* a_vector)
 {
+  LGR_TIME_KERNEL("zero_acceleration", "nodes", domain.size());
   auto const nodes_to_a = a_vector->begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
     auto const old_a = nodes_to_a[node].load();
@@ -516,6 +731,7 @@ prescribed_displacement(
     hpc::length<double> const                                    u,
     hpc::device_array_vector<hpc::position<double>, node_index>* u_vector)
 {
+  LGR_TIME_KERNEL("prescribed_displacement", "nodes", domain.size());
   auto const nodes_to_u = u_vector->begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
     auto const old_u = nodes_to_u[node].load();
@@ -532,6 +748,7 @@ prescribed_velocity(
     hpc::speed<double> const                                     v,
     hpc::device_array_vector<hpc::velocity<double>, node_index>* v_vector)
 {
+  LGR_TIME_KERNEL("prescribed_velocity", "nodes", domain.size());
   auto const nodes_to_v = v_vector->begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
     auto const old_v = nodes_to_v[node].load();
@@ -548,6 +765,7 @@ prescribed_acceleration(
     hpc::speed_rate<double> const                                    a,
     hpc::device_array_vector<hpc::acceleration<double>, node_index>* a_vector)
 {
+  LGR_TIME_KERNEL("prescribed_acceleration", "nodes", domain.size());
   auto const nodes_to_a = a_vector->begin();
   auto       functor    = [=] HPC_DEVICE(node_index const node) {
     auto const old_a = nodes_to_a[node].load();
@@ -584,11 +802,12 @@ enforce_prescribed_acceleration(input const& in, state& s)
 HPC_NOINLINE inline void
 update_symm_grad_v(state& s)
 {
+  LGR_TIME_KERNEL("update_symm_grad_v", "elements", s.elements.size());
+  assert(has_fields(s, SYMM_GRAD_V_FIELD));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const elements_to_points        = s.elements * s.points_in_element;
-  auto const points_to_point_nodes     = s.points * s.nodes_in_element;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
-  auto const point_nodes_to_grad_N     = s.grad_N.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
   auto const nodes_to_v                = s.v.cbegin();
   auto const points_to_symm_grad_v     = s.symm_grad_v.begin();
   auto const nodes_in_element          = s.nodes_in_element;
@@ -596,13 +815,12 @@ update_symm_grad_v(state& s)
     for (auto const point : elements_to_points[element]) {
       auto       grad_v        = hpc::velocity_gradient<double>::zero();
       auto const element_nodes = elements_to_element_nodes[element];
-      auto const point_nodes   = points_to_point_nodes[point];
+      auto const point_grad_N  = points_to_grad_N(element, point);
       for (auto const node_in_element : nodes_in_element) {
         auto const       element_node = element_nodes[node_in_element];
-        auto const       point_node   = point_nodes[node_in_element];
         node_index const node         = element_nodes_to_nodes[element_node];
         auto const       v            = nodes_to_v[node].load();
-        auto const       grad_N       = point_nodes_to_grad_N[point_node].load();
+        auto const       grad_N       = point_grad_N[node_in_element];
         grad_v                        = grad_v + outer_product(v, grad_N);
       }
       hpc::symmetric_velocity_gradient<double> const symm_grad_v(grad_v);
@@ -615,6 +833,8 @@ update_symm_grad_v(state& s)
 HPC_NOINLINE inline void
 stress_power(state& s)
 {
+  LGR_TIME_KERNEL("stress_power", "points", s.points.size());
+  assert(has_fields(s, unfused_point_fields));
   auto const points_to_sigma       = s.sigma.cbegin();
   auto const points_to_symm_grad_v = s.symm_grad_v.cbegin();
   auto const points_to_rho_e_dot   = s.rho_e_dot.begin();
@@ -634,6 +854,8 @@ update_e(
     material_index const                                                 material,
     hpc::device_vector<hpc::specific_energy<double>, point_index> const& old_e_vector)
 {
+  LGR_TIME_KERNEL("update_e", "elements", s.element_sets[material].size());
+  assert(has_fields(s, update_e_fields));
   auto const points_to_rho_e_dot = s.rho_e_dot.cbegin();
   auto const points_to_rho       = s.rho.cbegin();
   auto const points_to_old_e     = old_e_vector.cbegin();
@@ -655,6 +877,8 @@ update_e(
 HPC_NOINLINE inline void
 apply_viscosity(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("apply_viscosity", "elements", s.elements.size());
+  assert(has_fields(s, apply_viscosity_fields));
   auto const points_to_symm_grad_v = s.symm_grad_v.cbegin();
   auto const elements_to_h_art     = s.h_art.cbegin();
   auto const points_to_c           = s.c.cbegin();
@@ -672,7 +896,7 @@ apply_viscosity(input const& in, state& s)
       if (div_v >= 0.0) {
         points_to_nu_art[point] = 0.0;
       } else {
-        auto const c            = points_to_c[point];
+        auto const c            = points_to_c[point].load();
         auto const nu_art       = c1 * ((-div_v) * (h_art * h_art)) + c2 * c * h_art;
         points_to_nu_art[point] = nu_art;
         auto const rho          = points_to_rho[point];
@@ -689,6 +913,8 @@ apply_viscosity(input const& in, state& s)
 HPC_NOINLINE inline void
 volume_average_J(state& s)
 {
+  LGR_TIME_KERNEL("volume_average_J", "elements", s.elements.size());
+  assert(has_fields(s, volume_average_J_fields));
   auto const comptet_stabilize  = s.use_comptet_stabilization;
   auto const points_to_V        = s.V.cbegin();
   auto const points_to_F        = s.F_total.begin();
@@ -720,6 +946,7 @@ volume_average_J(state& s)
 HPC_NOINLINE inline void
 volume_average_rho(state& s)
 {
+  LGR_TIME_KERNEL("volume_average_rho", "elements", s.elements.size());
   auto const points_to_V        = s.V.cbegin();
   auto const points_to_rho      = s.rho.begin();
   auto const elements_to_points = s.elements * s.points_in_element;
@@ -743,6 +970,7 @@ volume_average_rho(state& s)
 HPC_NOINLINE inline void
 volume_average_e(state& s)
 {
+  LGR_TIME_KERNEL("volume_average_e", "elements", s.elements.size());
   auto const points_to_V        = s.V.cbegin();
   auto const points_to_rho      = s.rho.cbegin();
   auto const points_to_e        = s.e.begin();
@@ -768,6 +996,7 @@ volume_average_e(state& s)
 HPC_NOINLINE inline void
 volume_average_p(state& s)
 {
+  LGR_TIME_KERNEL("volume_average_p", "elements", s.elements.size());
   auto const comptet_stabilize  = s.use_comptet_stabilization;
   auto const points_to_K        = s.K.cbegin();
   auto const points_to_JavgJ    = s.JavgJ.cbegin();
@@ -783,7 +1012,7 @@ volume_average_p(state& s)
       auto const V     = points_to_V[point];
       if (comptet_stabilize == true) {
         auto const JavgJ = points_to_JavgJ[point];
-        auto const K     = points_to_K[point];
+        auto const K     = points_to_K[point].load();
         p_integral += V * (p - kappa_prime(K, JavgJ));
       } else {
         p_integral += V * p;
@@ -808,11 +1037,16 @@ update_single_material_state(
     hpc::time<double> const                                      dt,
     hpc::device_vector<hpc::pressure<double>, node_index> const& old_p_h)
 {
+  LGR_TIME_KERNEL("update_single_material_state", "elements", s.element_sets[material].size());
   if (in.enable_neo_Hookean[material]) {
     neo_Hookean(in, s, material);
   }
   if (in.enable_variational_J2[material]) {
-    variational_J2(in, s, material);
+    if (in.enable_batched_J2) {
+      batched_variational_J2(in, s, material);
+    } else {
+      variational_J2(in, s, material);
+    }
   }
   if (in.enable_ideal_gas[material]) {
     if (in.enable_nodal_energy[material]) {
@@ -843,6 +1077,7 @@ update_material_state(
     hpc::time<double> const                                                                        dt,
     hpc::host_vector<hpc::device_vector<hpc::pressure<double>, node_index>, material_index> const& old_p_h)
 {
+  LGR_TIME_KERNEL("update_material_state", "elements", s.elements.size());
   hpc::fill(hpc::device_policy(), s.sigma, hpc::symmetric_stress<double>::zero());
   hpc::fill(hpc::device_policy(), s.G, hpc::pressure<double>(0.0));
   for (auto const material : in.materials) {
@@ -850,11 +1085,26 @@ update_material_state(
   }
 }
 
+// The forces of the nodes that other ranks copy are assembled and sent first; the other elements and nodes are
+// computed while the messages are in flight.
 HPC_NOINLINE inline void
-update_a_from_material_state(input const& in, state& s)
+update_nodal_force_overlapped(state& s)
 {
-  update_element_force(s);
-  update_nodal_force(s);
+  LGR_TIME_KERNEL("update_nodal_force_overlapped", "nodes", s.nodes.size());
+  hpc::fill(hpc::device_policy(), s.f, hpc::force<double>::zero());
+  assemble_external_force(s);
+  update_element_force(s, s.halo.boundary_elements);
+  assemble_internal_force(s, s.halo.boundary_nodes);
+  start_nodal_force_exchange(s);
+  update_element_force(s, s.halo.interior_elements);
+  assemble_internal_force(s, s.halo.interior_nodes);
+  finish_nodal_force_exchange(s);
+}
+
+HPC_NOINLINE inline void
+update_a_from_nodal_force(input const& in, state& s)
+{
+  LGR_TIME_KERNEL("update_a_from_nodal_force", "nodes", s.nodes.size());
   update_a(s);
   for (auto const& cond : in.zero_acceleration_conditions) {
     zero_acceleration(s.node_sets[cond.boundary], cond.axis, &s.a);
@@ -862,9 +1112,182 @@ update_a_from_material_state(input const& in, state& s)
   enforce_prescribed_acceleration(in, s);
 }
 
+HPC_NOINLINE inline void
+update_a_from_element_force(input const& in, state& s)
+{
+  LGR_TIME_KERNEL("update_a_from_element_force", "nodes", s.nodes.size());
+  update_nodal_force(in, s);
+  update_a_from_nodal_force(in, s);
+}
+
+HPC_NOINLINE inline void
+update_a_from_material_state(input const& in, state& s)
+{
+  LGR_TIME_KERNEL("update_a_from_material_state", "elements", s.elements.size());
+  if (in.force_assembly == GATHER_FORCE_ASSEMBLY && !s.use_penalty_contact && !s.halo.ranks.empty()) {
+    update_nodal_force_overlapped(s);
+    update_a_from_nodal_force(in, s);
+    return;
+  }
+  if (in.force_assembly == GATHER_FORCE_ASSEMBLY) update_element_force(s);
+  update_a_from_element_force(in, s);
+}
+
+// The fused point kernels do, per integration point and with each input loaded once, the work of
+// update_symm_grad_v + stress_power + update_e, and of
+// update_material_state + update_c + update_element_dt + update_element_force.
+// The velocity gradient and stress power never leave registers, so symm_grad_v and rho_e_dot are not allocated.
+// They work for every element kind, but every material must be neo-Hookean or variational J2
+// without nodal pressure/energy, artificial viscosity or pressure averaging.
+HPC_NOINLINE inline void
+check_fused_point_kernels(input const& in)
+{
+  auto const supported = [&](material_index const material) {
+    return (in.enable_neo_Hookean[material] != in.enable_variational_J2[material]) && !in.enable_ideal_gas[material] &&
+           !in.enable_Mie_Gruneisen_eos[material] && !in.enable_nodal_pressure[material] &&
+           !in.enable_nodal_energy[material];
+  };
+  if (in.enable_viscosity || in.enable_p_averaging || !hpc::all_of(hpc::serial_policy(), in.materials, supported)) {
+    HPC_ERROR_EXIT("fused point kernels need neo-Hookean or J2 materials without viscosity or nodal/averaged pressure");
+  }
+}
+
+HPC_NOINLINE inline void
+fused_update_e(
+    state&                                                               s,
+    hpc::time<double> const                                              dt,
+    hpc::device_vector<hpc::specific_energy<double>, point_index> const& old_e_vector)
+{
+  LGR_TIME_KERNEL("fused_update_e", "elements", s.elements.size());
+  auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
+  auto const elements_to_points        = s.elements * s.points_in_element;
+  auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
+  auto const nodes_to_v                = s.v.cbegin();
+  auto const points_to_sigma           = s.sigma.cbegin();
+  auto const points_to_rho             = s.rho.cbegin();
+  auto const points_to_old_e           = old_e_vector.cbegin();
+  auto const points_to_e               = s.e.begin();
+  auto const nodes_in_element          = s.nodes_in_element;
+  auto       functor                   = [=] HPC_DEVICE(element_index const element) {
+    auto const element_nodes = elements_to_element_nodes[element];
+    for (auto const point : elements_to_points[element]) {
+      auto       grad_v       = hpc::velocity_gradient<double>::zero();
+      auto const point_grad_N = points_to_grad_N(element, point);
+      for (auto const node_in_element : nodes_in_element) {
+        node_index const node   = element_nodes_to_nodes[element_nodes[node_in_element]];
+        auto const       v      = nodes_to_v[node].load();
+        auto const       grad_N = point_grad_N[node_in_element];
+        grad_v                  = grad_v + outer_product(v, grad_N);
+      }
+      auto const symm_grad_v = hpc::symmetric_velocity_gradient<double>(grad_v);
+      auto const sigma       = points_to_sigma[point].load();
+      auto const rho_e_dot   = inner_product(sigma, symm_grad_v);
+      auto const rho         = points_to_rho[point];
+      auto const e_dot       = rho_e_dot / rho;
+      auto const old_e       = points_to_old_e[point];
+      points_to_e[point]     = old_e + dt * e_dot;
+    }
+  };
+  hpc::for_each(hpc::device_policy(), s.elements, functor);
+}
+
+HPC_NOINLINE inline void
+fused_update_point_force(input const& in, state& s, material_index const material, bool const last_pc)
+{
+  LGR_TIME_KERNEL("fused_update_point_force", "elements", s.element_sets[material].size());
+  assert(has_fields(s, in.enable_variational_J2[material] ? variational_J2_fields : neo_Hookean_fields));
+  auto const dt                    = s.dt;
+  auto const comptet_stabilize     = s.use_comptet_stabilization;
+  auto const J2                    = in.enable_variational_J2[material];
+  auto const store_element_f       = (in.force_assembly == GATHER_FORCE_ASSEMBLY);
+  auto const elements_to_points    = s.elements * s.points_in_element;
+  auto const points_to_point_nodes = s.points * s.nodes_in_element;
+  auto const points_to_grad_N      = basis_gradients(s);
+  auto const points_to_F_total     = s.F_total.cbegin();
+  auto const points_to_rho         = s.rho.cbegin();
+  auto const points_to_V           = s.V.cbegin();
+  auto const points_to_JavgJ       = s.JavgJ.cbegin();
+  auto const elements_to_h_min     = s.h_min.cbegin();
+  auto const points_to_Fp          = s.Fp_total.begin();
+  auto const points_to_ep          = s.ep.begin();
+  auto const points_to_sigma       = s.sigma.begin();
+  auto const points_to_K           = s.K.begin();
+  auto const points_to_G           = s.G.begin();
+  auto const points_to_c           = s.c.begin();
+  auto const points_to_dt          = s.element_dt.begin();
+  auto const point_nodes_to_f      = s.element_f.begin();
+  auto const nodes_in_element      = s.nodes_in_element;
+  auto const K0                    = in.K0[material];
+  auto const G0                    = in.G0[material];
+  auto const table                 = in.hardening_curve[material].table();
+  j2::Properties const props{
+      K0,
+      G0,
+      in.Y0[material],
+      in.n[material],
+      in.eps0[material],
+      in.Svis0[material],
+      in.m[material],
+      in.eps_dot0[material]};
+  auto functor = [=] HPC_DEVICE(element_index const element) {
+    for (auto const point : elements_to_points[element]) {
+      auto const point_nodes = points_to_point_nodes[point];
+      auto const F           = points_to_F_total[point].load();
+      auto       sigma       = hpc::symmetric_stress<double>::zero();
+      auto       K           = hpc::pressure<double>(0.0);
+      auto       G           = G0;
+      if (J2) {
+        auto sigma_full = hpc::stress<double>::zero();
+        auto W          = hpc::energy_density<double>(0.0);
+        auto Fp         = points_to_Fp[point].load();
+        auto ep         = points_to_ep[point];
+        variational_J2_point(F, props, table, dt, sigma_full, K, G, W, Fp, ep);
+        sigma               = hpc::symmetric_stress<double>(sigma_full);
+        points_to_Fp[point] = Fp;
+        points_to_ep[point] = ep;
+      } else {
+        neo_Hookean_point(F, K0, G0, sigma, K);
+      }
+      points_to_sigma[point] = sigma;
+      points_to_K[point]     = K;
+      points_to_G[point]     = G;
+      auto const rho         = points_to_rho[point];
+      auto const M           = K + (4.0 / 3.0) * G;
+      auto const c           = sqrt(M / rho);
+      points_to_c[point]     = c;
+      if (last_pc) {
+        auto const h_min     = elements_to_h_min[element];
+        auto const nu_art    = hpc::kinematic_viscosity<double>(0.0);
+        auto const h_sq      = h_min * h_min;
+        auto const c_sq      = c * c;
+        auto const nu_art_sq = nu_art * nu_art;
+        auto const point_dt  = h_sq / (nu_art + sqrt(nu_art_sq + (c_sq * h_sq)));
+        assert(point_dt > 0.0);
+        points_to_dt[point] = point_dt;
+      }
+      if (store_element_f) {
+        if (comptet_stabilize == true) {
+          auto const JavgJ = points_to_JavgJ[point];
+          sigma            = sigma - kappa_prime(K, JavgJ) * hpc::symmetric_stress<double>::identity();
+        }
+        auto const V            = points_to_V[point];
+        auto const point_grad_N = points_to_grad_N(element, point);
+        for (auto const node_in_element : nodes_in_element) {
+          auto const point_node        = point_nodes[node_in_element];
+          auto const grad_N            = point_grad_N[node_in_element];
+          point_nodes_to_f[point_node] = -(sigma * grad_N) * V;
+        }
+      }
+    }
+  };
+  hpc::for_each(hpc::device_policy(), s.element_sets[material], functor);
+}
+
 HPC_NOINLINE inline void
 midpoint_predictor_corrector_step(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("midpoint_predictor_corrector_step", "elements", s.elements.size());
   hpc::fill(hpc::device_policy(), s.u, hpc::displacement<double>(0.0, 0.0, 0.0));
   hpc::device_array_vector<hpc::velocity<double>, node_index> old_v(s.nodes.size());
   hpc::copy(hpc::device_policy(), s.v, old_v);
@@ -892,7 +1315,7 @@ midpoint_predictor_corrector_step(input const& in, state& s)
     if (pc == 0) advance_time(in, s.max_stable_dt, s.next_file_output_time, &s.time, &s.dt);
     update_v(s, s.dt / 2.0, old_v);
     enforce_prescribed_velocity(in, s);
-    update_symm_grad_v(s);
+    if (!in.enable_fused_point_kernels) update_symm_grad_v(s);
     bool const last_pc = (pc == (npc - 1));
     auto const half_dt = last_pc ? s.dt : s.dt / 2.0;
     for (auto const material : in.materials) {
@@ -900,13 +1323,18 @@ midpoint_predictor_corrector_step(input const& in, state& s)
         update_p_h(s, half_dt, material, old_p_h[material]);
       }
     }
-    stress_power(s);
-    for (auto const material : in.materials) {
-      if (in.enable_nodal_energy[material]) {
-        update_e_h_dot_from_a(in, s, material);
-        update_e_h(s, half_dt, material, old_e_h[material]);
-      } else {
-        update_e(s, half_dt, material, old_e);
+    if (in.enable_fused_point_kernels) {
+      fused_update_e(s, half_dt, old_e);
+    } else {
+      stress_power(s);
+      if (in.enable_fused_nodal_kernels) update_e_h_dot_from_a(in, s);
+      for (auto const material : in.materials) {
+        if (in.enable_nodal_energy[material]) {
+          if (!in.enable_fused_nodal_kernels) update_e_h_dot_from_a(in, s, material);
+          update_e_h(s, half_dt, material, old_e_h[material]);
+        } else {
+          update_e(s, half_dt, material, old_e);
+        }
       }
     }
     if (in.enable_e_averaging) volume_average_e(s);
@@ -920,9 +1348,10 @@ midpoint_predictor_corrector_step(input const& in, state& s)
     update_reference(s);
     if (in.enable_J_averaging) volume_average_J(s);
     if (in.enable_rho_averaging) volume_average_rho(s);
+    if (in.enable_fused_nodal_kernels) update_nodal_density(in, s);
     for (auto const material : in.materials) {
       if (in.enable_nodal_energy[material]) {
-        update_nodal_density(s, material);
+        if (!in.enable_fused_nodal_kernels) update_nodal_density(s, material);
         interpolate_rho(s, material);
       }
     }
@@ -930,28 +1359,41 @@ midpoint_predictor_corrector_step(input const& in, state& s)
       update_quality(in, s);
       update_min_quality(s);
     }
-    update_symm_grad_v(s);
-    update_h_min(in, s);
-    if (in.enable_viscosity) update_h_art(in, s);
-    update_material_state(in, s, half_dt, old_p_h);
-    for (auto const material : in.materials) {
-      if (in.enable_nodal_energy[material] && !in.enable_Mie_Gruneisen_eos[material]) {
-        interpolate_K(s, material);
+    if (in.enable_fused_point_kernels) {
+      update_h_min(in, s);
+      for (auto const material : in.materials) {
+        fused_update_point_force(in, s, material, last_pc);
       }
-    }
-    update_c(s);
-    if (in.enable_viscosity) apply_viscosity(in, s);
-    if (in.enable_p_averaging) volume_average_p(s);
-    if (last_pc) update_element_dt(s);
-    if (last_pc) find_max_stable_dt(s);
-    update_a_from_material_state(in, s);
-    for (auto const material : in.materials) {
-      if (in.enable_nodal_pressure[material]) {
-        update_p_h_dot_from_a(in, s, material);
-      }
-      if (!(in.enable_nodal_pressure[material] || in.enable_nodal_energy[material])) {
+      if (last_pc) find_max_stable_dt(s);
+      update_a_from_element_force(in, s);
+      for (auto const material : in.materials) {
         update_p(s, material);
       }
+    } else {
+      update_symm_grad_v(s);
+      update_h_min(in, s);
+      if (in.enable_viscosity) update_h_art(in, s);
+      update_material_state(in, s, half_dt, old_p_h);
+      for (auto const material : in.materials) {
+        if (in.enable_nodal_energy[material] && !in.enable_Mie_Gruneisen_eos[material]) {
+          interpolate_K(s, material);
+        }
+      }
+      update_c(s);
+      if (in.enable_viscosity) apply_viscosity(in, s);
+      if (in.enable_p_averaging) volume_average_p(s);
+      if (last_pc) update_element_dt(s);
+      if (last_pc) find_max_stable_dt(s);
+      update_a_from_material_state(in, s);
+      if (in.enable_fused_nodal_kernels) update_p_h_dot_from_a(in, s);
+      for (auto const material : in.materials) {
+        if (in.enable_nodal_pressure[material] && !in.enable_fused_nodal_kernels) {
+          update_p_h_dot_from_a(in, s, material);
+        }
+        if (!(in.enable_nodal_pressure[material] || in.enable_nodal_energy[material])) {
+          update_p(s, material);
+        }
+      }
     }
   }
 }
@@ -959,6 +1401,7 @@ midpoint_predictor_corrector_step(input const& in, state& s)
 HPC_NOINLINE inline void
 velocity_verlet_step(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("velocity_verlet_step", "elements", s.elements.size());
   hpc::host_vector<hpc::device_vector<hpc::pressure<double>, node_index>, material_index> old_p_h(in.materials.size());
   advance_time(in, s.max_stable_dt, s.next_file_output_time, &s.time, &s.dt);
   update_v(s, s.dt / 2.0, s.v);
@@ -973,11 +1416,12 @@ velocity_verlet_step(input const& in, state& s)
   update_element_dt(s);
   find_max_stable_dt(s);
   update_a_from_material_state(in, s);
+  if (in.enable_fused_nodal_kernels) update_p_h_dot_from_a(in, s);
   for (auto const material : in.materials) {
-    if (in.enable_nodal_pressure[material]) {
-      update_p_h_dot_from_a(in, s, material);
-    } else {
+    if (!in.enable_nodal_pressure[material]) {
       update_p(s, material);
+    } else if (!in.enable_fused_nodal_kernels) {
+      update_p_h_dot_from_a(in, s, material);
     }
   }
   update_v(s, s.dt / 2.0, s.v);
@@ -986,6 +1430,12 @@ velocity_verlet_step(input const& in, state& s)
 HPC_NOINLINE inline void
 time_integrator_step(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("time_integrator_step", "elements", s.elements.size());
+  hpc::pool_scope<hpc::device_memory> const step_scratch;
+#ifdef HPC_CUDA
+  // without CUDA, pinned and device memory share one pool
+  hpc::pool_scope<hpc::pinned_memory> const step_pinned_scratch;
+#endif
   switch (in.time_integrator) {
     case MIDPOINT_PREDICTOR_CORRECTOR: midpoint_predictor_corrector_step(in, s); break;
     case VELOCITY_VERLET: velocity_verlet_step(in, s); break;
@@ -1000,6 +1450,7 @@ initialize_material_scalar(
     material_index const                       material,
     hpc::device_vector<Quantity, point_index>& out)
 {
+  LGR_TIME_KERNEL("initialize_material_scalar", "elements", s.element_sets[material].size());
   auto const elements_to_points = s.elements * s.points_in_element;
   auto const points_to_scalar   = out.begin();
   auto       functor            = [=] HPC_DEVICE(element_index const element) {
@@ -1013,12 +1464,17 @@ initialize_material_scalar(
 HPC_NOINLINE inline void
 common_initialization_part1(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("common_initialization_part1", "elements", s.elements.size());
   initialize_V(in, s);
   if (in.enable_viscosity) update_h_art(in, s);
   update_nodal_mass(in, s);
-  for (auto const material : in.materials) {
-    if (in.enable_nodal_energy[material]) {
-      update_nodal_density(s, material);
+  if (in.enable_fused_nodal_kernels) {
+    update_nodal_density(in, s);
+  } else {
+    for (auto const material : in.materials) {
+      if (in.enable_nodal_energy[material]) {
+        update_nodal_density(s, material);
+      }
     }
   }
   initialize_grad_N(in, s);
@@ -1026,13 +1482,14 @@ common_initialization_part1(input const& in, state& s)
     update_quality(in, s);
     update_min_quality(s);
   }
-  update_symm_grad_v(s);
+  if (!in.enable_fused_point_kernels) update_symm_grad_v(s);
   update_h_min(in, s);
 }
 
 HPC_NOINLINE inline void
 common_initialization_part2(input const& in, state& s)
 {
+  LGR_TIME_KERNEL("common_initialization_part2", "elements", s.elements.size());
   hpc::host_vector<hpc::device_vector<hpc::pressure<double>, node_index>, material_index> old_p_h(in.materials.size());
   if (hpc::any_of(hpc::serial_policy(), in.enable_p_prime)) {
     hpc::fill(hpc::device_policy(), s.element_dt, hpc::time<double>(0.0));
@@ -1053,8 +1510,9 @@ common_initialization_part2(input const& in, state& s)
   update_element_dt(s);
   find_max_stable_dt(s);
   update_a_from_material_state(in, s);
+  if (in.enable_fused_nodal_kernels) update_p_h_dot_from_a(in, s);
   for (auto const material : in.materials) {
-    if (in.enable_nodal_pressure[material]) {
+    if (in.enable_nodal_pressure[material] && !in.enable_fused_nodal_kernels) {
       update_p_h_dot_from_a(in, s, material);
     }
     if (!(in.enable_nodal_pressure[material] || in.enable_nodal_energy[material])) {
@@ -1073,9 +1531,15 @@ void
 run(input const& in, std::string const& filename)
 {
   std::cout << std::scientific << std::setprecision(17);
+  auto const output_to_command_line = in.output_to_command_line && (distributed_rank() == 0);
+  if (in.enable_fused_point_kernels) check_fused_point_kernels(in);
+  if (in.recompute_grad_N && in.element != TETRAHEDRON) {
+    HPC_ERROR_EXIT("recompute_grad_N is only supported on linear tetrahedra");
+  }
   auto const num_file_output_periods = in.num_file_output_periods;
   auto const file_output_period =
       num_file_output_periods ? in.end_time / double(num_file_output_periods) : hpc::time<double>(0.0);
+  reset_kernel_timings();
   state s;
   if (filename == "") {
     build_mesh(in, s);
@@ -1087,14 +1551,21 @@ run(input const& in, std::string const& filename)
     }
   }
   if (in.x_transform) in.x_transform(&s.x);
+  if (in.enable_adapt && distributed_size() > 1) HPC_ERROR_EXIT("adaptivity does not support several ranks");
+  decompose_mesh(s, distributed_rank(), distributed_size());
   s.use_displacement_contact = in.use_displacement_contact;
   s.use_penalty_contact      = in.use_penalty_contact;
   s.contact_penalty_coeff    = in.contact_penalty_coeff;
   resize_state(in, s);
+  if (in.print_state_memory && output_to_command_line) print_state_memory(s, std::cout);
   assign_element_materials(in, s);
   compute_nodal_materials(in, s);
+  renumber_mesh(in, s);
+  build_halo(s);
   collect_node_sets(in, s);
   collect_element_sets(in, s);
+  collect_material_node_elements(in, s);
+  if (in.force_assembly == COLORED_SCATTER_FORCE_ASSEMBLY) color_elements(s);
   for (auto const material : in.materials) {
     initialize_material_scalar(in.rho0[material], s, material, s.rho);
     if (in.enable_nodal_pressure[material]) {
@@ -1121,13 +1592,13 @@ run(input const& in, std::string const& filename)
   common_initialization_part1(in, s);
   common_initialization_part2(in, s);
   if (in.enable_adapt) initialize_h_adapt(s);
-  file_writer output_file(in.name);
+  file_writer output_file(rank_file_prefix(in.name));
   s.next_file_output_time = num_file_output_periods ? 0.0 : in.end_time;
   int file_output_index   = 0;
   int file_period_index   = 0;
   while (s.time < in.end_time) {
     if (num_file_output_periods) {
-      if (in.output_to_command_line) {
+      if (output_to_command_line) {
         std::cout << "outputting file n " << file_output_index << " time " << double(s.time) << "\n";
       }
       output_file.capture(in, s);
@@ -1138,32 +1609,48 @@ run(input const& in, std::string const& filename)
       s.next_file_output_time = std::min(s.next_file_output_time, in.end_time);
     }
     while (s.time < s.next_file_output_time) {
-      if (in.output_to_command_line) {
+      if (output_to_command_line) {
         std::cout << "step " << s.n << " time " << double(s.time) << " dt " << double(s.max_stable_dt) << "\n";
       }
       time_integrator_step(in, s);
       if (in.enable_adapt && (s.n % 10 == 0)) {
         for (int i = 0; i < 4; ++i) {
           adapt(in, s);
+          renumber_mesh(in, s);
           resize_state(in, s);
           collect_element_sets(in, s);
           collect_node_sets(in, s);
+          collect_material_node_elements(in, s);
+          if (in.force_assembly == COLORED_SCATTER_FORCE_ASSEMBLY) color_elements(s);
           common_initialization_part1(in, s);
           common_initialization_part2(in, s);
         }
+        if (in.print_state_memory && output_to_command_line) print_state_memory(s, std::cout);
       }
       ++s.n;
     }
   }
   if (num_file_output_periods) {
-    if (in.output_to_command_line) {
+    if (output_to_command_line) {
       std::cout << "outputting last file n " << file_output_index << " time " << double(s.time) << "\n";
     }
     output_file.capture(in, s);
     output_file.write(in, file_output_index);
+    output_file.finish();
   }
-  if (in.output_to_command_line) {
-    std::cout << "final time " << double(s.time) << "\n";
+  if (distributed_rank() == 0) report_kernel_timings(output_to_command_line, in.kernel_timings_file);
+  // collective, so every rank calls it and not only the one that prints
+  if (in.output_to_command_line && distributed_size() > 1) report_halo_overlap(s);
+  if (output_to_command_line) std::cout << "final time " << double(s.time) << "\n";
+  if (in.print_memory_pools && output_to_command_line) {
+    auto const pool = hpc::device_pool().statistics();
+    std::cout << "device memory pool high-water mark " << pool.high_water_mark << " bytes, reuse rate "
+              << pool.reuse_rate() << "\n";
+#ifdef HPC_CUDA
+    auto const pinned = hpc::pinned_pool().statistics();
+    std::cout << "pinned memory pool high-water mark " << pinned.high_water_mark << " bytes, reuse rate "
+              << pinned.reuse_rate() << "\n";
+#endif
   }
 }
 
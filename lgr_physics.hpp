@@ -9,4 +9,8 @@ class state;
 void
 run(input const& in, std::string const& filename = "");
 
+// sets state::f to the internal force of the stresses alone, assembled the way input::force_assembly says
+void
+update_internal_force(input const& in, state& s);
+
 }  // namespace lgr
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <hpc_macros.hpp>
+#include <lgr_distributed.hpp>
 #include <lgr_state.hpp>
 
 namespace lgr {
@@ -14,8 +15,8 @@ update_c(state& s)
   auto const points_to_c   = s.c.begin();
   auto       functor       = [=] HPC_DEVICE(point_index const point) {
     auto const rho     = points_to_rho[point];
-    auto const K       = points_to_K[point];
-    auto const G       = points_to_G[point];
+    auto const K       = points_to_K[point].load();
+    auto const G       = points_to_G[point].load();
     auto const M       = K + (4.0 / 3.0) * G;
     auto const c       = sqrt(M / rho);
     points_to_c[point] = c;
@@ -26,9 +27,12 @@ update_c(state& s)
 HPC_NOINLINE inline void
 find_max_stable_dt(state& s)
 {
+  using dt_reference = decltype(s.element_dt)::const_reference;
   hpc::time<double> const init(std::numeric_limits<double>::max());
-  s.max_stable_dt = hpc::transform_reduce(
-      hpc::device_policy(), s.element_dt, init, hpc::minimum<hpc::time<double>>(), hpc::identity<hpc::time<double>>());
+  auto const              load = [=] HPC_DEVICE(dt_reference const dt) { return dt.load(); };
+  s.max_stable_dt =
+      hpc::transform_reduce(hpc::device_policy(), s.element_dt, init, hpc::minimum<hpc::time<double>>(), load);
+  s.max_stable_dt = global_minimum(s.max_stable_dt);
   assert(s.max_stable_dt < 1.0);
 }
 
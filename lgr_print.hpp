@@ -4,6 +4,7 @@
 #include <hpc_index.hpp>
 #include <hpc_matrix3x3.hpp>
 #include <hpc_symmetric3x3.hpp>
+#include <hpc_thread_pool.hpp>
 #include <hpc_vector3.hpp>
 #include <iostream>
 
@@ -57,4 +58,15 @@ operator<<(std::ostream& stream, hpc::symmetric3x3<Scalar> m)
   return stream;
 }
 
+inline std::ostream&
+operator<<(std::ostream& stream, hpc::scheduler_statistics const& statistics)
+{
+  for (std::size_t thread = 0; thread < statistics.chunks.size(); ++thread) {
+    stream << "thread " << thread << " chunks " << statistics.chunks[thread] << " steals " << statistics.steals[thread]
+           << " busy " << statistics.busy_seconds[thread] << " s\n";
+  }
+  stream << "imbalance (slowest / average busy time) " << statistics.imbalance() << "\n";
+  return stream;
+}
+
 }  // namespace lgr
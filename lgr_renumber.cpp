@@ -0,0 +1,294 @@
+#include <cstdint>
+#include <hpc_algorithm.hpp>
+#include <hpc_limits.hpp>
+#include <hpc_numeric.hpp>
+#include <lgr_input.hpp>
+#include <lgr_meshing.hpp>
+#include <lgr_renumber.hpp>
+#include <lgr_state.hpp>
+
+namespace lgr {
+
+constexpr int hilbert_bits = 18;
+
+class hilbert_grid
+{
+ public:
+  hpc::position<double> lower;
+  hpc::vector3<double>  cells_per_length;
+};
+
+// position along the Hilbert curve through a grid of 2^18 cells per axis, interleaved from Skilling's
+// transpose of the cell coordinates
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE std::uint64_t
+hilbert_key(std::uint32_t const x, std::uint32_t const y, std::uint32_t const z) noexcept
+{
+  std::uint32_t  X[3] = {x, y, z};
+  constexpr auto M    = std::uint32_t(1) << (hilbert_bits - 1);
+  for (auto Q = M; Q > 1; Q >>= 1) {
+    auto const P = Q - 1;
+    for (int i = 0; i < 3; ++i) {
+      if (X[i] & Q) {
+        X[0] ^= P;
+      } else {
+        auto const t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  X[1] ^= X[0];
+  X[2] ^= X[1];
+  std::uint32_t t = 0;
+  for (auto Q = M; Q > 1; Q >>= 1) {
+    if (X[2] & Q) t ^= Q - 1;
+  }
+  std::uint64_t key = 0;
+  for (int bit = hilbert_bits - 1; bit >= 0; --bit) {
+    for (int i = 0; i < 3; ++i) {
+      key = (key << 1) | std::uint64_t(((X[i] ^ t) >> bit) & 1u);
+    }
+  }
+  return key;
+}
+
+// materials are kept apart, each along its own stretch of the curve, so that the per-material loops stay dense
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE std::uint64_t
+hilbert_key(hilbert_grid const grid, material_index const material, hpc::position<double> const x) noexcept
+{
+  std::uint32_t cell[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    cell[axis] = std::uint32_t(double(x(axis) - grid.lower(axis)) * grid.cells_per_length(axis));
+  }
+  return (std::uint64_t(hpc::weaken(material)) << (3 * hilbert_bits)) | hilbert_key(cell[0], cell[1], cell[2]);
+}
+
+// the lowest material of the set, which is a material of an element around the node
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE material_index
+first_material(material_set const set) noexcept
+{
+  auto const bits = std::uint64_t(set);
+  return material_index(bits == 0 ? 0 : popcount((bits & (~bits + 1)) - 1));
+}
+
+HPC_NOINLINE inline hilbert_grid
+bounding_grid(state const& s)
+{
+  auto const   nodes_to_x = s.x.cbegin();
+  hilbert_grid grid;
+  for (int axis = 0; axis < 3; ++axis) {
+    auto coordinate  = [=] HPC_DEVICE(node_index const node) { return double(nodes_to_x[node].load()(axis)); };
+    auto const lower = hpc::transform_reduce(
+        hpc::device_policy(), s.nodes, hpc::numeric_limits<double>::max(), hpc::minimum<double>(), coordinate);
+    auto const upper = hpc::transform_reduce(
+        hpc::device_policy(), s.nodes, -hpc::numeric_limits<double>::max(), hpc::maximum<double>(), coordinate);
+    // the upper bound falls just inside the last cell
+    auto const cells            = double((std::uint32_t(1) << hilbert_bits) - 1);
+    grid.lower(axis)            = lower;
+    grid.cells_per_length(axis) = (upper > lower) ? (cells / (upper - lower)) : 0.0;
+  }
+  return grid;
+}
+
+// \return the permutation from new to old indices that sorts \p keys, which are consumed
+template <class Index>
+HPC_NOINLINE hpc::device_vector<Index, Index>
+order_by_keys(hpc::device_vector<std::uint64_t, Index>& keys)
+{
+  hpc::device_vector<Index, Index> new_to_old(keys.size());
+  hpc::copy(hpc::device_policy(), hpc::counting_range<Index>(keys.size()), new_to_old);
+  hpc::sort_by_key(hpc::device_policy(), keys, new_to_old);
+  return new_to_old;
+}
+
+template <class Index>
+HPC_NOINLINE hpc::device_vector<Index, Index>
+invert_permutation(hpc::device_vector<Index, Index> const& new_to_old)
+{
+  hpc::device_vector<Index, Index> old_to_new(new_to_old.size());
+  auto const                       new_to_old_begin = new_to_old.cbegin();
+  auto const                       old_to_new_begin = old_to_new.begin();
+  auto                             functor          = [=] HPC_DEVICE(Index const new_index) {
+    old_to_new_begin[new_to_old_begin[new_index]] = new_index;
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<Index>(new_to_old.size()), functor);
+  return old_to_new;
+}
+
+// Moves each block of \p block_size consecutive values of \p data to the place of its new index. Data that is
+// not sized for the current mesh holds nothing yet, or is stale and about to be resized, so it is left alone.
+template <class Index, class Range>
+HPC_NOINLINE void
+permute_data(hpc::device_vector<Index, Index> const& new_to_old, int const block_size, Range& data)
+{
+  using data_index = typename Range::size_type;
+  using value_type = typename Range::value_type;
+  if (hpc::weaken(data.size()) != hpc::weaken(new_to_old.size()) * block_size) return;
+  Range      new_data(data.size());
+  auto const new_to_old_begin = new_to_old.cbegin();
+  auto const old_data_begin   = data.cbegin();
+  auto const new_data_begin   = new_data.begin();
+  auto       functor          = [=] HPC_DEVICE(Index const new_index) {
+    auto const old_index = new_to_old_begin[new_index];
+    for (int i = 0; i < block_size; ++i) {
+      auto const old_value = value_type(old_data_begin[data_index(hpc::weaken(old_index) * block_size + i)]);
+      new_data_begin[data_index(hpc::weaken(new_index) * block_size + i)] = old_value;
+    }
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<Index>(new_to_old.size()), functor);
+  data = std::move(new_data);
+}
+
+template <class Index, class Range, class MaterialIndex>
+void
+permute_data(
+    hpc::device_vector<Index, Index> const& new_to_old,
+    int const                               block_size,
+    hpc::host_vector<Range, MaterialIndex>& material_data)
+{
+  for (auto& data : material_data) permute_data(new_to_old, block_size, data);
+}
+
+HPC_NOINLINE inline void
+renumber_elements_to_nodes(
+    state&                                                  s,
+    hpc::device_vector<element_index, element_index> const& new_elements_to_old_elements,
+    hpc::device_vector<node_index, node_index> const&       old_nodes_to_new_nodes)
+{
+  hpc::device_vector<node_index, element_node_index> new_element_nodes_to_nodes(s.elements_to_nodes.size());
+  auto const elements_to_element_nodes  = s.elements * s.nodes_in_element;
+  auto const nodes_in_element           = s.nodes_in_element;
+  auto const new_to_old_elements        = new_elements_to_old_elements.cbegin();
+  auto const old_to_new_nodes           = old_nodes_to_new_nodes.cbegin();
+  auto const old_element_nodes_to_nodes = s.elements_to_nodes.cbegin();
+  auto const element_nodes_to_new_nodes = new_element_nodes_to_nodes.begin();
+  auto       functor                    = [=] HPC_DEVICE(element_index const new_element) {
+    auto const new_element_nodes = elements_to_element_nodes[new_element];
+    auto const old_element_nodes = elements_to_element_nodes[new_to_old_elements[new_element]];
+    for (auto const node_in_element : nodes_in_element) {
+      node_index const old_node = old_element_nodes_to_nodes[old_element_nodes[node_in_element]];
+      element_nodes_to_new_nodes[new_element_nodes[node_in_element]] = old_to_new_nodes[old_node];
+    }
+  };
+  hpc::for_each(hpc::device_policy(), s.elements, functor);
+  s.elements_to_nodes = std::move(new_element_nodes_to_nodes);
+}
+
+HPC_NOINLINE inline hpc::device_vector<std::uint64_t, element_index>
+hilbert_element_keys(state const& s, hilbert_grid const grid, bool const by_material)
+{
+  hpc::device_vector<std::uint64_t, element_index> element_keys(s.elements.size());
+  auto const   nodes_to_x                = s.x.cbegin();
+  auto const   elements_to_material      = s.material.cbegin();
+  auto const   elements_to_element_nodes = s.elements * s.nodes_in_element;
+  auto const   element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
+  auto const   elements_to_keys          = element_keys.begin();
+  double const N                         = 1.0 / double(hpc::weaken(s.nodes_in_element.size()));
+  auto         functor                   = [=] HPC_DEVICE(element_index const element) {
+    auto centroid = hpc::position<double>::zero();
+    for (auto const element_node : elements_to_element_nodes[element]) {
+      centroid = centroid + nodes_to_x[element_nodes_to_nodes[element_node]].load();
+    }
+    material_index const material = by_material ? elements_to_material[element] : material_index(0);
+    elements_to_keys[element]     = hilbert_key(grid, material, centroid * N);
+  };
+  hpc::for_each(hpc::device_policy(), s.elements, functor);
+  return element_keys;
+}
+
+// Numbers nodes along a Hilbert curve through their positions and elements along it through their centroids,
+// material by material, so that neighbors in space are neighbors in memory. The nodal, element, point and
+// point-node fields sized for the mesh are permuted with it and the node-to-element connectivity is rebuilt;
+// as after adapt(), the caller collects the sets and colors again.
+HPC_NOINLINE inline void
+hilbert_renumber(state& s)
+{
+  auto const grid                  = bounding_grid(s);
+  auto const nodes_to_x            = s.x.cbegin();
+  auto const has_nodal_materials   = (s.nodal_materials.size() == s.nodes.size());
+  auto const has_element_materials = (s.material.size() == s.elements.size());
+  auto const nodes_to_materials    = s.nodal_materials.cbegin();
+  hpc::device_vector<std::uint64_t, node_index> node_keys(s.nodes.size());
+  auto const                                    nodes_to_keys = node_keys.begin();
+  auto                                          node_functor  = [=] HPC_DEVICE(node_index const node) {
+    auto const material = has_nodal_materials ? first_material(nodes_to_materials[node]) : material_index(0);
+    nodes_to_keys[node] = hilbert_key(grid, material, nodes_to_x[node].load());
+  };
+  hpc::for_each(hpc::device_policy(), s.nodes, node_functor);
+  auto       element_keys                 = hilbert_element_keys(s, grid, has_element_materials);
+  auto const new_nodes_to_old_nodes       = order_by_keys(node_keys);
+  auto const new_elements_to_old_elements = order_by_keys(element_keys);
+  auto const old_nodes_to_new_nodes       = invert_permutation(new_nodes_to_old_nodes);
+  renumber_elements_to_nodes(s, new_elements_to_old_elements, old_nodes_to_new_nodes);
+  auto const& n = new_nodes_to_old_nodes;
+  permute_data(n, 1, s.x);
+  permute_data(n, 1, s.u);
+  permute_data(n, 1, s.v);
+  permute_data(n, 1, s.f);
+  permute_data(n, 1, s.mass);
+  permute_data(n, 1, s.a);
+  permute_data(n, 1, s.nodal_materials);
+  permute_data(n, 1, s.h_adapt);
+  permute_data(n, 1, s.p_h_dot);
+  permute_data(n, 1, s.p_h);
+  permute_data(n, 1, s.K_h);
+  permute_data(n, 1, s.material_mass);
+  permute_data(n, 1, s.e_h);
+  permute_data(n, 1, s.e_h_dot);
+  permute_data(n, 1, s.rho_h);
+  permute_data(n, 1, s.dp_de_h);
+  permute_data(n, 1, s.global_nodes);
+  permute_data(n, 1, s.node_owners);
+  auto const& e = new_elements_to_old_elements;
+  permute_data(e, 1, s.material);
+  permute_data(e, 1, s.quality);
+  permute_data(e, 1, s.h_min);
+  permute_data(e, 1, s.h_art);
+  auto const points = int(hpc::weaken(s.points_in_element.size()));
+  permute_data(e, points, s.V);
+  permute_data(e, points, s.F_total);
+  permute_data(e, points, s.sigma_full);
+  permute_data(e, points, s.sigma);
+  permute_data(e, points, s.symm_grad_v);
+  permute_data(e, points, s.p);
+  permute_data(e, points, s.v_prime);
+  permute_data(e, points, s.p_prime);
+  permute_data(e, points, s.q);
+  permute_data(e, points, s.K);
+  permute_data(e, points, s.G);
+  permute_data(e, points, s.c);
+  permute_data(e, points, s.rho);
+  permute_data(e, points, s.dp_de);
+  permute_data(e, points, s.e);
+  permute_data(e, points, s.rho_e_dot);
+  permute_data(e, points, s.nu_art);
+  permute_data(e, points, s.element_dt);
+  permute_data(e, points, s.JavgJ);
+  permute_data(e, points, s.Fp_total);
+  permute_data(e, points, s.temp);
+  permute_data(e, points, s.ep);
+  auto const point_nodes = points * int(hpc::weaken(s.nodes_in_element.size()));
+  permute_data(e, point_nodes, s.N);
+  permute_data(e, point_nodes, s.grad_N);
+  permute_data(e, point_nodes, s.W);
+  permute_data(e, point_nodes, s.element_f);
+  propagate_connectivity(s);
+}
+
+hpc::device_vector<element_index, element_index>
+hilbert_element_order(state const& s)
+{
+  auto element_keys = hilbert_element_keys(s, bounding_grid(s), false);
+  return order_by_keys(element_keys);
+}
+
+void
+renumber_mesh(input const& in, state& s)
+{
+  switch (in.mesh_ordering) {
+    case INPUT_MESH_ORDERING: break;
+    case HILBERT_MESH_ORDERING: hilbert_renumber(s); break;
+  }
+}
+
+}  // namespace lgr
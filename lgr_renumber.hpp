@@ -0,0 +1,18 @@
+#pragma once
+
+#include <hpc_vector.hpp>
+#include <lgr_mesh_indices.hpp>
+
+namespace lgr {
+
+class input;
+class state;
+
+void
+renumber_mesh(input const& in, state& s);
+
+// the elements in the order of their centroids along a Hilbert curve, regardless of their materials
+hpc::device_vector<element_index, element_index>
+hilbert_element_order(state const& s);
+
+}  // namespace lgr
@@ -1,6 +1,11 @@
+#include <cassert>
+#include <lgr_basis_gradients.hpp>
+#include <lgr_distributed.hpp>
 #include <lgr_input.hpp>
 #include <lgr_stabilized.hpp>
 #include <lgr_state.hpp>
+#include <lgr_state_fields.hpp>
+#include <lgr_timers.hpp>
 
 namespace lgr {
 
@@ -10,6 +15,27 @@ get_N(state& s)
   return 1.0 / double(hpc::weaken(s.nodes_in_element.size()));
 }
 
+inline material_set
+enabled_materials(input const& in, hpc::host_vector<bool, material_index> const& enabled)
+{
+  auto materials = material_set::none();
+  for (auto const material : in.materials) {
+    if (enabled[material]) materials = materials | material_set(material);
+  }
+  return materials;
+}
+
+// The fused nodal kernels accumulate each node's sums into local arrays with one entry per fused material, so they
+// handle at most this many materials and leave more to the per-material kernels.
+constexpr int max_fused_materials = 8;
+
+// \return the entry of \p material among the local accumulators of the \p fused materials
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE int
+fused_slot(material_set const fused, material_index const material)
+{
+  return popcount(std::uint64_t(fused) & ((std::uint64_t(1) << hpc::weaken(material)) - 1));
+}
+
 void
 update_p_h(
     state&                                                       s,
@@ -82,12 +108,13 @@ update_sigma_with_p_h(state& s, material_index const material)
 HPC_NOINLINE inline void
 update_v_prime0(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_v_prime0", "elements", s.element_sets[material].size());
+  assert(has_fields(s, nodal_pressure_fields));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const elements_to_points        = s.elements * s.points_in_element;
-  auto const points_to_point_nodes     = s.points * s.nodes_in_element;
   auto const nodes_in_element          = s.nodes_in_element;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
-  auto const point_nodes_to_grad_N     = s.grad_N.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
   auto const points_to_dt              = s.element_dt.cbegin();
   auto const points_to_rho             = s.rho.cbegin();
   auto const nodes_to_a                = s.a.cbegin();
@@ -101,17 +128,16 @@ update_v_prime0(input const& in, state& s, material_index const material)
   auto       functor                   = [=] HPC_DEVICE(element_index const element) {
     auto const element_nodes = elements_to_element_nodes[element];
     for (auto const point : elements_to_points[element]) {
-      auto const point_nodes = points_to_point_nodes[point];
-      auto const point_dt    = use_global_tau == true ? global_dt : points_to_dt[point];
-      auto const tau         = c_tau * point_dt;
-      auto       grad_p      = hpc::pressure_gradient<double>::zero();
-      auto       a           = hpc::acceleration<double>::zero();
+      auto const point_grad_N = points_to_grad_N(element, point);
+      auto const point_dt     = use_global_tau == true ? global_dt : points_to_dt[point].load();
+      auto const tau          = c_tau * point_dt;
+      auto       grad_p       = hpc::pressure_gradient<double>::zero();
+      auto       a            = hpc::acceleration<double>::zero();
       for (auto const node_in_element : nodes_in_element) {
         auto const element_node = element_nodes[node_in_element];
-        auto const point_node   = point_nodes[node_in_element];
         auto const node         = element_nodes_to_nodes[element_node];
         auto const p_h          = nodes_to_p_h[node];
-        auto const grad_N       = point_nodes_to_grad_N[point_node].load();
+        auto const grad_N       = point_grad_N[node_in_element];
         grad_p                  = grad_p + (grad_N * p_h);
         auto const a_of_node    = nodes_to_a[node].load();
         a                       = a + a_of_node;
@@ -128,12 +154,13 @@ update_v_prime0(input const& in, state& s, material_index const material)
 HPC_NOINLINE inline void
 update_v_prime(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_v_prime", "elements", s.element_sets[material].size());
+  assert(has_fields(s, nodal_pressure_fields));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const elements_to_points        = s.elements * s.points_in_element;
-  auto const points_to_point_nodes     = s.points * s.nodes_in_element;
   auto const nodes_in_element          = s.nodes_in_element;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
-  auto const point_nodes_to_grad_N     = s.grad_N.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
   auto const points_to_dt              = s.element_dt.cbegin();
   auto const points_to_rho             = s.rho.cbegin();
   auto const points_to_sigma           = s.sigma.cbegin();
@@ -147,17 +174,16 @@ update_v_prime(input const& in, state& s, material_index const material)
   auto       functor                   = [=] HPC_DEVICE(element_index const element) {
     auto const element_nodes = elements_to_element_nodes[element];
     for (auto const point : elements_to_points[element]) {
-      auto const point_nodes = points_to_point_nodes[point];
-      auto const point_dt    = use_global_tau == true ? global_dt : points_to_dt[point];
-      auto const tau         = c_tau * point_dt;
-      auto const sigma       = points_to_sigma[point].load();
-      auto       div_sigma   = hpc::pressure_gradient<double>::zero();
-      auto       a           = hpc::acceleration<double>::zero();
+      auto const point_grad_N = points_to_grad_N(element, point);
+      auto const point_dt     = use_global_tau == true ? global_dt : points_to_dt[point].load();
+      auto const tau          = c_tau * point_dt;
+      auto const sigma        = points_to_sigma[point].load();
+      auto       div_sigma    = hpc::pressure_gradient<double>::zero();
+      auto       a            = hpc::acceleration<double>::zero();
       for (auto const node_in_element : nodes_in_element) {
         auto const element_node = element_nodes[node_in_element];
-        auto const point_node   = point_nodes[node_in_element];
         auto const node         = element_nodes_to_nodes[element_node];
-        auto const grad_N       = point_nodes_to_grad_N[point_node].load();
+        auto const grad_N       = point_grad_N[node_in_element];
         div_sigma               = div_sigma + (sigma * grad_N);
         auto const a_of_node    = nodes_to_a[node].load();
         a                       = a + a_of_node;
@@ -179,6 +205,8 @@ update_p_prime(
     hpc::time<double> const                                      dt,
     hpc::device_vector<hpc::pressure<double>, node_index> const& old_p_h_vector)
 {
+  LGR_TIME_KERNEL("update_p_prime", "elements", s.element_sets[material].size());
+  assert(has_fields(s, p_prime_fields));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const elements_to_points        = s.elements * s.points_in_element;
   auto const nodes_in_element          = s.nodes_in_element;
@@ -197,7 +225,7 @@ update_p_prime(
   auto       functor                   = [=] HPC_DEVICE(element_index const element) {
     auto const element_nodes = elements_to_element_nodes[element];
     for (auto const point : elements_to_points[element]) {
-      auto const                 point_dt    = use_global_tau == true ? global_dt : points_to_dt[point];
+      auto const                 point_dt    = use_global_tau == true ? global_dt : points_to_dt[point].load();
       auto const                 tau         = c_tau * point_dt;
       auto const                 symm_grad_v = points_to_symm_grad_v[point].load();
       auto const                 div_v       = trace(symm_grad_v);
@@ -215,7 +243,7 @@ update_p_prime(
         }
         p_dot = (p - old_p) / dt;
       }
-      auto const K             = points_to_K[point];
+      auto const K             = points_to_K[point].load();
       auto const p_prime       = c_p * tau * (K * div_v - p_dot);
       points_to_p_prime[point] = p_prime;
     }
@@ -263,12 +291,13 @@ update_sigma_with_p_h_p_prime(
 HPC_NOINLINE inline void
 update_q0(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_q0", "elements", s.element_sets[material].size());
+  assert(has_fields(s, nodal_energy_fields));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const elements_to_points        = s.elements * s.points_in_element;
-  auto const points_to_point_nodes     = s.points * s.nodes_in_element;
   auto const nodes_in_element          = s.nodes_in_element;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
-  auto const point_nodes_to_grad_N     = s.grad_N.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
   auto const points_to_dt              = s.element_dt.cbegin();
   auto const points_to_rho             = s.rho.cbegin();
   auto const nodes_to_a                = s.a.cbegin();
@@ -285,20 +314,19 @@ update_q0(input const& in, state& s, material_index const material)
   auto       functor                   = [=] HPC_DEVICE(element_index const element) {
     auto const element_nodes = elements_to_element_nodes[element];
     for (auto const point : elements_to_points[element]) {
-      auto const            point_dt    = use_global_tau == true ? global_dt : points_to_dt[point];
-      auto const            tau         = c_tau * point_dt;
-      auto                  grad_p      = hpc::pressure_gradient<double>::zero();
-      auto                  a           = hpc::acceleration<double>::zero();
-      hpc::pressure<double> p_h         = 0.0;
-      dp_de_t               dp_de       = 0.0;
-      auto const            point_nodes = points_to_point_nodes[point];
+      auto const            point_dt     = use_global_tau == true ? global_dt : points_to_dt[point].load();
+      auto const            tau          = c_tau * point_dt;
+      auto                  grad_p       = hpc::pressure_gradient<double>::zero();
+      auto                  a            = hpc::acceleration<double>::zero();
+      hpc::pressure<double> p_h          = 0.0;
+      dp_de_t               dp_de        = 0.0;
+      auto const            point_grad_N = points_to_grad_N(element, point);
       for (auto const node_in_element : nodes_in_element) {
         auto const element_node = element_nodes[node_in_element];
-        auto const point_node   = point_nodes[node_in_element];
         auto const node         = element_nodes_to_nodes[element_node];
         auto const p_h_of_node  = nodes_to_p_h[node];
         p_h                     = p_h + p_h_of_node;
-        auto const grad_N       = point_nodes_to_grad_N[point_node].load();
+        auto const grad_N       = point_grad_N[node_in_element];
         grad_p                  = grad_p + (grad_N * p_h_of_node);
         auto const a_of_node    = nodes_to_a[node].load();
         a                       = a + a_of_node;
@@ -309,7 +337,7 @@ update_q0(input const& in, state& s, material_index const material)
       p_h                = p_h * N;
       dp_de              = enable_eos == true ? points_to_dp_de[point] : dp_de * N;
       auto const rho     = points_to_rho[point];
-      auto const K       = points_to_K[point];
+      auto const K       = points_to_K[point].load();
       auto const q       = -(tau * K / dp_de) * (rho * a + grad_p);
       points_to_q[point] = q;
     }
@@ -320,12 +348,13 @@ update_q0(input const& in, state& s, material_index const material)
 HPC_NOINLINE inline void
 update_q(input const& in, state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_q", "elements", s.element_sets[material].size());
+  assert(has_fields(s, nodal_energy_fields));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const elements_to_points        = s.elements * s.points_in_element;
-  auto const points_to_point_nodes     = s.points * s.nodes_in_element;
   auto const nodes_in_element          = s.nodes_in_element;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
-  auto const point_nodes_to_grad_N     = s.grad_N.cbegin();
+  auto const points_to_grad_N          = basis_gradients(s);
   auto const points_to_dt              = s.element_dt.cbegin();
   auto const points_to_rho             = s.rho.cbegin();
   auto const points_to_sigma           = s.sigma.cbegin();
@@ -342,18 +371,17 @@ update_q(input const& in, state& s, material_index const material)
   auto       functor                   = [=] HPC_DEVICE(element_index const element) {
     auto const element_nodes = elements_to_element_nodes[element];
     for (auto const point : elements_to_points[element]) {
-      auto const point_dt    = use_global_tau == true ? global_dt : points_to_dt[point];
-      auto const tau         = c_tau * point_dt;
-      auto       a           = hpc::acceleration<double>::zero();
-      dp_de_t    dp_de       = 0.0;
-      auto const point_nodes = points_to_point_nodes[point];
-      auto const sigma       = points_to_sigma[point].load();
-      auto       div_sigma   = hpc::pressure_gradient<double>::zero();
+      auto const point_dt     = use_global_tau == true ? global_dt : points_to_dt[point].load();
+      auto const tau          = c_tau * point_dt;
+      auto       a            = hpc::acceleration<double>::zero();
+      dp_de_t    dp_de        = 0.0;
+      auto const point_grad_N = points_to_grad_N(element, point);
+      auto const sigma        = points_to_sigma[point].load();
+      auto       div_sigma    = hpc::pressure_gradient<double>::zero();
       for (auto const node_in_element : nodes_in_element) {
         auto const element_node = element_nodes[node_in_element];
-        auto const point_node   = point_nodes[node_in_element];
         auto const node         = element_nodes_to_nodes[element_node];
-        auto const grad_N       = point_nodes_to_grad_N[point_node].load();
+        auto const grad_N       = point_grad_N[node_in_element];
         div_sigma               = div_sigma + (sigma * grad_N);
         auto const a_of_node    = nodes_to_a[node].load();
         a                       = a + a_of_node;
@@ -363,7 +391,7 @@ update_q(input const& in, state& s, material_index const material)
       a                  = a * N;
       dp_de              = enable_eos == true ? points_to_dp_de[point] : dp_de * N;
       auto const rho     = points_to_rho[point];
-      auto const K       = points_to_K[point];
+      auto const K       = points_to_K[point].load();
       auto const q       = -(tau * K / dp_de) * (rho * a - div_sigma);
       points_to_q[point] = q;
     }
@@ -374,25 +402,30 @@ update_q(input const& in, state& s, material_index const material)
 HPC_NOINLINE inline void
 update_p_h_W(state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_p_h_W", "elements", s.element_sets[material].size());
+  assert(has_fields(s, nodal_pressure_fields));
   auto const points_to_K           = s.K.cbegin();
   auto const points_to_v_prime     = s.v_prime.cbegin();
   auto const points_to_V           = s.V.cbegin();
   auto const points_to_symm_grad_v = s.symm_grad_v.cbegin();
-  auto const point_nodes_to_grad_N = s.grad_N.cbegin();
+  auto const points_to_grad_N      = basis_gradients(s);
   auto const point_nodes_to_W      = s.W.begin();
   auto const N                     = get_N(s);
   auto const points_to_point_nodes = s.points * s.nodes_in_element;
   auto const elements_to_points    = s.elements * s.points_in_element;
+  auto const nodes_in_element      = s.nodes_in_element;
   auto       functor               = [=] HPC_DEVICE(element_index const element) {
     for (auto const point : elements_to_points[element]) {
-      auto const symm_grad_v = points_to_symm_grad_v[point].load();
-      auto const div_v       = trace(symm_grad_v);
-      auto const K           = points_to_K[point];
-      auto const V           = points_to_V[point];
-      auto const v_prime     = points_to_v_prime[point].load();
-      auto const point_nodes = points_to_point_nodes[point];
-      for (auto const point_node : point_nodes) {
-        auto const grad_N            = point_nodes_to_grad_N[point_node].load();
+      auto const symm_grad_v  = points_to_symm_grad_v[point].load();
+      auto const div_v        = trace(symm_grad_v);
+      auto const K            = points_to_K[point].load();
+      auto const V            = points_to_V[point];
+      auto const v_prime      = points_to_v_prime[point].load();
+      auto const point_nodes  = points_to_point_nodes[point];
+      auto const point_grad_N = points_to_grad_N(element, point);
+      for (auto const node_in_element : nodes_in_element) {
+        auto const point_node        = point_nodes[node_in_element];
+        auto const grad_N            = point_grad_N[node_in_element];
         auto const p_h_dot           = -(N * (K * div_v)) + (grad_N * (K * v_prime));
         auto const W                 = p_h_dot * V;
         point_nodes_to_W[point_node] = W;
@@ -405,22 +438,27 @@ update_p_h_W(state& s, material_index const material)
 HPC_NOINLINE inline void
 update_e_h_W(state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_e_h_W", "elements", s.element_sets[material].size());
+  assert(has_fields(s, nodal_energy_fields));
   auto const points_to_q           = s.q.cbegin();
   auto const points_to_V           = s.V.cbegin();
   auto const points_to_rho_e_dot   = s.rho_e_dot.cbegin();
-  auto const point_nodes_to_grad_N = s.grad_N.cbegin();
+  auto const points_to_grad_N      = basis_gradients(s);
   auto const point_nodes_to_W      = s.W.begin();
   auto const N                     = get_N(s);
   auto const points_to_point_nodes = s.points * s.nodes_in_element;
   auto const elements_to_points    = s.elements * s.points_in_element;
+  auto const nodes_in_element      = s.nodes_in_element;
   auto       functor               = [=] HPC_DEVICE(element_index const element) {
     for (auto const point : elements_to_points[element]) {
-      auto const rho_e_dot   = points_to_rho_e_dot[point];
-      auto const V           = points_to_V[point];
-      auto const q           = points_to_q[point].load();
-      auto const point_nodes = points_to_point_nodes[point];
-      for (auto const point_node : point_nodes) {
-        auto const grad_N            = point_nodes_to_grad_N[point_node].load();
+      auto const rho_e_dot    = points_to_rho_e_dot[point];
+      auto const V            = points_to_V[point];
+      auto const q            = points_to_q[point].load();
+      auto const point_nodes  = points_to_point_nodes[point];
+      auto const point_grad_N = points_to_grad_N(element, point);
+      for (auto const node_in_element : nodes_in_element) {
+        auto const point_node        = point_nodes[node_in_element];
+        auto const grad_N            = point_grad_N[node_in_element];
         auto const rho_e_h_dot       = (N * rho_e_dot) + (grad_N * q);
         auto const W                 = rho_e_h_dot * V;
         point_nodes_to_W[point_node] = W;
@@ -433,24 +471,23 @@ update_e_h_W(state& s, material_index const material)
 HPC_NOINLINE inline void
 update_p_h_dot(state& s, material_index const material)
 {
-  auto const nodes_to_node_elements            = s.nodes_to_node_elements.cbegin();
-  auto const node_elements_to_elements         = s.node_elements_to_elements.cbegin();
-  auto const node_elements_to_nodes_in_element = s.node_elements_to_nodes_in_element.cbegin();
+  LGR_TIME_KERNEL("update_p_h_dot", "nodes", s.node_sets[material].size());
+  auto const set_nodes_to_nodes                = s.node_sets[material].cbegin();
+  auto const set_nodes_to_node_elements        = s.material_nodes_to_node_elements[material].cbegin();
+  auto const node_elements_to_elements         = s.material_node_elements_to_elements[material].cbegin();
+  auto const node_elements_to_nodes_in_element = s.material_node_elements_to_nodes_in_element[material].cbegin();
   auto const point_nodes_to_W                  = s.W.cbegin();
   auto const points_to_V                       = s.V.cbegin();
   auto const nodes_to_p_h_dot                  = s.p_h_dot[material].begin();
   auto const elements_to_points                = s.elements * s.points_in_element;
   auto const points_to_point_nodes             = s.points * s.nodes_in_element;
-  auto const elements_to_material              = s.material.cbegin();
   auto const N                                 = get_N(s);
-  auto       functor                           = [=] HPC_DEVICE(node_index const node) {
+  auto       functor                           = [=] HPC_DEVICE(int const set_node) {
     hpc::power<double>  node_W        = 0.0;
     hpc::volume<double> node_V        = 0.0;
-    auto const          node_elements = nodes_to_node_elements[node];
+    auto const          node_elements = set_nodes_to_node_elements[set_node];
     for (auto const node_element : node_elements) {
-      auto const           element          = node_elements_to_elements[node_element];
-      material_index const element_material = elements_to_material[element];
-      if (element_material != material) continue;
+      auto const element         = node_elements_to_elements[node_element];
       auto const node_in_element = node_elements_to_nodes_in_element[node_element];
       for (auto const point : elements_to_points[element]) {
         auto const point_nodes = points_to_point_nodes[point];
@@ -461,44 +498,155 @@ update_p_h_dot(state& s, material_index const material)
         node_V                 = node_V + (N * V);
       }
     }
-    auto const p_h_dot     = node_W / node_V;
-    nodes_to_p_h_dot[node] = p_h_dot;
+    node_index const node    = set_nodes_to_nodes[set_node];
+    auto const       p_h_dot = node_W / node_V;
+    nodes_to_p_h_dot[node]   = p_h_dot;
   };
-  hpc::for_each(hpc::device_policy(), s.node_sets[material], functor);
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(s.node_sets[material].size()), functor);
 }
 
 HPC_NOINLINE inline void
 update_e_h_dot(state& s, material_index const material)
 {
+  LGR_TIME_KERNEL("update_e_h_dot", "nodes", s.node_sets[material].size());
+  auto const set_nodes_to_nodes                = s.node_sets[material].cbegin();
+  auto const set_nodes_to_node_elements        = s.material_nodes_to_node_elements[material].cbegin();
+  auto const node_elements_to_elements         = s.material_node_elements_to_elements[material].cbegin();
+  auto const node_elements_to_nodes_in_element = s.material_node_elements_to_nodes_in_element[material].cbegin();
+  auto const point_nodes_to_W                  = s.W.cbegin();
+  auto const nodes_to_e_h_dot                  = s.e_h_dot[material].begin();
+  auto const elements_to_points                = s.elements * s.points_in_element;
+  auto const points_to_point_nodes             = s.points * s.nodes_in_element;
+  auto const nodes_to_m                        = s.material_mass[material].cbegin();
+  auto       functor                           = [=] HPC_DEVICE(int const set_node) {
+    hpc::power<double> node_W        = 0.0;
+    auto const         node_elements = set_nodes_to_node_elements[set_node];
+    for (auto const node_element : node_elements) {
+      element_index const         element         = node_elements_to_elements[node_element];
+      node_in_element_index const node_in_element = node_elements_to_nodes_in_element[node_element];
+      for (auto const point : elements_to_points[element]) {
+        auto const point_nodes = points_to_point_nodes[point];
+        auto const point_node  = point_nodes[node_in_element];
+        auto const W           = point_nodes_to_W[point_node];
+        node_W                 = node_W + W;
+      }
+    }
+    node_index const node    = set_nodes_to_nodes[set_node];
+    auto const       m       = nodes_to_m[node];
+    auto const       e_h_dot = node_W / m;
+    nodes_to_e_h_dot[node]   = e_h_dot;
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(s.node_sets[material].size()), functor);
+}
+
+// The fused kernels below update every material that needs them in one sweep over the nodes. A node walks its
+// adjacent elements once, summing each element into the accumulators of that element's material.
+HPC_NOINLINE inline void
+update_p_h_dot(input const& in, state& s)
+{
+  auto const fused_materials = enabled_materials(in, in.enable_nodal_pressure);
+  if (fused_materials.size() > max_fused_materials) {
+    for (auto const material : in.materials) {
+      if (in.enable_nodal_pressure[material]) update_p_h_dot(s, material);
+    }
+    return;
+  }
+  LGR_TIME_KERNEL("fused_update_p_h_dot", "nodes", s.nodes.size());
+  auto const materials_to_p_h_dot              = s.p_h_dot_table.update(s.p_h_dot).cbegin();
+  auto const materials                         = in.materials;
+  auto const nodes_to_materials                = s.nodal_materials.cbegin();
   auto const nodes_to_node_elements            = s.nodes_to_node_elements.cbegin();
   auto const node_elements_to_elements         = s.node_elements_to_elements.cbegin();
   auto const node_elements_to_nodes_in_element = s.node_elements_to_nodes_in_element.cbegin();
+  auto const elements_to_material              = s.material.cbegin();
   auto const point_nodes_to_W                  = s.W.cbegin();
-  auto const nodes_to_e_h_dot                  = s.e_h_dot[material].begin();
+  auto const points_to_V                       = s.V.cbegin();
   auto const elements_to_points                = s.elements * s.points_in_element;
   auto const points_to_point_nodes             = s.points * s.nodes_in_element;
-  auto const nodes_to_m                        = s.material_mass[material].cbegin();
+  auto const N                                 = get_N(s);
+  auto       functor                           = [=] HPC_DEVICE(node_index const node) {
+    hpc::power<double>  node_W[max_fused_materials];
+    hpc::volume<double> node_V[max_fused_materials];
+    for (int slot = 0; slot < max_fused_materials; ++slot) {
+      node_W[slot] = 0.0;
+      node_V[slot] = 0.0;
+    }
+    for (auto const node_element : nodes_to_node_elements[node]) {
+      element_index const  element          = node_elements_to_elements[node_element];
+      material_index const element_material = elements_to_material[element];
+      if (!fused_materials.contains(material_set(element_material))) continue;
+      auto const slot            = fused_slot(fused_materials, element_material);
+      auto const node_in_element = node_elements_to_nodes_in_element[node_element];
+      for (auto const point : elements_to_points[element]) {
+        auto const point_nodes = points_to_point_nodes[point];
+        auto const point_node  = point_nodes[node_in_element];
+        auto const W           = point_nodes_to_W[point_node];
+        auto const V           = points_to_V[point];
+        node_W[slot]           = node_W[slot] + W;
+        node_V[slot]           = node_V[slot] + (N * V);
+      }
+    }
+    auto const node_materials = nodes_to_materials[node];
+    for (auto const material : materials) {
+      if (!(fused_materials.contains(material_set(material)) && node_materials.contains(material_set(material)))) {
+        continue;
+      }
+      auto const slot                                   = fused_slot(fused_materials, material);
+      materials_to_p_h_dot[material][hpc::weaken(node)] = node_W[slot] / node_V[slot];
+    }
+  };
+  hpc::for_each(hpc::device_policy(), s.nodes, functor);
+}
+
+HPC_NOINLINE inline void
+update_e_h_dot(input const& in, state& s)
+{
+  auto const fused_materials = enabled_materials(in, in.enable_nodal_energy);
+  if (fused_materials.size() > max_fused_materials) {
+    for (auto const material : in.materials) {
+      if (in.enable_nodal_energy[material]) update_e_h_dot(s, material);
+    }
+    return;
+  }
+  LGR_TIME_KERNEL("fused_update_e_h_dot", "nodes", s.nodes.size());
+  auto const materials_to_e_h_dot              = s.e_h_dot_table.update(s.e_h_dot).cbegin();
+  auto const materials_to_m                    = s.material_mass_table.update(s.material_mass).cbegin();
+  auto const materials                         = in.materials;
+  auto const nodes_to_materials                = s.nodal_materials.cbegin();
+  auto const nodes_to_node_elements            = s.nodes_to_node_elements.cbegin();
+  auto const node_elements_to_elements         = s.node_elements_to_elements.cbegin();
+  auto const node_elements_to_nodes_in_element = s.node_elements_to_nodes_in_element.cbegin();
   auto const elements_to_material              = s.material.cbegin();
+  auto const point_nodes_to_W                  = s.W.cbegin();
+  auto const elements_to_points                = s.elements * s.points_in_element;
+  auto const points_to_point_nodes             = s.points * s.nodes_in_element;
   auto       functor                           = [=] HPC_DEVICE(node_index const node) {
-    hpc::power<double> node_W        = 0.0;
-    auto const         node_elements = nodes_to_node_elements[node];
-    for (auto const node_element : node_elements) {
+    hpc::power<double> node_W[max_fused_materials];
+    for (int slot = 0; slot < max_fused_materials; ++slot) node_W[slot] = 0.0;
+    for (auto const node_element : nodes_to_node_elements[node]) {
       element_index const  element          = node_elements_to_elements[node_element];
       material_index const element_material = elements_to_material[element];
-      if (element_material != material) continue;
+      if (!fused_materials.contains(material_set(element_material))) continue;
+      auto const                  slot            = fused_slot(fused_materials, element_material);
       node_in_element_index const node_in_element = node_elements_to_nodes_in_element[node_element];
       for (auto const point : elements_to_points[element]) {
         auto const point_nodes = points_to_point_nodes[point];
         auto const point_node  = point_nodes[node_in_element];
         auto const W           = point_nodes_to_W[point_node];
-        node_W                 = node_W + W;
+        node_W[slot]           = node_W[slot] + W;
       }
     }
-    auto const m           = nodes_to_m[node];
-    auto const e_h_dot     = node_W / m;
-    nodes_to_e_h_dot[node] = e_h_dot;
+    auto const node_materials = nodes_to_materials[node];
+    for (auto const material : materials) {
+      if (!(fused_materials.contains(material_set(material)) && node_materials.contains(material_set(material)))) {
+        continue;
+      }
+      auto const slot                                   = fused_slot(fused_materials, material);
+      auto const m                                      = materials_to_m[material][hpc::weaken(node)];
+      materials_to_e_h_dot[material][hpc::weaken(node)] = node_W[slot] / m;
+    }
   };
-  hpc::for_each(hpc::device_policy(), s.node_sets[material], functor);
+  hpc::for_each(hpc::device_policy(), s.nodes, functor);
 }
 
 void
@@ -530,31 +678,85 @@ nodal_ideal_gas(input const& in, state& s, material_index const material)
 void
 update_nodal_density(state& s, material_index const material)
 {
-  auto const nodes_to_node_elements    = s.nodes_to_node_elements.cbegin();
-  auto const node_elements_to_elements = s.node_elements_to_elements.cbegin();
-  auto const points_to_V               = s.V.cbegin();
-  auto const nodes_to_m                = s.material_mass[material].cbegin();
+  LGR_TIME_KERNEL("update_nodal_density", "nodes", s.node_sets[material].size());
+  auto const set_nodes_to_nodes         = s.node_sets[material].cbegin();
+  auto const set_nodes_to_node_elements = s.material_nodes_to_node_elements[material].cbegin();
+  auto const node_elements_to_elements  = s.material_node_elements_to_elements[material].cbegin();
+  auto const points_to_V                = s.V.cbegin();
+  auto const nodes_to_m                 = s.material_mass[material].cbegin();
   hpc::fill(hpc::device_policy(), s.rho_h[material], double(0.0));
-  auto const nodes_to_rho_h       = s.rho_h[material].begin();
-  auto const N                    = get_N(s);
-  auto const elements_to_points   = s.elements * s.points_in_element;
-  auto const elements_to_material = s.material.cbegin();
-  auto       functor              = [=] HPC_DEVICE(node_index const node) {
+  auto const nodes_to_rho_h     = s.rho_h[material].begin();
+  auto const N                  = get_N(s);
+  auto const elements_to_points = s.elements * s.points_in_element;
+  auto       functor            = [=] HPC_DEVICE(int const set_node) {
     hpc::volume<double> node_V(0.0);
-    auto const          node_elements = nodes_to_node_elements[node];
+    auto const          node_elements = set_nodes_to_node_elements[set_node];
     for (auto const node_element : node_elements) {
+      element_index const element = node_elements_to_elements[node_element];
+      for (auto const point : elements_to_points[element]) {
+        auto const V = points_to_V[point];
+        node_V       = node_V + (N * V);
+      }
+    }
+    node_index const node = set_nodes_to_nodes[set_node];
+    auto const       m    = nodes_to_m[node];
+    nodes_to_rho_h[node]  = m / node_V;
+  };
+  hpc::for_each(hpc::device_policy(), hpc::counting_range<int>(s.node_sets[material].size()), functor);
+  exchange_nodal_density(s, material);
+}
+
+void
+update_nodal_density(input const& in, state& s)
+{
+  auto const fused_materials = enabled_materials(in, in.enable_nodal_energy);
+  if (fused_materials.size() > max_fused_materials) {
+    for (auto const material : in.materials) {
+      if (in.enable_nodal_energy[material]) update_nodal_density(s, material);
+    }
+    return;
+  }
+  LGR_TIME_KERNEL("fused_update_nodal_density", "nodes", s.nodes.size());
+  for (auto const material : in.materials) {
+    if (in.enable_nodal_energy[material]) {
+      hpc::fill(hpc::device_policy(), s.rho_h[material], double(0.0));
+    }
+  }
+  auto const materials_to_rho_h        = s.rho_h_table.update(s.rho_h).cbegin();
+  auto const materials_to_m            = s.material_mass_table.update(s.material_mass).cbegin();
+  auto const materials                 = in.materials;
+  auto const nodes_to_materials        = s.nodal_materials.cbegin();
+  auto const nodes_to_node_elements    = s.nodes_to_node_elements.cbegin();
+  auto const node_elements_to_elements = s.node_elements_to_elements.cbegin();
+  auto const elements_to_material      = s.material.cbegin();
+  auto const points_to_V               = s.V.cbegin();
+  auto const elements_to_points        = s.elements * s.points_in_element;
+  auto const N                         = get_N(s);
+  auto       functor                   = [=] HPC_DEVICE(node_index const node) {
+    hpc::volume<double> node_V[max_fused_materials];
+    for (int slot = 0; slot < max_fused_materials; ++slot) node_V[slot] = 0.0;
+    for (auto const node_element : nodes_to_node_elements[node]) {
       element_index const  element          = node_elements_to_elements[node_element];
       material_index const element_material = elements_to_material[element];
-      if (element_material != material) continue;
+      if (!fused_materials.contains(material_set(element_material))) continue;
+      auto const slot = fused_slot(fused_materials, element_material);
       for (auto const point : elements_to_points[element]) {
         auto const V = points_to_V[point];
-        node_V       = node_V + (N * V);
+        node_V[slot] = node_V[slot] + (N * V);
       }
     }
-    auto const m         = nodes_to_m[node];
-    nodes_to_rho_h[node] = m / node_V;
+    auto const node_materials = nodes_to_materials[node];
+    for (auto const material : materials) {
+      if (!(fused_materials.contains(material_set(material)) && node_materials.contains(material_set(material)))) {
+        continue;
+      }
+      auto const slot                                 = fused_slot(fused_materials, material);
+      auto const m                                    = materials_to_m[material][hpc::weaken(node)];
+      materials_to_rho_h[material][hpc::weaken(node)] = m / node_V[slot];
+    }
   };
-  hpc::for_each(hpc::device_policy(), s.node_sets[material], functor);
+  hpc::for_each(hpc::device_policy(), s.nodes, functor);
+  exchange_nodal_density(s);
 }
 
 void
@@ -608,6 +810,7 @@ interpolate_rho(state& s, material_index const material)
 void
 interpolate_e(state& s, material_index const material)
 {
+  assert(has_fields(s, nodal_energy_fields));
   auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
   auto const elements_to_points        = s.elements * s.points_in_element;
@@ -636,6 +839,7 @@ update_p_h_dot_from_a(input const& in, state& s, material_index const material)
   update_v_prime(in, s, material);
   update_p_h_W(s, material);
   update_p_h_dot(s, material);
+  exchange_p_h_dot(s, material);
 }
 
 void
@@ -644,6 +848,33 @@ update_e_h_dot_from_a(input const& in, state& s, material_index const material)
   update_q(in, s, material);
   update_e_h_W(s, material);
   update_e_h_dot(s, material);
+  exchange_e_h_dot(s, material);
+}
+
+void
+update_p_h_dot_from_a(input const& in, state& s)
+{
+  for (auto const material : in.materials) {
+    if (in.enable_nodal_pressure[material]) {
+      update_v_prime(in, s, material);
+      update_p_h_W(s, material);
+    }
+  }
+  update_p_h_dot(in, s);
+  exchange_p_h_dot(s);
+}
+
+void
+update_e_h_dot_from_a(input const& in, state& s)
+{
+  for (auto const material : in.materials) {
+    if (in.enable_nodal_energy[material]) {
+      update_q(in, s, material);
+      update_e_h_W(s, material);
+    }
+  }
+  update_e_h_dot(in, s);
+  exchange_e_h_dot(s);
 }
 
 }  // namespace lgr
@@ -35,6 +35,8 @@ nodal_ideal_gas(input const& in, state& s, material_index const);
 void
 update_nodal_density(state& s, material_index const);
 void
+update_nodal_density(input const& in, state& s);
+void
 interpolate_K(state& s, material_index const);
 void
 interpolate_rho(state& s, material_index const);
@@ -44,5 +46,9 @@ void
 update_p_h_dot_from_a(input const& in, state& s, material_index const material);
 void
 update_e_h_dot_from_a(input const& in, state& s, material_index const material);
+void
+update_p_h_dot_from_a(input const& in, state& s);
+void
+update_e_h_dot_from_a(input const& in, state& s);
 
 }  // namespace lgr
@@ -1,61 +1,108 @@
 #include <hpc_algorithm.hpp>
 #include <hpc_execution.hpp>
+#include <hpc_matrix3x3.hpp>
+#include <hpc_symmetric3x3.hpp>
 #include <hpc_vector.hpp>
+#include <hpc_vector3.hpp>
+#include <iomanip>
+#include <iostream>
 #include <lgr_input.hpp>
 #include <lgr_state.hpp>
+#include <lgr_state_fields.hpp>
+#include <string>
 
 namespace lgr {
 
+field_set
+required_fields(input const& in)
+{
+  auto fields = in.skip_unused_fields ? field_set::none() : unconditional_fields;
+  for (auto const material : in.materials) {
+    if (in.enable_neo_Hookean[material]) fields = fields | neo_Hookean_fields;
+    if (in.enable_variational_J2[material]) fields = fields | variational_J2_fields;
+    if (in.enable_Mie_Gruneisen_eos[material]) fields = fields | Mie_Gruneisen_eos_fields;
+    if (in.enable_ideal_gas[material] && !in.enable_nodal_energy[material]) fields = fields | ideal_gas_fields;
+    if (!in.enable_nodal_energy[material]) fields = fields | update_e_fields;
+    if (!(in.enable_nodal_pressure[material] || in.enable_nodal_energy[material])) fields = fields | update_p_fields;
+    if (in.enable_nodal_pressure[material]) fields = fields | nodal_pressure_fields;
+    if (in.enable_p_prime[material]) fields = fields | p_prime_fields;
+    if (in.enable_nodal_energy[material]) fields = fields | nodal_energy_fields;
+  }
+  if (in.enable_J_averaging) fields = fields | volume_average_J_fields;
+  if (in.enable_viscosity) fields = fields | apply_viscosity_fields;
+  if (in.force_assembly == GATHER_FORCE_ASSEMBLY) fields = fields | element_force_fields;
+  if (in.enable_comptet_stabilization) fields = fields | comptet_fields;
+  if (in.enable_adapt) fields = fields | adapt_fields;
+  if (!in.recompute_grad_N) fields = fields | stored_grad_N_fields;
+  if (!in.enable_fused_point_kernels) fields = fields | unfused_point_fields;
+  return fields;
+}
+
+bool
+has_fields(state const& s, field_set const fields)
+{
+  auto const points      = s.points.size();
+  auto const point_nodes = s.points.size() * s.nodes_in_element.size();
+  auto const elements    = s.elements.size();
+  auto const nodes       = s.nodes.size();
+  auto       missing     = [&](state_field const field, bool const allocated) {
+    return fields.contains(field) && !allocated;
+  };
+  return !(
+      missing(F_TOTAL_FIELD, s.F_total.size() == points) || missing(FP_TOTAL_FIELD, s.Fp_total.size() == points) ||
+      missing(EP_FIELD, s.ep.size() == points) || missing(TEMP_FIELD, !s.temp.empty()) ||
+      missing(B_FIELD, s.b.size() == nodes) || missing(NU_ART_FIELD, s.nu_art.size() == points) ||
+      missing(H_ART_FIELD, s.h_art.size() == elements) || missing(E_FIELD, s.e.size() == points) ||
+      missing(P_FIELD, s.p.size() == points) || missing(DP_DE_FIELD, s.dp_de.size() == points) ||
+      missing(ELEMENT_F_FIELD, s.element_f.size() == point_nodes) || missing(JAVGJ_FIELD, s.JavgJ.size() == points) ||
+      missing(V_PRIME_FIELD, s.v_prime.size() == points) || missing(P_PRIME_FIELD, s.p_prime.size() == points) ||
+      missing(Q_FIELD, s.q.size() == points) || missing(W_FIELD, s.W.size() == point_nodes) ||
+      missing(QUALITY_FIELD, s.quality.size() == elements) || missing(H_ADAPT_FIELD, s.h_adapt.size() == nodes) ||
+      missing(GRAD_N_FIELD, s.grad_N.size() == point_nodes) ||
+      missing(SYMM_GRAD_V_FIELD, s.symm_grad_v.size() == points) ||
+      missing(RHO_E_DOT_FIELD, s.rho_e_dot.size() == points));
+}
+
+// Only the optional fields that required_fields names are allocated; the kernels that use one assert that it is.
 void
 resize_state(input const& in, state& s)
 {
-  s.u.resize(s.nodes.size());
-  s.v.resize(s.nodes.size());
-  s.b.resize(s.nodes.size());
-  s.V.resize(s.points.size());
-  s.grad_N.resize(s.points.size() * s.nodes_in_element.size());
-  s.F_total.resize(s.points.size());
+  auto const fields   = required_fields(in);
+  auto const needs    = [&](state_field const field) { return fields.contains(field); };
+  auto const points   = s.points.size();
+  auto const nodes    = s.nodes.size();
+  auto const elements = s.elements.size();
+  s.u.resize(nodes);
+  s.v.resize(nodes);
+  if (needs(B_FIELD)) s.b.resize(nodes);
+  s.V.resize(points);
+  if (needs(GRAD_N_FIELD)) s.grad_N.resize(points * s.nodes_in_element.size());
+  if (needs(F_TOTAL_FIELD)) s.F_total.resize(points);
   s.use_comptet_stabilization = in.enable_comptet_stabilization;
-  if (s.use_comptet_stabilization == true) {
-    s.JavgJ.resize(s.points.size());
-  }
-  s.sigma.resize(s.points.size());
-  s.symm_grad_v.resize(s.points.size());
-  auto have_nodal_pressure_or_energy = [&](material_index const material) {
-    return in.enable_nodal_pressure[material] || in.enable_nodal_energy[material];
-  };
-  if (!hpc::all_of(hpc::serial_policy(), in.materials, have_nodal_pressure_or_energy)) {
-    s.p.resize(s.points.size());
-  }
-  s.K.resize(s.points.size());
-  s.G.resize(s.points.size());
-  s.c.resize(s.points.size());
-  s.element_f.resize(s.points.size() * s.nodes_in_element.size());
-  s.f.resize(s.nodes.size());
-  s.rho.resize(s.points.size());
-  if (!hpc::all_of(hpc::serial_policy(), in.enable_nodal_energy)) {
-    s.e.resize(s.points.size());
-  }
-  if (hpc::any_of(hpc::serial_policy(), in.enable_Mie_Gruneisen_eos)) {
-    s.e.resize(s.points.size());
-    s.dp_de.resize(s.points.size());
-  }
-  s.rho_e_dot.resize(s.points.size());
-  {
-    // Plasticity
-    s.Fp_total.resize(s.points.size());
-    s.ep.resize(s.points.size());
-  }
+  if (needs(JAVGJ_FIELD)) s.JavgJ.resize(points);
+  s.sigma.resize(points);
+  if (needs(SYMM_GRAD_V_FIELD)) s.symm_grad_v.resize(points);
+  if (needs(P_FIELD)) s.p.resize(points);
+  s.K.resize(points);
+  s.G.resize(points);
+  s.c.resize(points);
+  if (needs(ELEMENT_F_FIELD)) s.element_f.resize(points * s.nodes_in_element.size());
+  s.f.resize(nodes);
+  s.rho.resize(points);
+  if (needs(E_FIELD)) s.e.resize(points);
+  if (needs(DP_DE_FIELD)) s.dp_de.resize(points);
+  if (needs(RHO_E_DOT_FIELD)) s.rho_e_dot.resize(points);
+  // Plasticity
+  if (needs(FP_TOTAL_FIELD)) s.Fp_total.resize(points);
+  if (needs(EP_FIELD)) s.ep.resize(points);
   s.material_mass.resize(in.materials.size());
-  for (auto& mm : s.material_mass) mm.resize(s.nodes.size());
-  s.mass.resize(s.nodes.size());
-  s.a.resize(s.nodes.size());
-  s.h_min.resize(s.elements.size());
-  if (in.enable_viscosity) {
-    s.h_art.resize(s.elements.size());
-  }
-  s.nu_art.resize(s.points.size());
-  s.element_dt.resize(s.points.size());
+  for (auto& mm : s.material_mass) mm.resize(nodes);
+  s.mass.resize(nodes);
+  s.a.resize(nodes);
+  s.h_min.resize(elements);
+  if (needs(H_ART_FIELD)) s.h_art.resize(elements);
+  if (needs(NU_ART_FIELD)) s.nu_art.resize(points);
+  s.element_dt.resize(points);
   s.p_h.resize(in.materials.size());
   s.p_h_dot.resize(in.materials.size());
   s.e_h.resize(in.materials.size());
@@ -63,33 +110,281 @@ resize_state(input const& in, state& s)
   s.rho_h.resize(in.materials.size());
   s.K_h.resize(in.materials.size());
   s.dp_de_h.resize(in.materials.size());
-  s.temp.resize(in.materials.size());
+  if (needs(TEMP_FIELD)) s.temp.resize(in.materials.size());
+  if (needs(V_PRIME_FIELD)) s.v_prime.resize(points);
+  if (needs(P_PRIME_FIELD)) s.p_prime.resize(points);
+  if (needs(Q_FIELD)) s.q.resize(points);
+  if (needs(W_FIELD)) s.W.resize(points * s.nodes_in_element.size());
   for (auto const material : in.materials) {
     if (in.enable_nodal_pressure[material]) {
-      s.p_h[material].resize(s.nodes.size());
-      s.p_h_dot[material].resize(s.nodes.size());
-      s.v_prime.resize(s.points.size());
-      s.W.resize(s.points.size() * s.nodes_in_element.size());
-    }
-    if (in.enable_p_prime[material]) {
-      s.p_prime.resize(s.points.size());
+      s.p_h[material].resize(nodes);
+      s.p_h_dot[material].resize(nodes);
     }
     if (in.enable_nodal_energy[material]) {
-      s.p_h[material].resize(s.nodes.size());
-      s.e_h[material].resize(s.nodes.size());
-      s.e_h_dot[material].resize(s.nodes.size());
-      s.rho_h[material].resize(s.nodes.size());
-      s.K_h[material].resize(s.nodes.size());
-      s.q.resize(s.points.size());
-      s.W.resize(s.points.size() * s.nodes_in_element.size());
-      s.dp_de_h[material].resize(s.nodes.size());
+      s.p_h[material].resize(nodes);
+      s.e_h[material].resize(nodes);
+      s.e_h_dot[material].resize(nodes);
+      s.rho_h[material].resize(nodes);
+      s.K_h[material].resize(nodes);
+      s.dp_de_h[material].resize(nodes);
     }
   }
-  s.material.resize(s.elements.size());
-  if (in.enable_adapt) {
-    s.quality.resize(s.elements.size());
-    s.h_adapt.resize(s.nodes.size());
+  s.material.resize(elements);
+  if (needs(QUALITY_FIELD)) s.quality.resize(elements);
+  if (needs(H_ADAPT_FIELD)) s.h_adapt.resize(nodes);
+}
+
+// the name of the scalar a field stores, seen through the strong index and dimensional wrappers
+inline std::string
+scalar_type_name(double const*)
+{
+  return "double";
+}
+
+inline std::string
+scalar_type_name(float const*)
+{
+  return "float";
+}
+
+inline std::string
+scalar_type_name(int const*)
+{
+  return "int";
+}
+
+inline std::string
+scalar_type_name(material_set const*)
+{
+  return "material_set";
+}
+
+#ifdef HPC_ENABLE_STRONG_INDICES
+template <class Tag, class Integral>
+std::string
+scalar_type_name(hpc::index<Tag, Integral> const*)
+{
+  return scalar_type_name(static_cast<Integral const*>(nullptr));
+}
+#endif
+
+#ifdef HPC_ENABLE_DIMENSIONAL_ANALYSIS
+template <class T, class Dimension>
+std::string
+scalar_type_name(hpc::quantity<T, Dimension> const*)
+{
+  return scalar_type_name(static_cast<T const*>(nullptr));
+}
+#endif
+
+// the name of one item of a field whose values are T and whose components are stored as S
+template <class T, class S>
+std::string
+item_type_name(T const*, S const*)
+{
+  auto const size = hpc::array_traits<T>::size();
+  auto const name = scalar_type_name(static_cast<S const*>(nullptr));
+  return size == 1 ? name : name + "[" + std::to_string(size) + "]";
+}
+
+template <class T, class S>
+std::string
+item_type_name(hpc::vector3<T> const*, S const*)
+{
+  return "vector3<" + scalar_type_name(static_cast<S const*>(nullptr)) + ">";
+}
+
+template <class T, class S>
+std::string
+item_type_name(hpc::symmetric3x3<T> const*, S const*)
+{
+  return "symmetric3x3<" + scalar_type_name(static_cast<S const*>(nullptr)) + ">";
+}
+
+template <class T, class S>
+std::string
+item_type_name(hpc::matrix3x3<T> const*, S const*)
+{
+  return "matrix3x3<" + scalar_type_name(static_cast<S const*>(nullptr)) + ">";
+}
+
+template <class T, class S = typename hpc::array_traits<T>::value_type>
+std::string
+item_type_name()
+{
+  return item_type_name(static_cast<T const*>(nullptr), static_cast<S const*>(nullptr));
+}
+
+template <class T, class Allocator, class ExecutionPolicy, class Index>
+void
+add_field_memory(
+    std::vector<field_memory>&                               fields,
+    char const*                                              name,
+    char const*                                              index_space,
+    hpc::vector<T, Allocator, ExecutionPolicy, Index> const& field)
+{
+  auto const items = std::ptrdiff_t(hpc::weaken(field.size()));
+  fields.push_back({name, index_space, items, item_type_name<T>(), std::size_t(items) * sizeof(T)});
+}
+
+template <class T, hpc::layout L, class Allocator, class ExecutionPolicy, class Index, class Storage>
+void
+add_field_memory(
+    std::vector<field_memory>&                                                 fields,
+    char const*                                                                name,
+    char const*                                                                index_space,
+    hpc::array_vector<T, L, Allocator, ExecutionPolicy, Index, Storage> const& field)
+{
+  using field_type = hpc::array_vector<T, L, Allocator, ExecutionPolicy, Index, Storage>;
+  auto const items = std::ptrdiff_t(hpc::weaken(field.size()));
+  // the blocked layouts store whole blocks, so the last one is padded
+  auto const rows  = std::ptrdiff_t(hpc::weaken(hpc::padded_size(L, field.size())));
+  auto const size  = std::ptrdiff_t(field_type::array_size());
+  auto const bytes = sizeof(typename field_type::storage_type);
+  fields.push_back({name, index_space, items, item_type_name<T, Storage>(), std::size_t(rows * size) * bytes});
+}
+
+// the offsets of the ranges are stored, one more than there are ranges
+template <class T, class Allocator, class ExecutionPolicy, class Index>
+void
+add_field_memory(
+    std::vector<field_memory>&                                  fields,
+    char const*                                                 name,
+    char const*                                                 index_space,
+    hpc::range_sum<T, Allocator, ExecutionPolicy, Index> const& field)
+{
+  auto const items   = std::ptrdiff_t(hpc::weaken(field.size()));
+  auto const offsets = field.empty() ? 0 : items + 1;
+  fields.push_back({name, index_space, items, item_type_name<T>(), std::size_t(offsets) * sizeof(T)});
+}
+
+template <class Field, class Index>
+void
+add_material_field_memory(
+    std::vector<field_memory>&            fields,
+    char const*                           name,
+    char const*                           index_space,
+    hpc::host_vector<Field, Index> const& material_fields)
+{
+  std::vector<field_memory> parts;
+  for (auto const& field : material_fields) add_field_memory(parts, name, index_space, field);
+  if (parts.empty()) return;
+  auto total = parts.front();
+  for (std::size_t i = 1; i < parts.size(); ++i) {
+    total.items += parts[i].items;
+    total.bytes += parts[i].bytes;
+  }
+  fields.push_back(total);
+}
+
+std::vector<field_memory>
+state_memory(state const& s)
+{
+  std::vector<field_memory> all;
+  add_field_memory(all, "elements_to_nodes", "element nodes", s.elements_to_nodes);
+  add_field_memory(all, "nodes_to_node_elements", "nodes", s.nodes_to_node_elements);
+  add_field_memory(all, "node_elements_to_elements", "node elements", s.node_elements_to_elements);
+  add_field_memory(all, "node_elements_to_nodes_in_element", "node elements", s.node_elements_to_nodes_in_element);
+  add_field_memory(all, "x", "nodes", s.x);
+  add_field_memory(all, "u", "nodes", s.u);
+  add_field_memory(all, "v", "nodes", s.v);
+  add_field_memory(all, "V", "points", s.V);
+  add_field_memory(all, "N", "point nodes", s.N);
+  add_field_memory(all, "grad_N", "point nodes", s.grad_N);
+  add_field_memory(all, "F_total", "points", s.F_total);
+  add_field_memory(all, "sigma_full", "points", s.sigma_full);
+  add_field_memory(all, "sigma", "points", s.sigma);
+  add_field_memory(all, "symm_grad_v", "points", s.symm_grad_v);
+  add_field_memory(all, "p", "points", s.p);
+  add_field_memory(all, "v_prime", "points", s.v_prime);
+  add_field_memory(all, "p_prime", "points", s.p_prime);
+  add_field_memory(all, "q", "points", s.q);
+  add_field_memory(all, "W", "point nodes", s.W);
+  add_material_field_memory(all, "p_h_dot", "material nodes", s.p_h_dot);
+  add_material_field_memory(all, "p_h", "material nodes", s.p_h);
+  add_field_memory(all, "K", "points", s.K);
+  add_material_field_memory(all, "K_h", "material nodes", s.K_h);
+  add_field_memory(all, "G", "points", s.G);
+  add_field_memory(all, "c", "points", s.c);
+  add_field_memory(all, "element_f", "point nodes", s.element_f);
+  add_field_memory(all, "f", "nodes", s.f);
+  add_field_memory(all, "rho", "points", s.rho);
+  add_field_memory(all, "dp_de", "points", s.dp_de);
+  add_field_memory(all, "e", "points", s.e);
+  add_field_memory(all, "rho_e_dot", "points", s.rho_e_dot);
+  add_field_memory(all, "mass", "nodes", s.mass);
+  add_material_field_memory(all, "material_mass", "material nodes", s.material_mass);
+  add_field_memory(all, "a", "nodes", s.a);
+  add_field_memory(all, "h_min", "elements", s.h_min);
+  add_field_memory(all, "h_art", "elements", s.h_art);
+  add_field_memory(all, "nu_art", "points", s.nu_art);
+  add_field_memory(all, "element_dt", "points", s.element_dt);
+  add_material_field_memory(all, "e_h", "material nodes", s.e_h);
+  add_material_field_memory(all, "e_h_dot", "material nodes", s.e_h_dot);
+  add_material_field_memory(all, "rho_h", "material nodes", s.rho_h);
+  add_material_field_memory(all, "dp_de_h", "material nodes", s.dp_de_h);
+  add_field_memory(all, "material", "elements", s.material);
+  add_field_memory(all, "nodal_materials", "nodes", s.nodal_materials);
+  add_field_memory(all, "quality", "elements", s.quality);
+  add_field_memory(all, "h_adapt", "nodes", s.h_adapt);
+  add_material_field_memory(all, "node_sets", "set nodes", s.node_sets);
+  add_material_field_memory(all, "element_sets", "set elements", s.element_sets);
+  add_material_field_memory(all, "material_nodes_to_node_elements", "set nodes", s.material_nodes_to_node_elements);
+  add_material_field_memory(
+      all, "material_node_elements_to_elements", "set node elements", s.material_node_elements_to_elements);
+  add_material_field_memory(
+      all,
+      "material_node_elements_to_nodes_in_element",
+      "set node elements",
+      s.material_node_elements_to_nodes_in_element);
+  add_material_field_memory(all, "element_colors", "color elements", s.element_colors);
+  add_field_memory(all, "JavgJ", "points", s.JavgJ);
+  add_field_memory(all, "global_nodes", "nodes", s.global_nodes);
+  add_field_memory(all, "node_owners", "nodes", s.node_owners);
+  add_field_memory(all, "halo.send_nodes", "sent nodes", s.halo.send_nodes);
+  add_field_memory(all, "halo.receive_nodes", "received nodes", s.halo.receive_nodes);
+  add_field_memory(all, "halo.boundary_elements", "elements", s.halo.boundary_elements);
+  add_field_memory(all, "halo.interior_elements", "elements", s.halo.interior_elements);
+  add_field_memory(all, "halo.boundary_nodes", "nodes", s.halo.boundary_nodes);
+  add_field_memory(all, "halo.interior_nodes", "nodes", s.halo.interior_nodes);
+  add_field_memory(all, "Fp_total", "points", s.Fp_total);
+  add_field_memory(all, "temp", "points", s.temp);
+  add_field_memory(all, "ep", "points", s.ep);
+  add_field_memory(all, "points_to_point_nodes", "points", s.points_to_point_nodes);
+  add_field_memory(all, "nodes_to_node_points", "nodes", s.nodes_to_node_points);
+  add_field_memory(all, "point_nodes_to_nodes", "point nodes", s.point_nodes_to_nodes);
+  add_field_memory(all, "node_points_to_points", "node points", s.node_points_to_points);
+  add_field_memory(all, "node_points_to_point_nodes", "node points", s.node_points_to_point_nodes);
+  add_field_memory(all, "lm", "nodes", s.lm);
+  add_field_memory(all, "xp", "points", s.xp);
+  add_field_memory(all, "b", "nodes", s.b);
+  add_field_memory(all, "h_otm", "points", s.h_otm);
+  add_field_memory(all, "nearest_point_neighbor", "points", s.nearest_point_neighbor);
+  add_field_memory(all, "nearest_point_neighbor_dist", "points", s.nearest_point_neighbor_dist);
+  add_field_memory(all, "nearest_node_neighbor", "nodes", s.nearest_node_neighbor);
+  add_field_memory(all, "nearest_node_neighbor_dist", "nodes", s.nearest_node_neighbor_dist);
+  add_field_memory(all, "potential_density", "point nodes", s.potential_density);
+  std::vector<field_memory> allocated;
+  for (auto const& field : all) {
+    if (field.bytes != 0) allocated.push_back(field);
+  }
+  return allocated;
+}
+
+void
+print_state_memory(state const& s, std::ostream& stream)
+{
+  auto const  fields = state_memory(s);
+  std::size_t total  = 0;
+  stream << std::left << std::setw(36) << "field" << std::setw(16) << "index space" << std::right << std::setw(12)
+         << "items" << std::setw(22) << "item type" << std::setw(16) << "bytes"
+         << "\n";
+  for (auto const& field : fields) {
+    stream << std::left << std::setw(36) << field.name << std::setw(16) << field.index_space << std::right
+           << std::setw(12) << field.items << std::setw(22) << field.type << std::setw(16) << field.bytes << "\n";
+    total += field.bytes;
   }
+  stream << std::left << std::setw(86) << "total" << std::right << std::setw(16) << total << "\n";
 }
 
 }  // namespace lgr
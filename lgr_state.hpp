@@ -5,15 +5,71 @@
 #include <hpc_range.hpp>
 #include <hpc_range_sum.hpp>
 #include <hpc_symmetric3x3.hpp>
+#include <iosfwd>
+#include <lgr_layout.hpp>
 #include <lgr_material_set.hpp>
 #include <lgr_mesh_indices.hpp>
 #include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace lgr {
 
 using dp_de_t = decltype(hpc::pressure<double>() / hpc::specific_energy<double>());
 static_assert(std::is_same<dp_de_t, hpc::density<double>>::value, "dp_de should be a density");
 
+class halo_messages;
+
+// The nodes a rank shares with each neighboring rank: the nodes it owns whose values that rank copies, and its
+// copies of nodes owned by that rank. Both lists run rank by rank, in increasing global node order within a rank.
+class node_halo
+{
+ public:
+  std::vector<int>                       ranks;
+  std::vector<int>                       send_offsets;
+  std::vector<int>                       receive_offsets;
+  hpc::device_vector<node_index, int>    send_nodes;
+  hpc::device_vector<node_index, int>    receive_nodes;
+  // the elements around sent nodes and the other elements; the sent nodes, once each, and the nodes neither sent
+  // nor received
+  hpc::device_vector<element_index, int> boundary_elements;
+  hpc::device_vector<element_index, int> interior_elements;
+  hpc::device_vector<node_index, int>    boundary_nodes;
+  hpc::device_vector<node_index, int>    interior_nodes;
+  std::shared_ptr<halo_messages>         messages;
+  // seconds computed while messages were in flight and seconds spent waiting for them, since the last report
+  double                                 overlapped_time{0.0};
+  double                                 waiting_time{0.0};
+};
+
+// A device table of the data of each material's nodal field, so that one kernel can reach all of them. The table
+// is uploaded again only when one of the fields has been reallocated since the last upload.
+template <class T>
+class material_field_table
+{
+  hpc::pinned_vector<T*, material_index> m_pinned;
+  hpc::device_vector<T*, material_index> m_device;
+
+ public:
+  hpc::device_vector<T*, material_index> const&
+  update(hpc::host_vector<hpc::device_vector<T, node_index>, material_index>& fields)
+  {
+    auto const materials = hpc::counting_range<material_index>(fields.size());
+    bool       moved     = m_pinned.size() != fields.size();
+    if (!moved) {
+      for (auto const material : materials) moved = moved || m_pinned[material] != fields[material].data();
+    }
+    if (moved) {
+      m_pinned.resize(fields.size());
+      m_device.resize(fields.size());
+      for (auto const material : materials) m_pinned[material] = fields[material].data();
+      hpc::copy(m_pinned, m_device);
+    }
+    return m_device;
+  }
+};
+
 class state
 {
  public:
@@ -40,13 +96,13 @@ class state
   // values of basis functions
   hpc::device_vector<hpc::basis_value<double>, point_node_index> N;
   // gradients of basis functions
-  hpc::device_array_vector<hpc::basis_gradient<double>, point_node_index> grad_N;
+  hpc::device_array_vector<hpc::basis_gradient<double>, point_node_index, tensor_layout, point_storage> grad_N;
   // deformation gradient since simulation start
-  hpc::device_array_vector<hpc::deformation_gradient<double>, point_index> F_total;
+  hpc::device_array_vector<hpc::deformation_gradient<double>, point_index, tensor_layout> F_total;
   // Cauchy stress tensor (full)
   hpc::device_array_vector<hpc::stress<double>, point_index> sigma_full;
   // Cauchy stress tensor (symm)
-  hpc::device_array_vector<hpc::symmetric_stress<double>, point_index> sigma;
+  hpc::device_array_vector<hpc::symmetric_stress<double>, point_index, tensor_layout> sigma;
   // symmetrized gradient of velocity
   hpc::device_array_vector<hpc::symmetric_velocity_gradient<double>, point_index> symm_grad_v;
   // pressure at elements (output only!)
@@ -64,13 +120,13 @@ class state
   // stabilized nodal pressure
   hpc::host_vector<hpc::device_vector<hpc::pressure<double>, node_index>, material_index> p_h;
   // (tangent/effective) bulk modulus
-  hpc::device_vector<hpc::pressure<double>, point_index> K;
+  hpc::device_array_vector<hpc::pressure<double>, point_index, hpc::layout::right, point_storage> K;
   // (tangent/effective) bulk modulus at nodes
   hpc::host_vector<hpc::device_vector<hpc::pressure<double>, node_index>, material_index> K_h;
   // (tangent/effective) shear modulus
-  hpc::device_vector<hpc::pressure<double>, point_index> G;
+  hpc::device_array_vector<hpc::pressure<double>, point_index, hpc::layout::right, point_storage> G;
   // sound speed / plane wave speed
-  hpc::device_vector<hpc::speed<double>, point_index> c;
+  hpc::device_array_vector<hpc::speed<double>, point_index, hpc::layout::right, point_storage> c;
   // (internal) force per element-node pair (contribution to a node's force by an element)
   hpc::device_array_vector<hpc::force<double>, point_node_index> element_f;
   // nodal (internal) forces
@@ -94,9 +150,9 @@ class state
   // characteristic element length used for artificial viscosity
   hpc::device_vector<hpc::length<double>, element_index> h_art;
   // artificial kinematic viscosity scalar
-  hpc::device_vector<hpc::kinematic_viscosity<double>, point_index> nu_art;
+  hpc::device_array_vector<hpc::kinematic_viscosity<double>, point_index, hpc::layout::right, point_storage> nu_art;
   // stable time step of each element
-  hpc::device_vector<hpc::time<double>, point_index> element_dt;
+  hpc::device_array_vector<hpc::time<double>, point_index, hpc::layout::right, point_storage> element_dt;
   // nodal specific internal energy
   hpc::host_vector<hpc::device_vector<hpc::specific_energy<double>, node_index>, material_index> e_h;
   // time derivative of nodal specific internal energy
@@ -117,8 +173,27 @@ class state
   hpc::host_vector<hpc::device_vector<node_index, int>, material_index> node_sets;
   // Mostly used for defining materials
   hpc::host_vector<hpc::device_vector<element_index, int>, material_index> element_sets;
+  // for each node of node_sets[material], the adjacent elements of that material, in node_elements order
+  hpc::host_vector<hpc::device_range_sum<node_element_index, int>, material_index> material_nodes_to_node_elements;
+  hpc::host_vector<hpc::device_vector<element_index, node_element_index>, material_index>
+      material_node_elements_to_elements;
+  hpc::host_vector<hpc::device_vector<node_in_element_index, node_element_index>, material_index>
+      material_node_elements_to_nodes_in_element;
+  // elements grouped so that no two elements of a color share a node
+  hpc::host_vector<hpc::device_vector<element_index, int>, int> element_colors;
+  // device tables of the per-material nodal fields, for the fused nodal kernels
+  material_field_table<hpc::pressure_rate<double>>        p_h_dot_table;
+  material_field_table<hpc::specific_energy_rate<double>> e_h_dot_table;
+  material_field_table<hpc::density<double>>              rho_h_table;
+  material_field_table<hpc::mass<double>>                 material_mass_table;
   // Composite tet stabilization
   hpc::device_vector<hpc::adimensional<double>, point_index> JavgJ;
+  // index of each node in the mesh before it was divided among ranks
+  hpc::device_vector<node_index, node_index> global_nodes;
+  // rank that owns each node; the copies on other ranks are refreshed from it
+  hpc::device_vector<int, node_index> node_owners;
+  // exchange of nodal values with the ranks sharing nodes
+  node_halo halo;
 
   hpc::time<double>         next_file_output_time;
   hpc::time<double>         dt     = 0.0;
@@ -132,7 +207,7 @@ class state
   //
 
   // plastic deformation gradient
-  hpc::device_array_vector<hpc::deformation_gradient<double>, point_index> Fp_total;
+  hpc::device_array_vector<hpc::deformation_gradient<double>, point_index, tensor_layout> Fp_total;
   // temperature
   hpc::device_vector<hpc::temperature<double>, point_index> temp;
   // equivalent plastic strain
@@ -197,4 +272,22 @@ class input;
 void
 resize_state(input const& in, state& s);
 
+// What one field of the state takes up. A field with one vector per material is one entry, summed over them.
+class field_memory
+{
+ public:
+  char const*    name;
+  char const*    index_space;
+  std::ptrdiff_t items;
+  std::string    type;
+  std::size_t    bytes;
+};
+
+// the allocated fields of the state, in declaration order
+std::vector<field_memory>
+state_memory(state const& s);
+
+void
+print_state_memory(state const& s, std::ostream& stream);
+
 }  // namespace lgr
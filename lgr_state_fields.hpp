@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lgr {
+
+class input;
+class state;
+
+// The fields of the state that only some physics needs
+enum state_field
+{
+  F_TOTAL_FIELD,
+  FP_TOTAL_FIELD,
+  EP_FIELD,
+  TEMP_FIELD,
+  B_FIELD,
+  NU_ART_FIELD,
+  H_ART_FIELD,
+  E_FIELD,
+  P_FIELD,
+  DP_DE_FIELD,
+  ELEMENT_F_FIELD,
+  JAVGJ_FIELD,
+  V_PRIME_FIELD,
+  P_PRIME_FIELD,
+  Q_FIELD,
+  W_FIELD,
+  QUALITY_FIELD,
+  H_ADAPT_FIELD,
+  GRAD_N_FIELD,
+  SYMM_GRAD_V_FIELD,
+  RHO_E_DOT_FIELD,
+};
+
+class field_set
+{
+  std::uint32_t bits{0};
+  explicit constexpr field_set(std::uint32_t const bits_in) noexcept : bits(bits_in)
+  {
+  }
+
+ public:
+  constexpr field_set(state_field const field) noexcept : bits(std::uint32_t(1) << int(field))
+  {
+  }
+  constexpr field_set
+  operator|(field_set const other) const noexcept
+  {
+    return field_set(bits | other.bits);
+  }
+  constexpr bool
+  contains(field_set const other) const noexcept
+  {
+    return (bits | other.bits) == bits;
+  }
+  constexpr static field_set
+  none() noexcept
+  {
+    return field_set(std::uint32_t(0));
+  }
+};
+
+// The optional fields each kernel reads or writes; a kernel asserts that they are allocated before it starts.
+constexpr field_set neo_Hookean_fields       = F_TOTAL_FIELD;
+constexpr field_set variational_J2_fields    = field_set(F_TOTAL_FIELD) | FP_TOTAL_FIELD | EP_FIELD;
+constexpr field_set Mie_Gruneisen_eos_fields = field_set(E_FIELD) | DP_DE_FIELD;
+constexpr field_set ideal_gas_fields         = E_FIELD;
+constexpr field_set update_e_fields          = E_FIELD;
+constexpr field_set update_p_fields          = P_FIELD;
+constexpr field_set volume_average_J_fields  = F_TOTAL_FIELD;
+constexpr field_set apply_viscosity_fields   = field_set(H_ART_FIELD) | NU_ART_FIELD | SYMM_GRAD_V_FIELD;
+constexpr field_set element_force_fields     = ELEMENT_F_FIELD;
+constexpr field_set comptet_fields           = JAVGJ_FIELD;
+constexpr field_set nodal_pressure_fields    = field_set(V_PRIME_FIELD) | W_FIELD | SYMM_GRAD_V_FIELD;
+constexpr field_set p_prime_fields           = field_set(P_PRIME_FIELD) | SYMM_GRAD_V_FIELD;
+constexpr field_set nodal_energy_fields      = field_set(Q_FIELD) | W_FIELD | E_FIELD | RHO_E_DOT_FIELD;
+constexpr field_set adapt_fields             = field_set(QUALITY_FIELD) | H_ADAPT_FIELD;
+// unless the linear tetrahedra recompute their gradients instead (input::recompute_grad_N)
+constexpr field_set stored_grad_N_fields     = GRAD_N_FIELD;
+// update_symm_grad_v and stress_power, unless the fused point kernels keep both in registers instead
+constexpr field_set unfused_point_fields     = field_set(SYMM_GRAD_V_FIELD) | RHO_E_DOT_FIELD;
+// allocated for every run unless input::skip_unused_fields is set: nothing in a finite element run reads the
+// temperature or the OTM body acceleration, and without viscosity the element time step takes nu_art as zero
+constexpr field_set unconditional_fields =
+    field_set(F_TOTAL_FIELD) | FP_TOTAL_FIELD | EP_FIELD | TEMP_FIELD | B_FIELD | NU_ART_FIELD;
+
+// the optional fields that the kernels enabled by \p in use
+field_set
+required_fields(input const& in);
+
+// whether each field of \p fields is allocated for the current mesh
+bool
+has_fields(state const& s, field_set const fields);
+
+}  // namespace lgr
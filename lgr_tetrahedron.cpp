@@ -1,4 +1,5 @@
 #include <hpc_array.hpp>
+#include <lgr_basis_gradients.hpp>
 #include <lgr_element_specific_inline.hpp>
 #include <lgr_state.hpp>
 #include <lgr_tetrahedron.hpp>
@@ -32,6 +33,8 @@ initialize_tetrahedron_V(state& s)
 void
 initialize_tetrahedron_grad_N(state& s)
 {
+  // left unallocated when the kernels recompute the gradients from the positions
+  if (s.grad_N.empty()) return;
   auto const element_nodes_to_nodes    = s.elements_to_nodes.cbegin();
   auto const nodes_to_x                = s.x.cbegin();
   auto const points_to_V               = s.V.cbegin();
@@ -62,9 +65,8 @@ initialize_tetrahedron_grad_N(state& s)
 void
 update_tetrahedron_h_min_inball(input const&, state& s)
 {
-  auto const point_nodes_to_grad_N = s.grad_N.cbegin();
+  auto const points_to_grad_N      = basis_gradients(s);
   auto const elements_to_h_min     = s.h_min.begin();
-  auto const points_to_point_nodes = s.points * s.nodes_in_element;
   auto const nodes_in_element      = s.nodes_in_element;
   auto const elements_to_points    = s.elements * s.points_in_element;
   auto       functor               = [=] HPC_DEVICE(element_index const element) {
@@ -80,11 +82,11 @@ update_tetrahedron_h_min_inball(input const&, state& s)
        of the top and bottom of the division.
      */
     constexpr point_in_element_index                      fp(0);
-    auto const                                            point       = elements_to_points[element][fp];
-    auto const                                            point_nodes = points_to_point_nodes[point];
+    auto const                                            point        = elements_to_points[element][fp];
+    auto const                                            point_grad_N = points_to_grad_N(element, point);
     decltype(hpc::area<double>() / hpc::volume<double>()) surface_area_over_thrice_volume = 0.0;
     for (auto const i : nodes_in_element) {
-      auto const grad_N                       = point_nodes_to_grad_N[point_nodes[i]].load();
+      auto const grad_N                       = point_grad_N[i];
       auto const face_area_over_thrice_volume = norm(grad_N);
       surface_area_over_thrice_volume += face_area_over_thrice_volume;
     }
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <lgr_timers.hpp>
+#include <vector>
+
+namespace lgr {
+
+static std::deque<kernel_timing>&
+kernel_timings()
+{
+  static std::deque<kernel_timing> timings;
+  return timings;
+}
+
+kernel_timing&
+register_kernel_timing(char const* name, char const* item)
+{
+  auto& timings = kernel_timings();
+  for (auto& timing : timings) {
+    if (std::strcmp(timing.name, name) == 0 && std::strcmp(timing.item, item) == 0) return timing;
+  }
+  timings.emplace_back();
+  timings.back().name = name;
+  timings.back().item = item;
+  return timings.back();
+}
+
+void
+reset_kernel_timings()
+{
+  for (auto& timing : kernel_timings()) {
+    timing.calls   = 0;
+    timing.seconds = 0.0;
+    timing.items   = 0.0;
+  }
+}
+
+static std::vector<kernel_timing const*>
+called_kernels()
+{
+  std::vector<kernel_timing const*> called;
+  for (auto const& timing : kernel_timings()) {
+    if (timing.calls != 0) called.push_back(&timing);
+  }
+  std::stable_sort(called.begin(), called.end(), [](kernel_timing const* a, kernel_timing const* b) {
+    return a->seconds > b->seconds;
+  });
+  return called;
+}
+
+static double
+items_per_second(kernel_timing const& timing)
+{
+  return timing.seconds > 0.0 ? timing.items / timing.seconds : 0.0;
+}
+
+void
+print_kernel_timings(std::ostream& stream)
+{
+  auto const called = called_kernels();
+  if (called.empty()) return;
+  auto const flags     = stream.flags();
+  auto const precision = stream.precision();
+  stream << std::left << std::setw(40) << "kernel" << std::right << std::setw(10) << "calls" << std::setw(14)
+         << "total [s]" << std::setw(14) << "mean [s]" << std::setw(14) << "rate [1/s]"
+         << "\n";
+  stream << std::scientific << std::setprecision(4);
+  for (auto const timing : called) {
+    stream << std::left << std::setw(40) << timing->name << std::right << std::setw(10) << timing->calls
+           << std::setw(14) << timing->seconds << std::setw(14) << timing->seconds / double(timing->calls)
+           << std::setw(14) << items_per_second(*timing) << " " << timing->item << "\n";
+  }
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void
+write_kernel_timings_json(std::ostream& stream)
+{
+  auto const called    = called_kernels();
+  auto const flags     = stream.flags();
+  auto const precision = stream.precision();
+  stream << std::scientific << std::setprecision(17);
+  stream << "[";
+  for (std::size_t i = 0; i < called.size(); ++i) {
+    auto const& timing = *(called[i]);
+    stream << (i == 0 ? "\n" : ",\n");
+    stream << "  {\"kernel\": \"" << timing.name << "\", \"item\": \"" << timing.item << "\", \"calls\": "
+           << timing.calls << ", \"total_seconds\": " << timing.seconds
+           << ", \"mean_seconds\": " << timing.seconds / double(timing.calls) << ", \"items\": " << timing.items
+           << ", \"items_per_second\": " << items_per_second(timing) << "}";
+  }
+  stream << "\n]\n";
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void
+report_kernel_timings(bool const print, std::string const& json_filename)
+{
+  if (print) print_kernel_timings(std::cout);
+  if (json_filename.empty()) return;
+  std::ofstream stream(json_filename.c_str());
+  if (!stream.is_open()) HPC_ERROR_EXIT("could not open the kernel timings file");
+  write_kernel_timings_json(stream);
+}
+
+}  // namespace lgr
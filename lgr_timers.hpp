@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <hpc_index.hpp>
+#include <hpc_macros.hpp>
+#include <iosfwd>
+#include <string>
+
+namespace lgr {
+
+// What the kernels timed under one name have cost so far; \p item names what they loop over, so that the
+// report can quote a rate in elements, points or nodes per second.
+class kernel_timing
+{
+ public:
+  char const* name{nullptr};
+  char const* item{nullptr};
+  long        calls{0};
+  double      seconds{0.0};
+  double      items{0.0};
+};
+
+// The record of the kernel called \p name, created on first use and kept for the life of the program.
+kernel_timing&
+register_kernel_timing(char const* name, char const* item);
+
+void
+reset_kernel_timings();
+
+// The kernels that have been called, most expensive first. Times include those of timed kernels called
+// from within, as for the time integrator steps.
+void
+print_kernel_timings(std::ostream& stream);
+void
+write_kernel_timings_json(std::ostream& stream);
+// Prints the table if \p print is set and writes the JSON to \p json_filename unless it is empty.
+void
+report_kernel_timings(bool const print, std::string const& json_filename);
+
+class scoped_kernel_timer
+{
+  kernel_timing&                              timing;
+  std::chrono::steady_clock::time_point const start;
+
+ public:
+  scoped_kernel_timer(kernel_timing& timing_in, double const items)
+      : timing(timing_in), start(std::chrono::steady_clock::now())
+  {
+    timing.items += items;
+  }
+  ~scoped_kernel_timer()
+  {
+#ifdef HPC_CUDA
+    cudaDeviceSynchronize();
+#endif
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    timing.seconds += elapsed.count();
+    ++timing.calls;
+  }
+  scoped_kernel_timer(scoped_kernel_timer const&) = delete;
+  scoped_kernel_timer&
+  operator=(scoped_kernel_timer const&) = delete;
+};
+
+}  // namespace lgr
+
+// Times the rest of the enclosing kernel under \p name, which loops over \p count of \p item. The name is given
+// rather than taken from __func__ so that overloads get rows of their own. Unless lgr is built with
+// LGR_ENABLE_TIMERS this expands to nothing.
+#ifdef LGR_ENABLE_TIMERS
+#define LGR_TIME_KERNEL(name, item, count)                                                                 \
+  static ::lgr::kernel_timing& lgr_kernel_timing = ::lgr::register_kernel_timing(name, item);              \
+  ::lgr::scoped_kernel_timer const lgr_kernel_timer(lgr_kernel_timing, double(hpc::weaken(count)))
+#else
+#define LGR_TIME_KERNEL(name, item, count) ((void)0)
+#endif
@@ -11,10 +11,24 @@
 #include <lgr_state.hpp>
 #include <lgr_vtk.hpp>
 #include <lgr_vtk_util.hpp>
+#include <lgr_vtu.hpp>
 #include <sstream>
+#include <utility>
 
 namespace lgr {
 
+static std::uint8_t
+vtk_cell_type(element_kind const element)
+{
+  switch (element) {
+    case BAR: return 3;
+    case TRIANGLE: return 5;
+    case TETRAHEDRON: return 10;
+    case COMPOSITE_TETRAHEDRON: return 24;
+  }
+  return 0;
+}
+
 static void
 write_vtk_cells(std::ostream& stream, input const& in, captured_state const& s)
 {
@@ -30,13 +44,7 @@ write_vtk_cells(std::ostream& stream, input const& in, captured_state const& s)
     stream << "\n";
   }
   stream << "CELL_TYPES " << s.elements.size() << "\n";
-  int cell_type = -1;
-  switch (in.element) {
-    case BAR: cell_type = 3; break;
-    case TRIANGLE: cell_type = 5; break;
-    case TETRAHEDRON: cell_type = 10; break;
-    case COMPOSITE_TETRAHEDRON: cell_type = 24; break;
-  }
+  int const cell_type = vtk_cell_type(in.element);
   for (element_index i(0); i < s.elements.size(); ++i) {
     stream << cell_type << "\n";
   }
@@ -73,6 +81,27 @@ write_vtk_scalars(
   }
 }
 
+template <class Quantity, hpc::layout L, class S>
+static void
+write_vtk_scalars(
+    std::ostream&                                                stream,
+    char const*                                                  name,
+    hpc::counting_range<element_index> const                     elements,
+    hpc::counting_range<point_in_element_index> const            points_in_element,
+    hpc::pinned_array_vector<Quantity, point_index, L, S> const& vec)
+{
+  auto const elements_to_points = elements * points_in_element;
+  for (auto const qp : points_in_element) {
+    std::string suffix = (points_in_element.size() == 1) ? "" : (std::string("_") + std::to_string(hpc::weaken(qp)));
+    stream << "SCALARS " << name << suffix << " double 1\n";
+    stream << "LOOKUP_TABLE default\n";
+    for (auto const e : elements) {
+      auto const p = elements_to_points[e][qp];
+      stream << double(vec.begin()[p].load()) << "\n";
+    }
+  }
+}
+
 template <class Quantity>
 static void
 write_vtk_vectors(
@@ -93,14 +122,14 @@ write_vtk_vectors(
   }
 }
 
-template <class Quantity>
+template <class Quantity, hpc::layout L>
 static void
 write_vtk_tensors(
-    std::ostream&                                                          stream,
-    char const*                                                            name,
-    hpc::counting_range<element_index> const                               elements,
-    hpc::counting_range<point_in_element_index> const                      points_in_element,
-    hpc::pinned_array_vector<hpc::matrix3x3<Quantity>, point_index> const& mat)
+    std::ostream&                                                             stream,
+    char const*                                                               name,
+    hpc::counting_range<element_index> const                                  elements,
+    hpc::counting_range<point_in_element_index> const                         points_in_element,
+    hpc::pinned_array_vector<hpc::matrix3x3<Quantity>, point_index, L> const& mat)
 {
   auto const elements_to_points = elements * points_in_element;
   for (auto const qp : points_in_element) {
@@ -113,14 +142,14 @@ write_vtk_tensors(
   }
 }
 
-template <class Quantity>
+template <class Quantity, hpc::layout L>
 static void
 write_vtk_symmetric_tensors(
-    std::ostream&                                                             stream,
-    char const*                                                               name,
-    hpc::counting_range<element_index> const                                  elements,
-    hpc::counting_range<point_in_element_index> const                         points_in_element,
-    hpc::pinned_array_vector<hpc::symmetric3x3<Quantity>, point_index> const& mat)
+    std::ostream&                                                                stream,
+    char const*                                                                  name,
+    hpc::counting_range<element_index> const                                     elements,
+    hpc::counting_range<point_in_element_index> const                            points_in_element,
+    hpc::pinned_array_vector<hpc::symmetric3x3<Quantity>, point_index, L> const& mat)
 {
   auto const elements_to_points = elements * points_in_element;
   for (auto const qp : points_in_element) {
@@ -139,6 +168,164 @@ write_vtk_cell_data(std::ostream& stream, captured_state const& s)
   stream << "CELL_DATA " << s.elements.size() << "\n";
 }
 
+// One cell array per point in element. With one point per element, a field that is already stored the way
+// VTK reads it goes to the file straight from its pinned buffer; otherwise \p load gathers it.
+template <class Load>
+static void
+add_vtu_point_fields(
+    vtu_file&             file,
+    char const*           name,
+    captured_state const& s,
+    int const             components,
+    double const*         contiguous,
+    Load                  load)
+{
+  auto const elements_to_points = s.elements * s.points_in_element;
+  for (auto const qp : s.points_in_element) {
+    std::string suffix = (s.points_in_element.size() == 1) ? "" : (std::string("_") + std::to_string(hpc::weaken(qp)));
+    if (contiguous != nullptr && s.points_in_element.size() == 1) {
+      file.add_cell_data(name + suffix, contiguous, components);
+      continue;
+    }
+    auto const values = file.add_cell_data(name + suffix, components);
+    for (auto const e : s.elements) {
+      load(elements_to_points[e][qp], values + hpc::weaken(e) * components);
+    }
+  }
+}
+
+template <class Quantity>
+static void
+add_vtu_scalars(
+    vtu_file&                                        file,
+    char const*                                      name,
+    captured_state const&                            s,
+    hpc::pinned_vector<Quantity, point_index> const& vec)
+{
+  auto const points_to_values = vec.cbegin();
+  add_vtu_point_fields(file, name, s, 1, vtu_doubles(vec), [=](point_index const p, double* values) {
+    values[0] = double(points_to_values[p]);
+  });
+}
+
+template <class Quantity, hpc::layout L, class S>
+static void
+add_vtu_scalars(
+    vtu_file&                                                    file,
+    char const*                                                  name,
+    captured_state const&                                        s,
+    hpc::pinned_array_vector<Quantity, point_index, L, S> const& vec)
+{
+  auto const points_to_values = vec.cbegin();
+  add_vtu_point_fields(file, name, s, 1, vtu_doubles(vec), [=](point_index const p, double* values) {
+    values[0] = double(points_to_values[p].load());
+  });
+}
+
+template <class Quantity>
+static void
+add_vtu_vectors(
+    vtu_file&                                                            file,
+    char const*                                                          name,
+    captured_state const&                                                s,
+    hpc::pinned_array_vector<hpc::vector3<Quantity>, point_index> const& vec)
+{
+  auto const points_to_values = vec.cbegin();
+  add_vtu_point_fields(file, name, s, 3, vtu_doubles(vec), [=](point_index const p, double* values) {
+    auto const value = hpc::vector3<double>(points_to_values[p].load());
+    for (int i = 0; i < 3; ++i) values[i] = value(i);
+  });
+}
+
+template <class Quantity, hpc::layout L>
+static void
+add_vtu_tensors(
+    vtu_file&                                                                 file,
+    char const*                                                               name,
+    captured_state const&                                                     s,
+    hpc::pinned_array_vector<hpc::matrix3x3<Quantity>, point_index, L> const& mat)
+{
+  auto const points_to_values = mat.cbegin();
+  add_vtu_point_fields(file, name, s, 9, vtu_doubles(mat), [=](point_index const p, double* values) {
+    auto const value = hpc::matrix3x3<double>(points_to_values[p].load());
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) values[3 * i + j] = value(i, j);
+    }
+  });
+}
+
+// written out in full, as the legacy files have them
+template <class Quantity, hpc::layout L>
+static void
+add_vtu_symmetric_tensors(
+    vtu_file&                                                                    file,
+    char const*                                                                  name,
+    captured_state const&                                                        s,
+    hpc::pinned_array_vector<hpc::symmetric3x3<Quantity>, point_index, L> const& mat)
+{
+  auto const points_to_values = mat.cbegin();
+  add_vtu_point_fields(file, name, s, 9, nullptr, [=](point_index const p, double* values) {
+    auto const value = hpc::symmetric3x3<double>(points_to_values[p].load());
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) values[3 * i + j] = value(i, j);
+    }
+  });
+}
+
+static std::size_t
+write_vtu(input const& in, captured_state const& s, std::string const& filename)
+{
+  auto const encoding = (in.output_format == ZLIB_VTU_OUTPUT_FORMAT) ? ZLIB_VTU_ENCODING : RAW_VTU_ENCODING;
+  static_assert(sizeof(node_index) == sizeof(int), "VTU connectivity is written as Int32");
+  static_assert(sizeof(material_index) == sizeof(int), "VTU materials are written as Int32");
+  vtu_file file(encoding, hpc::weaken(s.nodes.size()), hpc::weaken(s.elements.size()));
+  file.set_points(vtu_doubles(s.x));
+  file.set_cells(
+      reinterpret_cast<int const*>(s.element_nodes_to_nodes.data()),
+      hpc::weaken(s.nodes_in_element.size()),
+      vtk_cell_type(in.element));
+  // POINTS
+  file.add_point_data("position", vtu_doubles(s.x), 3);
+  file.add_point_data("velocity", vtu_doubles(s.v), 3);
+  for (material_index const material : in.materials) {
+    if (in.enable_nodal_pressure[material] || in.enable_nodal_energy[material]) {
+      file.add_point_data("nodal_pressure_" + std::to_string(hpc::weaken(material)), vtu_doubles(s.p_h[material]), 1);
+    }
+    if (in.enable_nodal_energy[material]) {
+      file.add_point_data("nodal_energy_" + std::to_string(hpc::weaken(material)), vtu_doubles(s.e_h[material]), 1);
+      file.add_point_data("nodal_density_" + std::to_string(hpc::weaken(material)), vtu_doubles(s.rho_h[material]), 1);
+    }
+  }
+  if (in.enable_adapt) file.add_point_data("h", vtu_doubles(s.h_adapt), 1);
+  // CELLS
+  auto have_nodal_pressure_or_energy = [&](material_index const material) {
+    return in.enable_nodal_pressure[material] || in.enable_nodal_energy[material];
+  };
+  if (!hpc::all_of(hpc::serial_policy(), in.materials, have_nodal_pressure_or_energy)) {
+    add_vtu_scalars(file, "pressure", s, s.p);
+  }
+  auto const no_nodal_energy = !hpc::all_of(hpc::serial_policy(), in.enable_nodal_energy);
+  auto const is_solid        = hpc::any_of(hpc::serial_policy(), in.enable_variational_J2) ||
+                        hpc::any_of(hpc::serial_policy(), in.enable_neo_Hookean);
+  if (no_nodal_energy) add_vtu_scalars(file, "energy", s, s.e);
+  if (no_nodal_energy || is_solid) add_vtu_scalars(file, "density", s, s.rho);
+  if (hpc::any_of(hpc::serial_policy(), in.enable_nodal_energy)) {
+    add_vtu_vectors(file, "q", s, s.q);
+    if (hpc::any_of(hpc::serial_policy(), in.enable_p_prime)) add_vtu_scalars(file, "p_prime", s, s.p_prime);
+  }
+  add_vtu_scalars(file, "time_step", s, s.element_dt);
+  if (in.enable_adapt) file.add_cell_data("quality", vtu_doubles(s.quality), 1);
+  file.add_cell_data("material", reinterpret_cast<int const*>(s.material.data()), 1);
+  if (s.sigma.size() > 0) add_vtu_symmetric_tensors(file, "cauchy_stress", s, s.sigma);
+  if (s.F_total.size() > 0) add_vtu_tensors(file, "def_grad", s, s.F_total);
+  if (s.Fp_total.size() > 0) add_vtu_tensors(file, "plastic_def_grad", s, s.Fp_total);
+  if (s.sigma_full.size() > 0) add_vtu_tensors(file, "cauchy_stress", s, s.sigma_full);
+  if (s.ep.size() > 0) add_vtu_scalars(file, "plastic_strain", s, s.ep);
+  if (s.c.size() > 0) add_vtu_scalars(file, "wave_speed", s, s.c);
+  if (s.K.size() > 0) add_vtu_scalars(file, "bulk_modulus", s, s.K);
+  return file.write(filename);
+}
+
 void
 file_writer::capture(input const& in, state const& s)
 {
@@ -239,9 +426,12 @@ file_writer::capture(input const& in, state const& s)
   }
 }
 
-void
-file_writer::write(input const& in, int const file_output_index)
+static std::size_t
+write_vtk(input const& in, captured_state const& captured, std::string const& prefix, int const file_output_index)
 {
+  if (in.output_format != ASCII_VTK_OUTPUT_FORMAT) {
+    return write_vtu(in, captured, vtu_output_filename(prefix, file_output_index));
+  }
   auto stream = make_vtk_output_stream(prefix, file_output_index);
 
   start_vtk_unstructured_grid_file(stream);
@@ -331,7 +521,24 @@ file_writer::write(input const& in, int const file_output_index)
   if (captured.K.size() > 0) {
     write_vtk_scalars(stream, "bulk_modulus", captured.elements, captured.points_in_element, captured.K);
   }
+  auto const bytes = std::size_t(stream.tellp());
   stream.close();
+  return bytes;
+}
+
+void
+file_writer::write(input const& in, int const file_output_index)
+{
+  writer.finish();
+  std::swap(captured, writing);
+  auto const in_ptr = &in;
+  writer.submit([this, in_ptr, file_output_index] { return write_vtk(*in_ptr, writing, prefix, file_output_index); });
+}
+
+std::size_t
+file_writer::finish()
+{
+  return writer.finish();
 }
 
 }  // namespace lgr
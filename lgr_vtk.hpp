@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <hpc_array_vector.hpp>
 #include <hpc_dimensional.hpp>
+#include <lgr_background_writer.hpp>
+#include <lgr_layout.hpp>
 #include <lgr_mesh_indices.hpp>
 #include <string>
 
@@ -10,6 +13,10 @@ namespace lgr {
 class input;
 class state;
 
+// a per-point scalar kept in point_storage
+template <class T>
+using pinned_point_scalars = hpc::pinned_array_vector<T, point_index, hpc::layout::right, point_storage>;
+
 class captured_state
 {
  public:
@@ -20,30 +27,33 @@ class captured_state
   hpc::pinned_vector<node_index, element_node_index>                                             element_nodes_to_nodes;
   hpc::pinned_array_vector<hpc::position<double>, node_index>                                    x;
   hpc::pinned_array_vector<hpc::velocity<double>, node_index>                                    v;
-  hpc::pinned_array_vector<hpc::symmetric_stress<double>, node_index>                            sigma;
+  hpc::pinned_array_vector<hpc::symmetric_stress<double>, point_index, tensor_layout>            sigma;
   hpc::pinned_array_vector<hpc::stress<double>, node_index>                                      sigma_full;
-  hpc::pinned_array_vector<hpc::deformation_gradient<double>, node_index>                        F_total;
-  hpc::pinned_array_vector<hpc::deformation_gradient<double>, node_index>                        Fp_total;
+  hpc::pinned_array_vector<hpc::deformation_gradient<double>, point_index, tensor_layout>        F_total;
+  hpc::pinned_array_vector<hpc::deformation_gradient<double>, point_index, tensor_layout>        Fp_total;
   hpc::host_vector<hpc::pinned_vector<hpc::pressure<double>, node_index>, material_index>        p_h;
   hpc::host_vector<hpc::pinned_vector<hpc::specific_energy<double>, node_index>, material_index> e_h;
   hpc::host_vector<hpc::pinned_vector<hpc::density<double>, node_index>, material_index>         rho_h;
   hpc::pinned_vector<hpc::length<double>, node_index>                                            h_adapt;
   hpc::pinned_vector<hpc::pressure<double>, point_index>                                         p;
-  hpc::pinned_vector<hpc::pressure<double>, point_index>                                         K;
-  hpc::pinned_vector<hpc::speed<double>, point_index>                                            c;
+  pinned_point_scalars<hpc::pressure<double>>                                                    K;
+  pinned_point_scalars<hpc::speed<double>>                                                       c;
   hpc::pinned_vector<hpc::specific_energy<double>, point_index>                                  e;
   hpc::pinned_vector<hpc::density<double>, point_index>                                          rho;
   hpc::pinned_vector<hpc::density<double>, point_index>                                          ep;
   hpc::pinned_array_vector<hpc::heat_flux<double>, point_index>                                  q;
   hpc::pinned_vector<hpc::pressure<double>, point_index>                                         p_prime;
-  hpc::pinned_vector<hpc::time<double>, point_index>                                             element_dt;
+  pinned_point_scalars<hpc::time<double>>                                                        element_dt;
   hpc::pinned_vector<hpc::adimensional<double>, element_index>                                   quality;
   hpc::pinned_vector<material_index, element_index>                                              material;
 };
 
+// Double buffered: write() hands the captured state over to a background thread and takes the state that
+// thread wrote last as the buffer for the next capture, so \p in has to outlive the writes.
 class file_writer
 {
-  std::string prefix;
+  std::string    prefix;
+  captured_state writing;
 
  public:
   file_writer(std::string const& prefix_in) : prefix(prefix_in)
@@ -51,9 +61,17 @@ class file_writer
   }
   void
   capture(input const& in, state const& s);
+  // waits for the previous write to finish and starts writing the captured state
   void
-                 write(input const& in, int const file_output_index);
+  write(input const& in, int const file_output_index);
+  // waits for the writes started so far and returns the number of bytes they wrote
+  std::size_t
+                 finish();
   captured_state captured;
+
+ private:
+  // declared last so that its thread is joined before the states it writes go away
+  background_writer writer;
 };
 
 }  // namespace lgr
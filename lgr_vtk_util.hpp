@@ -9,6 +9,7 @@
 #include <hpc_vector3.hpp>
 #include <iomanip>
 #include <lgr_print.hpp>
+#include <lgr_vtu.hpp>
 #include <sstream>
 #include <string>
 
@@ -24,6 +25,14 @@ make_vtk_output_stream(const std::string& prefix, int const file_output_index)
   return stream;
 }
 
+inline std::string
+vtu_output_filename(std::string const& prefix, int const file_output_index)
+{
+  std::stringstream filename_stream;
+  filename_stream << prefix << "_" << file_output_index << ".vtu";
+  return filename_stream.str();
+}
+
 inline void
 start_vtk_unstructured_grid_file(std::ostream& stream)
 {
@@ -50,12 +59,12 @@ write_vtk_points(std::ostream& stream, hpc::pinned_array_vector<hpc::vector3<Qua
   }
 }
 
-template <class Quantity, class Index>
+template <class Quantity, class Index, hpc::layout L>
 inline void
 write_vtk_full_tensors(
-    std::ostream&                                                    stream,
-    std::string const&                                               name,
-    hpc::pinned_array_vector<hpc::matrix3x3<Quantity>, Index> const& tensor)
+    std::ostream&                                                       stream,
+    std::string const&                                                  name,
+    hpc::pinned_array_vector<hpc::matrix3x3<Quantity>, Index, L> const& tensor)
 {
   stream << "SCALARS " << name << " double 9\n";
   stream << "LOOKUP_TABLE default\n";
@@ -101,4 +110,69 @@ write_vtk_scalars(std::ostream& stream, std::string const& name, hpc::pinned_vec
   }
 }
 
+template <class Quantity, class Index, hpc::layout L, class S>
+inline void
+write_vtk_scalars(
+    std::ostream&                                          stream,
+    std::string const&                                     name,
+    hpc::pinned_array_vector<Quantity, Index, L, S> const& vec)
+{
+  stream << "SCALARS " << name << " double 1\n";
+  stream << "LOOKUP_TABLE default\n";
+  for (auto const ref : vec) {
+    stream << double(ref.load()) << "\n";
+  }
+}
+
+// The components of a field in the order VTU files keep them, or null when its layout interleaves points
+template <class Quantity, class Index>
+inline double const*
+vtu_doubles(hpc::pinned_vector<Quantity, Index> const& vec)
+{
+  static_assert(sizeof(Quantity) == sizeof(double), "VTU fields are written as Float64");
+  return reinterpret_cast<double const*>(vec.data());
+}
+
+// nullptr unless the components are stored as doubles, one array after another
+template <class T, class Index, hpc::layout L, class S>
+inline double const*
+vtu_doubles(hpc::pinned_array_vector<T, Index, L, S> const& vec)
+{
+  bool const contiguous = L == hpc::layout::right && sizeof(S) == sizeof(double);
+  return contiguous ? reinterpret_cast<double const*>(vec.data()) : nullptr;
+}
+
+template <class Quantity, class Index, hpc::layout L>
+inline void
+add_vtu_full_tensors(
+    vtu_file&                                                           file,
+    std::string const&                                                  name,
+    hpc::pinned_array_vector<hpc::matrix3x3<Quantity>, Index, L> const& tensor)
+{
+  if (L == hpc::layout::right) {
+    file.add_point_data(name, vtu_doubles(tensor), 9);
+    return;
+  }
+  auto values = file.add_point_data(name, 9);
+  for (auto const ref : tensor) {
+    auto const value = hpc::matrix3x3<double>(ref.load());
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) values[3 * i + j] = value(i, j);
+    }
+    values += 9;
+  }
+}
+
+template <class Quantity, class Index, hpc::layout L, class S>
+inline void
+add_vtu_scalars(vtu_file& file, std::string const& name, hpc::pinned_array_vector<Quantity, Index, L, S> const& vec)
+{
+  if (auto const doubles = vtu_doubles(vec)) {
+    file.add_point_data(name, doubles, 1);
+    return;
+  }
+  auto values = file.add_point_data(name, 1);
+  for (auto const ref : vec) *values++ = double(ref.load());
+}
+
 }  // namespace lgr
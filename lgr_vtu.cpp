@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <hpc_macros.hpp>
+#include <lgr_vtu.hpp>
+
+#ifdef LGR_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace lgr {
+
+vtu_file::vtu_file(vtu_encoding const encoding_in, std::int64_t const points_in, std::int64_t const cells_in)
+    : encoding(encoding_in), points(points_in), cells(cells_in)
+{
+#ifndef LGR_ENABLE_ZLIB
+  if (encoding == ZLIB_VTU_ENCODING) HPC_ERROR_EXIT("compressed VTU output needs lgr built with LGR_ENABLE_ZLIB");
+#endif
+}
+
+void
+vtu_file::add_array(
+    section const      where,
+    std::string const& name,
+    char const*        type,
+    int const          components,
+    void const*        data,
+    std::size_t const  bytes)
+{
+  arrays.push_back(data_array{where, name, type, components, static_cast<char const*>(data), bytes, {}});
+}
+
+char*
+vtu_file::add_owned_array(
+    section const      where,
+    std::string const& name,
+    char const*        type,
+    int const          components,
+    std::size_t const  bytes)
+{
+  arrays.push_back(data_array{where, name, type, components, nullptr, bytes, std::vector<char>(bytes)});
+  return arrays.back().owned.data();
+}
+
+void
+vtu_file::set_points(double const* x)
+{
+  add_array(POINTS_SECTION, "", "Float64", 3, x, std::size_t(points) * 3 * sizeof(double));
+}
+
+void
+vtu_file::set_cells(int const* connectivity, int const nodes_per_cell, std::uint8_t const cell_type)
+{
+  auto const n = std::size_t(cells);
+  add_array(CELLS_SECTION, "connectivity", "Int32", 1, connectivity, n * std::size_t(nodes_per_cell) * sizeof(int));
+  auto const offsets =
+      reinterpret_cast<std::int64_t*>(add_owned_array(CELLS_SECTION, "offsets", "Int64", 1, n * sizeof(std::int64_t)));
+  for (std::size_t cell = 0; cell < n; ++cell) offsets[cell] = std::int64_t(cell + 1) * nodes_per_cell;
+  auto const types = add_owned_array(CELLS_SECTION, "types", "UInt8", 1, n * sizeof(std::uint8_t));
+  std::fill(types, types + n, char(cell_type));
+}
+
+void
+vtu_file::set_vertex_cells()
+{
+  constexpr std::uint8_t vertex = 1;
+  auto const             n      = std::size_t(cells);
+  auto const             connectivity =
+      reinterpret_cast<int*>(add_owned_array(CELLS_SECTION, "connectivity", "Int32", 1, n * sizeof(int)));
+  for (std::size_t cell = 0; cell < n; ++cell) connectivity[cell] = int(cell);
+  auto const offsets =
+      reinterpret_cast<std::int64_t*>(add_owned_array(CELLS_SECTION, "offsets", "Int64", 1, n * sizeof(std::int64_t)));
+  for (std::size_t cell = 0; cell < n; ++cell) offsets[cell] = std::int64_t(cell + 1);
+  auto const types = add_owned_array(CELLS_SECTION, "types", "UInt8", 1, n * sizeof(std::uint8_t));
+  std::fill(types, types + n, char(vertex));
+}
+
+void
+vtu_file::add_point_data(std::string const& name, double const* data, int const components)
+{
+  add_array(POINT_DATA_SECTION, name, "Float64", components, data, std::size_t(points * components) * sizeof(double));
+}
+
+double*
+vtu_file::add_point_data(std::string const& name, int const components)
+{
+  auto const bytes = std::size_t(points * components) * sizeof(double);
+  return reinterpret_cast<double*>(add_owned_array(POINT_DATA_SECTION, name, "Float64", components, bytes));
+}
+
+void
+vtu_file::add_cell_data(std::string const& name, double const* data, int const components)
+{
+  add_array(CELL_DATA_SECTION, name, "Float64", components, data, std::size_t(cells * components) * sizeof(double));
+}
+
+void
+vtu_file::add_cell_data(std::string const& name, int const* data, int const components)
+{
+  add_array(CELL_DATA_SECTION, name, "Int32", components, data, std::size_t(cells * components) * sizeof(int));
+}
+
+double*
+vtu_file::add_cell_data(std::string const& name, int const components)
+{
+  auto const bytes = std::size_t(cells * components) * sizeof(double);
+  return reinterpret_cast<double*>(add_owned_array(CELL_DATA_SECTION, name, "Float64", components, bytes));
+}
+
+char const*
+vtu_file::array_data(data_array const& array) noexcept
+{
+  return array.owned.empty() ? array.data : array.owned.data();
+}
+
+#ifdef LGR_ENABLE_ZLIB
+static void
+append_header(std::vector<char>& payload, std::uint64_t const value)
+{
+  char bytes[sizeof(value)];
+  std::memcpy(bytes, &value, sizeof(value));
+  payload.insert(payload.end(), bytes, bytes + sizeof(value));
+}
+
+// A header of the block count, the block size, the size of a last partial block and the compressed size
+// of each block, followed by the compressed blocks.
+static std::vector<char>
+compress_array(char const* data, std::size_t const bytes)
+{
+  std::vector<char>          payload;
+  constexpr std::size_t      block_size = std::size_t(1) << 20;
+  auto const                 last_size  = bytes % block_size;
+  auto const                 blocks     = bytes / block_size + (last_size != 0 ? 1 : 0);
+  std::vector<std::uint64_t> compressed_sizes(blocks);
+  std::vector<char>          compressed;
+  for (std::size_t block = 0; block < blocks; ++block) {
+    auto const offset = block * block_size;
+    auto const size   = std::min(block_size, bytes - offset);
+    auto const start  = compressed.size();
+    auto       bound  = compressBound(uLong(size));
+    compressed.resize(start + bound);
+    auto const result = compress2(
+        reinterpret_cast<Bytef*>(compressed.data() + start),
+        &bound,
+        reinterpret_cast<Bytef const*>(data + offset),
+        uLong(size),
+        Z_BEST_SPEED);
+    if (result != Z_OK) HPC_ERROR_EXIT("zlib could not compress a VTU array");
+    compressed.resize(start + bound);
+    compressed_sizes[block] = bound;
+  }
+  append_header(payload, blocks);
+  append_header(payload, block_size);
+  append_header(payload, last_size);
+  for (auto const size : compressed_sizes) append_header(payload, size);
+  payload.insert(payload.end(), compressed.begin(), compressed.end());
+  return payload;
+}
+#else
+static std::vector<char>
+compress_array(char const*, std::size_t)
+{
+  return {};
+}
+#endif
+
+std::size_t
+vtu_file::write(std::string const& filename) const
+{
+  // raw arrays are written from their buffers after an 8 byte count; compressed ones from their payloads
+  std::vector<std::vector<char>> payloads(arrays.size());
+  std::vector<std::uint64_t>     offsets(arrays.size());
+  std::uint64_t                  offset = 0;
+  for (std::size_t i = 0; i < arrays.size(); ++i) {
+    offsets[i] = offset;
+    if (encoding == ZLIB_VTU_ENCODING) {
+      payloads[i] = compress_array(array_data(arrays[i]), arrays[i].bytes);
+      offset += payloads[i].size();
+    } else {
+      offset += sizeof(std::uint64_t) + arrays[i].bytes;
+    }
+  }
+  std::ofstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open()) HPC_ERROR_EXIT("could not open a VTU file for writing");
+  std::uint16_t const one           = 1;
+  auto const          little_endian = *reinterpret_cast<char const*>(&one) == 1;
+  stream << "<?xml version=\"1.0\"?>\n";
+  stream << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+         << (little_endian ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\"";
+  if (encoding == ZLIB_VTU_ENCODING) stream << " compressor=\"vtkZLibDataCompressor\"";
+  stream << ">\n";
+  stream << "<UnstructuredGrid>\n";
+  stream << "<Piece NumberOfPoints=\"" << points << "\" NumberOfCells=\"" << cells << "\">\n";
+  char const* section_tags[] = {"Points", "Cells", "PointData", "CellData"};
+  for (auto const where : {POINTS_SECTION, CELLS_SECTION, POINT_DATA_SECTION, CELL_DATA_SECTION}) {
+    stream << "<" << section_tags[where] << ">\n";
+    for (std::size_t i = 0; i < arrays.size(); ++i) {
+      auto const& array = arrays[i];
+      if (array.where != where) continue;
+      stream << "<DataArray type=\"" << array.type << "\"";
+      if (!array.name.empty()) stream << " Name=\"" << array.name << "\"";
+      stream << " NumberOfComponents=\"" << array.components << "\" format=\"appended\" offset=\"" << offsets[i]
+             << "\"/>\n";
+    }
+    stream << "</" << section_tags[where] << ">\n";
+  }
+  stream << "</Piece>\n";
+  stream << "</UnstructuredGrid>\n";
+  stream << "<AppendedData encoding=\"raw\">\n_";
+  for (std::size_t i = 0; i < arrays.size(); ++i) {
+    if (encoding == ZLIB_VTU_ENCODING) {
+      stream.write(payloads[i].data(), std::streamsize(payloads[i].size()));
+    } else {
+      std::uint64_t const bytes = arrays[i].bytes;
+      stream.write(reinterpret_cast<char const*>(&bytes), sizeof(bytes));
+      stream.write(array_data(arrays[i]), std::streamsize(arrays[i].bytes));
+    }
+  }
+  stream << "\n</AppendedData>\n";
+  stream << "</VTKFile>\n";
+  auto const written = std::size_t(stream.tellp());
+  stream.close();
+  if (!stream) HPC_ERROR_EXIT("could not write a VTU file");
+  return written;
+}
+
+}  // namespace lgr
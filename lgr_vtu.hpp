@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lgr {
+
+enum vtu_encoding
+{
+  // each appended array is its byte count followed by its bytes
+  RAW_VTU_ENCODING,
+  // each appended array is cut into blocks compressed with zlib, laid out as vtkZLibDataCompressor does
+  ZLIB_VTU_ENCODING,
+};
+
+// An unstructured grid in VTK's XML format whose arrays are appended in binary after the XML. The file only
+// keeps pointers to the arrays it is given, so raw output goes from the caller's buffers straight to the
+// stream and those buffers have to outlive write(); arrays that need reordering are gathered into buffers
+// that the file owns.
+class vtu_file
+{
+ public:
+  enum section
+  {
+    POINTS_SECTION,
+    CELLS_SECTION,
+    POINT_DATA_SECTION,
+    CELL_DATA_SECTION,
+  };
+
+ private:
+  class data_array
+  {
+   public:
+    section           where;
+    std::string       name;
+    char const*       type;
+    int               components;
+    char const*       data;
+    std::size_t       bytes;
+    std::vector<char> owned;
+  };
+  vtu_encoding            encoding;
+  std::int64_t            points;
+  std::int64_t            cells;
+  std::vector<data_array> arrays;
+  void
+  add_array(
+      section const      where,
+      std::string const& name,
+      char const*        type,
+      int const          components,
+      void const*        data,
+      std::size_t const  bytes);
+  char*
+  add_owned_array(
+      section const      where,
+      std::string const& name,
+      char const*        type,
+      int const          components,
+      std::size_t const  bytes);
+  static char const*
+  array_data(data_array const& array) noexcept;
+
+ public:
+  vtu_file(vtu_encoding const encoding_in, std::int64_t const points_in, std::int64_t const cells_in);
+  void
+  set_points(double const* x);
+  // cells of \p nodes_per_cell nodes each, all of the VTK cell type \p cell_type
+  void
+  set_cells(int const* connectivity, int const nodes_per_cell, std::uint8_t const cell_type);
+  // one vertex cell per point, for point clouds
+  void
+  set_vertex_cells();
+  void
+  add_point_data(std::string const& name, double const* data, int const components);
+  // a buffer of points * components doubles for the caller to fill before write()
+  double*
+  add_point_data(std::string const& name, int const components);
+  void
+  add_cell_data(std::string const& name, double const* data, int const components);
+  void
+  add_cell_data(std::string const& name, int const* data, int const components);
+  // a buffer of cells * components doubles for the caller to fill before write()
+  double*
+  add_cell_data(std::string const& name, int const components);
+  // returns the number of bytes written
+  std::size_t
+  write(std::string const& filename) const;
+};
+
+}  // namespace lgr
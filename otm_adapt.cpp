@@ -21,10 +21,10 @@ namespace lgr {
 
 void
 polar_lie_decompose(
-    hpc::device_array_vector<hpc::matrix3x3<double>, point_index> const& F,
-    hpc::device_array_vector<hpc::vector3<double>, point_index>&         r,
-    hpc::device_array_vector<hpc::matrix3x3<double>, point_index>&       u,
-    hpc::counting_range<point_index> const&                              source_range)
+    hpc::device_array_vector<hpc::matrix3x3<double>, point_index, tensor_layout> const& F,
+    hpc::device_array_vector<hpc::vector3<double>, point_index>&                        r,
+    hpc::device_array_vector<hpc::matrix3x3<double>, point_index>&                      u,
+    hpc::counting_range<point_index> const&                                             source_range)
 {
   auto const points_to_F  = F.cbegin();
   auto const index_to_r   = r.begin();
@@ -204,8 +204,8 @@ otm_populate_new_points(
     auto index_rp  = hpc::vector3<double>::zero();
     auto index_up  = hpc::matrix3x3<double>::zero();
     for (auto&& source_point : source_range) {
-      auto const K                       = points_to_K[source_point];
-      auto const G                       = points_to_G[source_point];
+      auto const K                       = points_to_K[source_point].load();
+      auto const G                       = points_to_G[source_point].load();
       auto const rho                     = points_to_rho[source_point];
       auto const ep                      = points_to_ep[source_point];
       auto const b                       = points_to_b[source_point].load();
@@ -1,5 +1,8 @@
+#include <hpc_thread_pool.hpp>
+#include <iostream>
 #include <lgr_exodus.hpp>
 #include <lgr_input.hpp>
+#include <lgr_print.hpp>
 #include <lgr_state.hpp>
 #include <otm_apps.hpp>
 #include <otm_meshless.hpp>
@@ -419,7 +422,12 @@ otm_taylor()
   in.enable_adapt                = false;
   in.max_node_neighbor_distance  = h_node_max;
   in.max_point_neighbor_distance = h_point_max;
+  auto& scheduler                = hpc::default_scheduler();
+  scheduler.reset_statistics();
+  scheduler.enable_timing(in.output_to_command_line);
   otm_run(in, s);
+  scheduler.enable_timing(false);
+  if (in.output_to_command_line) std::cout << "LOAD BALANCE:\n" << scheduler.statistics();
   return true;
 }
 
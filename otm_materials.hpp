@@ -39,6 +39,7 @@ HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
 variational_J2_point(
     hpc::deformation_gradient<double> const& F,
     j2::Properties const                     props,
+    j2::HardeningTable const                 table,
     hpc::time<double> const                  dt,
     hpc::stress<double>&                     sigma,
     hpc::pressure<double>&                   Keff,
@@ -68,7 +69,7 @@ variational_J2_point(
     Np = 1.5 * dev_M_tr / sigma_tr_eff;
   }
 
-  auto       S0 = j2::FlowStrength(props, eqps);
+  auto       S0 = j2::FlowStrength(props, table, eqps);
   auto const r0 = sigma_tr_eff - S0;
   auto       r  = r0;
 
@@ -87,8 +88,9 @@ variational_J2_point(
       auto ls_is_finished = false;
       auto delta_eqps0    = delta_eqps;
       merit_old           = r * r;
-      auto H  = j2::HardeningRate(props, eqps + delta_eqps) + j2::ViscoplasticHardeningRate(props, delta_eqps, dt);
-      auto dr = -3.0 * G - H;
+      auto H = j2::HardeningRate(props, table, eqps + delta_eqps) +
+               j2::ViscoplasticHardeningRate(props, delta_eqps, dt);
+      auto dr         = -3.0 * G - H;
       auto correction = -r / dr;
 
       // line search
@@ -106,7 +108,7 @@ variational_J2_point(
         ++line_search_iterations;
         delta_eqps = delta_eqps0 + alpha * correction;
         if (delta_eqps < 0) delta_eqps = 0;
-        auto Yeq          = j2::FlowStrength(props, eqps + delta_eqps);
+        auto Yeq          = j2::FlowStrength(props, table, eqps + delta_eqps);
         auto Yvis         = j2::ViscoplasticStress(props, delta_eqps, dt);
         auto residual     = sigma_tr_eff - 3.0 * G * delta_eqps - (Yeq + Yvis);
         merit_new         = residual * residual;
@@ -122,7 +124,7 @@ variational_J2_point(
           }
         }
       }
-      auto S    = j2::FlowStrength(props, eqps + delta_eqps) + j2::ViscoplasticStress(props, delta_eqps, dt);
+      auto S    = j2::FlowStrength(props, table, eqps + delta_eqps) + j2::ViscoplasticStress(props, delta_eqps, dt);
       r         = sigma_tr_eff - 3.0 * G * delta_eqps - S;
       converged = (std::abs(r / r0) < residual_tolerance) || (delta_eqps < deqps_tolerance);
       ++iters;
@@ -142,7 +144,7 @@ variational_J2_point(
 
   auto We_dev   = G * hpc::inner_product(dev_Ee, dev_Ee);
   auto psi_star = j2::ViscoplasticDualKineticPotential(props, delta_eqps, dt);
-  auto Wp       = j2::HardeningPotential(props, eqps);
+  auto Wp       = j2::HardeningPotential(props, table, eqps);
 
   sigma     = dev_sigma + p * hpc::matrix3x3<double>::identity();
   Keff      = K;
@@ -150,6 +152,165 @@ variational_J2_point(
   potential = We_vol + We_dev + Wp + psi_star;
 }
 
+// variational_J2_point with the power law hardening of \p props
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+variational_J2_point(
+    hpc::deformation_gradient<double> const& F,
+    j2::Properties const                     props,
+    hpc::time<double> const                  dt,
+    hpc::stress<double>&                     sigma,
+    hpc::pressure<double>&                   Keff,
+    hpc::pressure<double>&                   Geff,
+    hpc::energy_density<double>&             potential,
+    hpc::deformation_gradient<double>&       Fp,
+    hpc::strain<double>&                     eqps)
+{
+  variational_J2_point(F, props, j2::HardeningTable(), dt, sigma, Keff, Geff, potential, Fp, eqps);
+}
+
+#ifndef HPC_CUDA
+
+// \return law(lane) in the lanes of \p mask and zero elsewhere
+template <int W, class Law>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE hpc::simd<double, W>
+                  masked_lanes(hpc::simd_mask<double, W> const mask, Law const& law)
+{
+  hpc::simd<double, W> result(0.0);
+  for (int lane = 0; lane < W; ++lane) {
+    if (mask[lane]) result[lane] = law(lane);
+  }
+  return result;
+}
+
+// variational_J2_point for W points at once, one per lane. The trial state is computed in every lane,
+// then the lanes inside the yield surface are masked out and the return mapping iterates only while
+// some plastic lane has not converged. Keff and Geff are K and G in every lane and are not returned.
+template <int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+variational_J2_batch(
+    hpc::matrix3x3<hpc::simd<double, W>> const& F,
+    j2::Properties const                        props,
+    j2::HardeningTable const                    table,
+    hpc::time<double> const                     dt,
+    hpc::matrix3x3<hpc::simd<double, W>>&       sigma,
+    hpc::simd<double, W>&                       potential,
+    hpc::matrix3x3<hpc::simd<double, W>>&       Fp,
+    hpc::simd<double, W>&                       eqps)
+{
+  using batch  = hpc::simd<double, W>;
+  using tensor = hpc::matrix3x3<batch>;
+
+  auto const J    = determinant(F);
+  auto const Jm13 = 1.0 / cbrt(J);
+  auto const Jm23 = Jm13 * Jm13;
+  auto const logJ = log(J);
+
+  auto const& K = props.K;
+  auto const& G = props.G;
+
+  auto const We_vol = 0.5 * K * logJ * logJ;
+  auto const p      = K * logJ / J;
+
+  auto const Fe_tr        = F * hpc::inverse(Fp);
+  auto const dev_Ce_tr    = Jm23 * hpc::transpose(Fe_tr) * Fe_tr;
+  auto const dev_Ee_tr    = 0.5 * hpc::log(dev_Ce_tr);
+  auto const dev_M_tr     = 2.0 * G * dev_Ee_tr;
+  auto const sigma_tr_eff = std::sqrt(1.5) * norm(dev_M_tr);
+  auto const Np           = (1.5 / select(sigma_tr_eff > 0.0, sigma_tr_eff, batch(1.0))) * dev_M_tr;
+
+  auto const all_lanes = hpc::simd_mask<double, W>(true);
+  auto const S0 = masked_lanes(all_lanes, [&](int const lane) { return j2::FlowStrength(props, table, eqps[lane]); });
+  auto const r0 = sigma_tr_eff - S0;
+  auto       r  = r0;
+
+  batch      delta_eqps(0.0);
+  auto const residual_tolerance = 1e-10;
+  auto const deqps_tolerance    = 1e-10;
+  auto const plastic            = r0 > residual_tolerance;
+  if (any(plastic)) {
+    constexpr auto max_iters = 8;
+    auto           iters     = 0;
+    auto           active    = plastic;
+    while (any(active) && iters < max_iters) {
+      auto const delta_eqps0 = delta_eqps;
+      auto       merit_old   = r * r;
+      auto const H           = masked_lanes(active, [&](int const lane) {
+        return j2::HardeningRate(props, table, eqps[lane] + delta_eqps[lane]) +
+               j2::ViscoplasticHardeningRate(props, delta_eqps[lane], dt);
+      });
+      auto const dr          = -3.0 * G - H;
+      auto const correction  = -r / dr;
+
+      // line search, backtracking only the lanes that have not decreased the merit function yet
+      batch      alpha(1.0);
+      auto       searching        = active;
+      auto const backtrack_factor = 0.1;
+      auto const decrease_factor  = 1e-5;
+      for (int line_search_iterations = 0; line_search_iterations < 20 && any(searching); ++line_search_iterations) {
+        delta_eqps        = select(searching, max(delta_eqps0 + alpha * correction, batch(0.0)), delta_eqps);
+        auto const S      = masked_lanes(searching, [&](int const lane) {
+          return j2::FlowStrength(props, table, eqps[lane] + delta_eqps[lane]) +
+                 j2::ViscoplasticStress(props, delta_eqps[lane], dt);
+        });
+        auto const residual     = sigma_tr_eff - 3.0 * G * delta_eqps - S;
+        auto const merit_new    = residual * residual;
+        auto const decreased    = merit_new <= (1.0 - 2.0 * alpha * decrease_factor) * merit_old;
+        auto const backtracking = searching && !decreased;
+        auto const denominator  = select(backtracking, merit_new - merit_old + 2.0 * alpha * merit_old, batch(1.0));
+        auto const alpha_new    = alpha * alpha * merit_old / denominator;
+        merit_old               = select(searching && decreased, merit_new, merit_old);
+        alpha                   = select(backtracking, max(alpha_new, backtrack_factor * alpha), alpha);
+        searching               = backtracking;
+      }
+      auto const S = masked_lanes(active, [&](int const lane) {
+        return j2::FlowStrength(props, table, eqps[lane] + delta_eqps[lane]) +
+               j2::ViscoplasticStress(props, delta_eqps[lane], dt);
+      });
+      r            = select(active, sigma_tr_eff - 3.0 * G * delta_eqps - S, r);
+      auto const converged =
+          (abs(r / select(active, r0, batch(1.0))) < residual_tolerance) || (delta_eqps < deqps_tolerance);
+      active = active && !converged;
+      ++iters;
+    }
+    if (any(active)) {
+      HPC_DUMP("variational J2 did not converge to specified tolerance 1.0e-10\n");
+    }
+    Fp = select(plastic, hpc::exp(delta_eqps * Np) * Fp, Fp);
+    eqps += delta_eqps;
+  }
+  auto const Ee_correction = delta_eqps * Np;
+  auto const dev_Ee        = dev_Ee_tr - Ee_correction;
+  auto const dev_sigma =
+      (1.0 / J) * hpc::transpose(hpc::inverse(Fe_tr)) * (dev_M_tr - 2.0 * G * Ee_correction) * hpc::transpose(Fe_tr);
+
+  auto const We_dev   = G * hpc::inner_product(dev_Ee, dev_Ee);
+  auto const psi_star = masked_lanes(plastic, [&](int const lane) {
+    return j2::ViscoplasticDualKineticPotential(props, delta_eqps[lane], dt);
+  });
+  auto const Wp =
+      masked_lanes(all_lanes, [&](int const lane) { return j2::HardeningPotential(props, table, eqps[lane]); });
+
+  sigma     = dev_sigma + p * tensor::identity();
+  potential = We_vol + We_dev + Wp + psi_star;
+}
+
+// variational_J2_batch with the power law hardening of \p props
+template <int W>
+HPC_ALWAYS_INLINE HPC_HOST_DEVICE void
+variational_J2_batch(
+    hpc::matrix3x3<hpc::simd<double, W>> const& F,
+    j2::Properties const                        props,
+    hpc::time<double> const                     dt,
+    hpc::matrix3x3<hpc::simd<double, W>>&       sigma,
+    hpc::simd<double, W>&                       potential,
+    hpc::matrix3x3<hpc::simd<double, W>>&       Fp,
+    hpc::simd<double, W>&                       eqps)
+{
+  variational_J2_batch(F, props, j2::HardeningTable(), dt, sigma, potential, Fp, eqps);
+}
+
+#endif
+
 // Mie–Grüneisen EOS. Adapted from LGR v2
 //
 // The locus of shocked states comprises a Hugoniot curve for the material.
@@ -15,6 +15,7 @@
 #include <lgr_input.hpp>
 #include <lgr_physics_util.hpp>
 #include <lgr_state.hpp>
+#include <lgr_timers.hpp>
 #include <otm_adapt.hpp>
 #include <otm_distance.hpp>
 #include <otm_distance_util.hpp>
@@ -471,9 +472,75 @@ otm_update_reference(state& s)
   hpc::for_each(hpc::device_policy(), s.points, functor);
 }
 
+#ifndef HPC_CUDA
+
+// otm_update_material_state for J2 materials over tiles of native_simd<double>::size() consecutive points,
+// with the return mapping of a tile done in simd lanes
+inline void
+otm_batched_variational_J2(input const& in, state& s, material_index const material)
+{
+  using batch         = hpc::native_simd<double>;
+  constexpr int width = batch::size();
+
+  auto const dt                = s.dt;
+  auto const points_to_F_total = s.F_total.cbegin();
+  auto const points_to_sigma   = s.sigma_full.begin();
+  auto const points_to_K       = s.K.begin();
+  auto const points_to_G       = s.G.begin();
+  auto const points_to_W       = s.potential_density.begin();
+  auto const points_to_Fp      = s.Fp_total.begin();
+  auto const points_to_ep      = s.ep.begin();
+  auto const point_count       = int(s.points.size());
+  auto const tiles             = hpc::counting_range<int>((point_count + width - 1) / width);
+  auto const table             = in.hardening_curve[material].table();
+  j2::Properties const props{
+      in.K0[material],
+      in.G0[material],
+      in.Y0[material],
+      in.n[material],
+      in.eps0[material],
+      in.Svis0[material],
+      in.m[material],
+      in.eps_dot0[material]};
+  auto functor = [=] HPC_DEVICE(int const tile) {
+    auto const first = tile * width;
+    auto const lanes = hpc::min(width, point_count - first);
+    auto       F     = hpc::matrix3x3<batch>::zero();
+    auto       Fp    = hpc::matrix3x3<batch>::zero();
+    auto       ep    = batch(0.0);
+    for (int lane = 0; lane < width; ++lane) {
+      auto const point = point_index(first + hpc::min(lane, lanes - 1));
+      hpc::set_lane(F, lane, points_to_F_total[point].load());
+      hpc::set_lane(Fp, lane, points_to_Fp[point].load());
+      ep[lane] = points_to_ep[point];
+    }
+    auto sigma = hpc::matrix3x3<batch>::zero();
+    auto W     = batch(0.0);
+    variational_J2_batch(F, props, table, dt, sigma, W, Fp, ep);
+    for (int lane = 0; lane < lanes; ++lane) {
+      auto const point       = point_index(first + lane);
+      points_to_sigma[point] = hpc::get_lane(sigma, lane);
+      points_to_K[point]     = props.K;
+      points_to_G[point]     = props.G;
+      points_to_W[point]     = W[lane];
+      points_to_Fp[point]    = hpc::get_lane(Fp, lane);
+      points_to_ep[point]    = ep[lane];
+    }
+  };
+  hpc::for_each(hpc::device_policy(), tiles, functor);
+}
+
+#endif
+
 void
 otm_update_material_state(input const& in, state& s, material_index const material)
 {
+#ifndef HPC_CUDA
+  if (in.enable_batched_J2 && in.enable_variational_J2[material] && !in.enable_neo_Hookean[material]) {
+    otm_batched_variational_J2(in, s, material);
+    return;
+  }
+#endif
   auto const dt                = s.dt;
   auto const points_to_F_total = s.F_total.cbegin();
   auto const points_to_sigma   = s.sigma_full.begin();
@@ -490,6 +557,7 @@ otm_update_material_state(input const& in, state& s, material_index const materi
   auto const Svis0             = in.Svis0[material];
   auto const m                 = in.m[material];
   auto const eps_dot0          = in.eps_dot0[material];
+  auto const table             = in.hardening_curve[material].table();
   auto const is_neo_hookean    = in.enable_neo_Hookean[material];
   auto const is_variational_J2 = in.enable_variational_J2[material];
   auto       functor           = [=] HPC_DEVICE(point_index const point) {
@@ -505,7 +573,7 @@ otm_update_material_state(input const& in, state& s, material_index const materi
       j2::Properties props{K, G, Y0, n, eps0, Svis0, m, eps_dot0};
       auto           Fp = points_to_Fp[point].load();
       auto           ep = points_to_ep[point];
-      variational_J2_point(F, props, dt, sigma, Keff, Geff, W, Fp, ep);
+      variational_J2_point(F, props, table, dt, sigma, Keff, Geff, W, Fp, ep);
       points_to_Fp[point] = Fp;
       points_to_ep[point] = ep;
     }
@@ -683,6 +751,7 @@ otm_allocate_state(input const& in, state& s)
 HPC_NOINLINE inline hpc::energy<double>
 compute_kinetic_energy(const state& s)
 {
+  LGR_TIME_KERNEL("compute_kinetic_energy", "nodes", s.nodes.size());
   auto const nodes_to_lm   = s.lm.cbegin();
   auto const nodes_to_mass = s.mass.cbegin();
   auto       functor       = [=] HPC_DEVICE(node_index const node) {
@@ -698,6 +767,7 @@ compute_kinetic_energy(const state& s)
 HPC_NOINLINE inline hpc::energy<double>
 compute_free_energy(const state& s)
 {
+  LGR_TIME_KERNEL("compute_free_energy", "points", s.points.size());
   auto const points_to_potential_density = s.potential_density.cbegin();
   auto const points_to_volume            = s.V.cbegin();
   auto       functor                     = [=] HPC_DEVICE(point_index const point) {
@@ -713,12 +783,13 @@ compute_free_energy(const state& s)
 HPC_NOINLINE inline void
 update_point_dt(state& s)
 {
+  LGR_TIME_KERNEL("update_point_dt", "points", s.points.size());
   auto const points_to_c             = s.c.cbegin();
   auto const points_to_dt            = s.element_dt.begin();
   auto const points_to_neighbor_dist = s.nearest_point_neighbor_dist.cbegin();
   auto       functor                 = [=] HPC_DEVICE(point_index const point) {
     auto const h_min = points_to_neighbor_dist[point];
-    auto const c     = points_to_c[point];
+    auto const c     = points_to_c[point].load();
     auto const dt    = h_min / c;
     assert(dt > 0.0);
     points_to_dt[point] = dt;
@@ -781,6 +852,10 @@ otm_update_time(input const& in, state& s)
 void
 otm_time_integrator_step(input const& in, state& s)
 {
+  hpc::pool_scope<hpc::device_memory> const step_scratch;
+#ifdef HPC_CUDA
+  hpc::pool_scope<hpc::pinned_memory> const step_pinned_scratch;
+#endif
   otm_update_nodal_mass(s);
   otm_update_nodal_momentum(s);
   otm_update_nodal_force(s);
@@ -807,7 +882,8 @@ otm_set_beta(double gamma, state& s)
 void
 otm_run(input const& in, state& s)
 {
-  lgr::otm_file_writer output_file(in.name);
+  lgr::otm_file_writer output_file(in.name, in.output_format);
+  reset_kernel_timings();
   std::cout << std::scientific << std::setprecision(17);
   auto const num_file_output_periods = in.num_file_output_periods;
   auto const file_output_period =
@@ -871,5 +947,7 @@ otm_run(input const& in, state& s)
       ++s.n;
     }
   }
+  output_file.finish();
+  report_kernel_timings(in.output_to_command_line, in.kernel_timings_file);
 }
 }  // namespace lgr
@@ -8,6 +8,7 @@
 #include <lgr_vtk_util.hpp>
 #include <otm_vtk.hpp>
 #include <sstream>
+#include <utility>
 
 namespace lgr {
 
@@ -61,9 +62,49 @@ otm_file_writer::capture(state const& s)
   }
 }
 
-void
-otm_file_writer::write(int const file_output_index)
+// the nodes and the points each as a cloud of vertex cells
+static std::size_t
+write_otm_vtu(
+    otm_host_pinned_output_state const& s,
+    vtu_encoding const                  encoding,
+    std::string const&                  prefix,
+    int const                           index)
 {
+  vtu_file node_file(encoding, hpc::weaken(s.nodes.size()), hpc::weaken(s.nodes.size()));
+  node_file.set_points(vtu_doubles(s.x));
+  node_file.set_vertex_cells();
+  node_file.add_point_data("node_position", vtu_doubles(s.x), 3);
+  node_file.add_point_data("node_displacement", vtu_doubles(s.u), 3);
+  node_file.add_point_data("node_velocity", vtu_doubles(s.v), 3);
+  node_file.add_point_data("node_mass", vtu_doubles(s.mass), 1);
+  auto const node_bytes = node_file.write(vtu_output_filename(prefix + "_nodes", index));
+  vtu_file   point_file(encoding, hpc::weaken(s.points.size()), hpc::weaken(s.points.size()));
+  point_file.set_points(vtu_doubles(s.xp));
+  point_file.set_vertex_cells();
+  point_file.add_point_data("point_position", vtu_doubles(s.xp), 3);
+  point_file.add_point_data("density", vtu_doubles(s.rho), 1);
+  point_file.add_point_data("volume", vtu_doubles(s.V), 1);
+  add_vtu_full_tensors(point_file, "sigma", s.sigma);
+  add_vtu_full_tensors(point_file, "deformation_gradient", s.F_total);
+  add_vtu_scalars(point_file, "G", s.G);
+  add_vtu_scalars(point_file, "K", s.K);
+  point_file.add_point_data("potential_density", vtu_doubles(s.potential_density), 1);
+  if (s.Fp_total.size() > 0) add_vtu_full_tensors(point_file, "plastic_deformation_gradient", s.Fp_total);
+  if (s.ep.size() > 0) point_file.add_point_data("ep", vtu_doubles(s.ep), 1);
+  return node_bytes + point_file.write(vtu_output_filename(prefix + "_points", index));
+}
+
+static std::size_t
+write_otm_vtk(
+    otm_host_pinned_output_state const& host_s,
+    output_format_kind const            format,
+    std::string const&                  prefix,
+    int const                           file_output_index)
+{
+  if (format != ASCII_VTK_OUTPUT_FORMAT) {
+    auto const encoding = (format == ZLIB_VTU_OUTPUT_FORMAT) ? ZLIB_VTU_ENCODING : RAW_VTU_ENCODING;
+    return write_otm_vtu(host_s, encoding, prefix, file_output_index);
+  }
   auto node_stream  = make_vtk_output_stream(prefix + "_nodes", file_output_index);
   auto point_stream = make_vtk_output_stream(prefix + "_points", file_output_index);
 
@@ -76,6 +117,7 @@ otm_file_writer::write(int const file_output_index)
   write_vtk_vectors(node_stream, "node_displacement", host_s.u);
   write_vtk_vectors(node_stream, "node_velocity", host_s.v);
   write_vtk_scalars(node_stream, "node_mass", host_s.mass);
+  auto const node_bytes = std::size_t(node_stream.tellp());
   node_stream.close();
 
   start_vtk_unstructured_grid_file(point_stream);
@@ -97,7 +139,23 @@ otm_file_writer::write(int const file_output_index)
   if (host_s.ep.size() > 0) {
     write_vtk_scalars(point_stream, "ep", host_s.ep);
   }
+  auto const point_bytes = std::size_t(point_stream.tellp());
   point_stream.close();
+  return node_bytes + point_bytes;
+}
+
+void
+otm_file_writer::write(int const file_output_index)
+{
+  writer.finish();
+  std::swap(host_s, writing);
+  writer.submit([this, file_output_index] { return write_otm_vtk(writing, format, prefix, file_output_index); });
+}
+
+std::size_t
+otm_file_writer::finish()
+{
+  return writer.finish();
 }
 
 void
@@ -144,8 +202,8 @@ otm_file_writer::to_console()
   auto const points_to_G     = host_s.G.cbegin();
   auto       print_sigma     = [=] HPC_HOST(lgr::point_index const point) {
     auto const sigma = points_to_sigma[point].load();
-    auto const K     = points_to_K[point];
-    auto const G     = points_to_G[point];
+    auto const K     = points_to_K[point].load();
+    auto const G     = points_to_G[point].load();
     std::cout << "point: " << point << ", K: " << K << ", G: " << G << ", sigma:\n" << sigma;
   };
   hpc::for_each(hpc::host_policy(), host_s.points, print_sigma);
@@ -3,6 +3,9 @@
 #include <hpc_array_vector.hpp>
 #include <hpc_dimensional.hpp>
 #include <hpc_range.hpp>
+#include <lgr_background_writer.hpp>
+#include <lgr_input.hpp>
+#include <lgr_layout.hpp>
 #include <lgr_mesh_indices.hpp>
 #include <otm_host_pinned_state.hpp>
 #include <string>
@@ -22,31 +25,43 @@ struct otm_host_pinned_output_state : public otm_host_pinned_state
   hpc::pinned_array_vector<hpc::velocity<double>, node_index>     v;
   hpc::pinned_vector<hpc::mass<double>, node_index>               mass;
 
-  hpc::pinned_array_vector<hpc::deformation_gradient<double>, point_index> F_total;
-  hpc::pinned_array_vector<hpc::deformation_gradient<double>, point_index> Fp_total;
-  hpc::pinned_array_vector<hpc::stress<double>, point_index>               sigma;
-  hpc::pinned_vector<hpc::pressure<double>, point_index>                   K;
-  hpc::pinned_vector<hpc::pressure<double>, point_index>                   G;
-  hpc::pinned_vector<hpc::strain<double>, point_index>                     ep;
-  hpc::pinned_vector<hpc::energy_density<double>, point_index>             potential_density;
+  hpc::pinned_array_vector<hpc::deformation_gradient<double>, point_index, tensor_layout>         F_total;
+  hpc::pinned_array_vector<hpc::deformation_gradient<double>, point_index, tensor_layout>         Fp_total;
+  hpc::pinned_array_vector<hpc::stress<double>, point_index>                                      sigma;
+  hpc::pinned_array_vector<hpc::pressure<double>, point_index, hpc::layout::right, point_storage> K;
+  hpc::pinned_array_vector<hpc::pressure<double>, point_index, hpc::layout::right, point_storage> G;
+  hpc::pinned_vector<hpc::strain<double>, point_index>                                            ep;
+  hpc::pinned_vector<hpc::energy_density<double>, point_index>                                    potential_density;
 };
 
+// Double buffered like file_writer: write() hands host_s over to a background thread.
 class otm_file_writer
 {
-  std::string prefix;
+  std::string                  prefix;
+  output_format_kind           format;
+  otm_host_pinned_output_state writing;
 
  public:
-  otm_file_writer(std::string const& prefix_in) : prefix(prefix_in)
+  otm_file_writer(std::string const& prefix_in, output_format_kind const format_in = ASCII_VTK_OUTPUT_FORMAT)
+      : prefix(prefix_in), format(format_in)
   {
   }
   void
   capture(state const& s);
+  // waits for the previous write to finish and starts writing the captured state
   void
   write(int const file_output_index);
+  // waits for the writes started so far and returns the number of bytes they wrote
+  std::size_t
+  finish();
   void
   to_console();
 
   otm_host_pinned_output_state host_s;
+
+ private:
+  // declared last so that its thread is joined before the states it writes go away
+  background_writer writer;
 };
 
 }  // namespace lgr
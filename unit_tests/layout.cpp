@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <hpc_array_vector.hpp>
+#include <hpc_execution.hpp>
+#include <hpc_matrix3x3.hpp>
+#include <hpc_vector3.hpp>
+
+namespace {
+
+// not a multiple of either block width, so the last block is partially filled
+constexpr std::ptrdiff_t layout_test_size = 13;
+
+hpc::matrix3x3<double>
+layout_test_value(std::ptrdiff_t const i)
+{
+  auto const x = 10.0 * double(i);
+  return hpc::matrix3x3<double>(x, x + 1, x + 2, x + 3, x + 4, x + 5, x + 6, x + 7, x + 8);
+}
+
+template <hpc::layout L>
+void
+check_array_vector_layout()
+{
+  hpc::host_array_vector<hpc::matrix3x3<double>, std::ptrdiff_t, L> tensors(layout_test_size);
+  ASSERT_EQ(tensors.size(), layout_test_size);
+  ASSERT_EQ(tensors.end() - tensors.begin(), layout_test_size);
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    tensors[i] = layout_test_value(i);
+  }
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    ASSERT_EQ(hpc::norm(tensors[i].load() - layout_test_value(i)), 0.0);
+  }
+  hpc::host_array_vector<hpc::matrix3x3<double>> copied(layout_test_size);
+  hpc::copy(hpc::serial_policy(), tensors, copied);
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    ASSERT_EQ(hpc::norm(copied[i].load() - layout_test_value(i)), 0.0);
+  }
+}
+
+}  // namespace
+
+TEST(layout, padded_size_rounds_up_to_whole_blocks)
+{
+  ASSERT_EQ(hpc::padded_size(hpc::layout::right, 13), 13);
+  ASSERT_EQ(hpc::padded_size(hpc::layout::blocked4, 13), 16);
+  ASSERT_EQ(hpc::padded_size(hpc::layout::blocked8, 13), 16);
+  ASSERT_EQ(hpc::padded_size(hpc::layout::blocked8, 16), 16);
+}
+
+TEST(layout, array_vector_loads_what_it_stores)
+{
+  check_array_vector_layout<hpc::layout::right>();
+  check_array_vector_layout<hpc::layout::blocked4>();
+  check_array_vector_layout<hpc::layout::blocked8>();
+}
+
+TEST(layout, blocked_array_vector_interleaves_rows_of_a_block)
+{
+  constexpr std::ptrdiff_t                                                             width = 4;
+  hpc::host_array_vector<hpc::matrix3x3<double>, std::ptrdiff_t, hpc::layout::blocked4> tensors(layout_test_size);
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    tensors[i] = layout_test_value(i);
+  }
+  auto const data = tensors.data();
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    auto const block = i / width;
+    auto const lane  = i % width;
+    for (std::ptrdiff_t component = 0; component < 9; ++component) {
+      ASSERT_EQ(data[(block * 9 + component) * width + lane], 10.0 * double(i) + double(component));
+    }
+  }
+}
+
+TEST(layout, float_storage_rounds_each_component_to_float)
+{
+  hpc::host_array_vector<hpc::matrix3x3<double>, std::ptrdiff_t, hpc::layout::blocked4, float> tensors(
+      layout_test_size);
+  ASSERT_EQ(sizeof(*tensors.data()), sizeof(float));
+  auto const third = hpc::matrix3x3<double>::identity() / 3.0;
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    tensors[i] = layout_test_value(i) + third;
+  }
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    auto const expected = layout_test_value(i) + third;
+    auto const loaded   = tensors[i].load();
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 3; ++k) {
+        ASSERT_EQ(loaded(j, k), double(float(expected(j, k))));
+      }
+    }
+  }
+}
+
+TEST(layout, float_storage_copies_to_and_from_double_storage)
+{
+  hpc::host_array_vector<hpc::vector3<double>, std::ptrdiff_t, hpc::layout::right, float> narrow(layout_test_size);
+  hpc::host_array_vector<hpc::vector3<double>>                                           wide(layout_test_size);
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    wide[i] = hpc::vector3<double>(1.0, 2.0, 3.0) / double(i + 1);
+  }
+  hpc::copy(hpc::serial_policy(), wide, narrow);
+  hpc::host_array_vector<hpc::vector3<double>> round_trip(layout_test_size);
+  hpc::copy(hpc::serial_policy(), narrow, round_trip);
+  for (std::ptrdiff_t i = 0; i < layout_test_size; ++i) {
+    auto const expected = wide[i].load();
+    auto const loaded   = round_trip[i].load();
+    ASSERT_LE(hpc::norm(loaded - expected), hpc::machine_epsilon<float>() * hpc::norm(expected));
+  }
+}
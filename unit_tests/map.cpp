@@ -17,21 +17,36 @@
 #include <otm_util.hpp>
 #include <unit_tests/otm_unit_mesh.hpp>
 
-template <typename T, typename I>
+// T::zero() for the array types, T(0.0) for the scalars an array_vector may also hold
+template <typename T>
+auto
+zero_value(int) -> decltype(T::zero())
+{
+  return T::zero();
+}
+
+template <typename T>
+T
+zero_value(long)
+{
+  return T(0.0);
+}
+
+template <typename T, typename I, hpc::layout L, typename S>
 void
-resize_preserve(hpc::device_array_vector<T, I>& v, I const new_size)
+resize_preserve(hpc::device_array_vector<T, I, L, S>& v, I const new_size)
 {
   auto const old_size = v.size();
   if (old_size == new_size) return;
-  hpc::pinned_array_vector<T, I> host_old(old_size);
+  hpc::pinned_array_vector<T, I, L, S> host_old(old_size);
   hpc::copy(v, host_old);
   v.resize(new_size);
-  hpc::pinned_array_vector<T, I> host_new(new_size);
+  hpc::pinned_array_vector<T, I, L, S> host_new(new_size);
   for (auto i = 0; i < std::min(old_size, new_size); ++i) {
     host_new[i] = host_old[i].load();
   }
   for (auto i = old_size; i < new_size; ++i) {
-    host_new[i] = T::zero();
+    host_new[i] = zero_value<T>(0);
   }
   hpc::copy(host_new, v);
 }
@@ -132,8 +147,10 @@ TEST(map, maxent_populate_points)
   resize_preserve(s.Fp_total, num_points_new);
   lgr::otm_populate_new_points(s, 0, num_points_old, num_points_old, num_points_new);
   hpc::pinned_array_vector<hpc::position<double>, lgr::point_index>             xp(num_points_new);
-  hpc::pinned_vector<hpc::pressure<double>, lgr::point_index>                   K(num_points_new);
-  hpc::pinned_vector<hpc::pressure<double>, lgr::point_index>                   G(num_points_new);
+  hpc::pinned_array_vector<hpc::pressure<double>, lgr::point_index, hpc::layout::right, lgr::point_storage> K(
+      num_points_new);
+  hpc::pinned_array_vector<hpc::pressure<double>, lgr::point_index, hpc::layout::right, lgr::point_storage> G(
+      num_points_new);
   hpc::pinned_vector<hpc::density<double>, lgr::point_index>                    rho(num_points_new);
   hpc::pinned_vector<hpc::strain<double>, lgr::point_index>                     ep(num_points_new);
   hpc::pinned_array_vector<hpc::acceleration<double>, lgr::point_index>         b(num_points_new);
@@ -148,8 +165,8 @@ TEST(map, maxent_populate_points)
   hpc::copy(s.V, V);
   hpc::copy(s.F_total, F);
   hpc::copy(s.Fp_total, Fp);
-  auto const error_K   = std::abs(K[num_points_new - 1] / K0 - 1.0);
-  auto const error_G   = std::abs(G[num_points_new - 1] / G0 - 1.0);
+  auto const error_K   = std::abs(K[num_points_new - 1].load() / K0 - 1.0);
+  auto const error_G   = std::abs(G[num_points_new - 1].load() / G0 - 1.0);
   auto const error_rho = std::abs(rho[num_points_new - 1] / rho0 - 1.0);
   auto const error_ep  = std::abs(ep[num_points_new - 1] / ep0 - 1.0);
   auto const error_b   = hpc::norm(b[num_points_new - 1].load() - b0) / hpc::norm(b0);
@@ -186,15 +203,15 @@ TEST(map, align_rotation_vectors)
 
 TEST(map, polar_lie_decompose)
 {
-  auto const                                                         range_begin = lgr::point_index(0);
-  auto const                                                         range_end   = lgr::point_index(2);
-  hpc::counting_range<lgr::point_index>                              range(range_begin, range_end);
-  hpc::pinned_array_vector<hpc::matrix3x3<double>, lgr::point_index> host_F(range_end);
-  hpc::device_array_vector<hpc::matrix3x3<double>, lgr::point_index> F(range_end);
-  hpc::device_array_vector<hpc::vector3<double>, lgr::point_index>   r(range_end);
-  hpc::device_array_vector<hpc::matrix3x3<double>, lgr::point_index> u(range_end);
-  auto const                                                         r1 = hpc::vector3<double>(0.1, 0.2, 0.3);
-  auto const                                                         r2 = hpc::vector3<double>(0.4, 0.5, 0.6);
+  auto const range_begin = lgr::point_index(0);
+  auto const range_end   = lgr::point_index(2);
+  hpc::counting_range<lgr::point_index>                                                  range(range_begin, range_end);
+  hpc::pinned_array_vector<hpc::matrix3x3<double>, lgr::point_index, lgr::tensor_layout> host_F(range_end);
+  hpc::device_array_vector<hpc::matrix3x3<double>, lgr::point_index, lgr::tensor_layout> F(range_end);
+  hpc::device_array_vector<hpc::vector3<double>, lgr::point_index>                       r(range_end);
+  hpc::device_array_vector<hpc::matrix3x3<double>, lgr::point_index>                     u(range_end);
+  auto const r1 = hpc::vector3<double>(0.1, 0.2, 0.3);
+  auto const r2 = hpc::vector3<double>(0.4, 0.5, 0.6);
   auto const u1 = hpc::matrix3x3<double>(-0.1, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.1);
   auto const u2 = hpc::matrix3x3<double>(1.5, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.5);
   auto const R1 = hpc::rotation_tensor_from_rotation_vector(r1);
@@ -5,6 +5,7 @@
 #include <hpc_matrix3x3.hpp>
 #include <iostream>
 #include <j2/hardening.hpp>
+#include <j2/tabulated_hardening.hpp>
 #include <otm_materials.hpp>
 
 TEST(materials, neohookean_point_consistency)
@@ -128,6 +129,63 @@ TEST(materials, J2_point_consistency)
   ASSERT_LE(error, tol);
 }
 
+#ifndef HPC_CUDA
+
+TEST(materials, J2_batch_matches_point)
+{
+  using Batch = hpc::native_simd<double>;
+  constexpr int W{Batch::size()};
+
+  double const              K{(400.0 / 3.0) * 1e9};
+  double const              G{80.0e9};
+  double const              Y0{350e6};
+  double const              n{4.0};
+  double const              eps0{1e-2};
+  double const              Svis0{Y0};
+  double const              m{2.0};
+  double const              eps_dot0{1e-1};
+  lgr::j2::Properties const props{
+      .K = K, .G = G, .Y0 = Y0, .n = n, .eps0 = eps0, .Svis0 = Svis0, .m = m, .eps_dot0 = eps_dot0};
+
+  double const dt = 1.0e-2;
+
+  hpc::matrix3x3<double> const G0(0.3, -0.1, 0.2, 0.05, -0.2, 0.1, -0.15, 0.25, 0.1);
+
+  // even lanes load plastically, odd lanes stay inside the yield surface
+  auto F_batch   = hpc::matrix3x3<Batch>::zero();
+  auto Fp_batch  = hpc::matrix3x3<Batch>::zero();
+  auto eps_batch = Batch(0.0);
+  for (int lane = 0; lane < W; ++lane) {
+    double const scale = (lane % 2 == 0) ? 1.0e-2 * (lane + 1) : 1.0e-4;
+    auto const   Fp    = hpc::exp(1.0e-3 * lane * G0);
+    hpc::set_lane(F_batch, lane, hpc::exp(scale * G0) * Fp);
+    hpc::set_lane(Fp_batch, lane, Fp);
+    eps_batch[lane] = 1.0e-3 * lane;
+  }
+
+  auto  sigma_batch = hpc::matrix3x3<Batch>::zero();
+  Batch W_batch(0.0);
+  auto  Fp_new_batch  = Fp_batch;
+  auto  eps_new_batch = eps_batch;
+  lgr::variational_J2_batch(F_batch, props, dt, sigma_batch, W_batch, Fp_new_batch, eps_new_batch);
+
+  for (int lane = 0; lane < W; ++lane) {
+    auto   sigma(hpc::matrix3x3<double>::zero());
+    double Keff, Geff, potential;
+    auto   Fp   = hpc::get_lane(Fp_batch, lane);
+    double eqps = eps_batch[lane];
+    lgr::variational_J2_point(hpc::get_lane(F_batch, lane), props, dt, sigma, Keff, Geff, potential, Fp, eqps);
+
+    EXPECT_EQ(eqps > eps_batch[lane], lane % 2 == 0);
+    EXPECT_LE(hpc::norm(hpc::get_lane(sigma_batch, lane) - sigma), 1.0e-10 * hpc::norm(sigma));
+    EXPECT_LE(hpc::norm(hpc::get_lane(Fp_new_batch, lane) - Fp), 1.0e-12);
+    EXPECT_NEAR(eps_new_batch[lane], eqps, 1.0e-14);
+    EXPECT_NEAR(W_batch[lane], potential, 1.0e-10 * std::abs(potential));
+  }
+}
+
+#endif
+
 TEST(materials, power_law_hardening)
 {
   double const              K{1.0e9};
@@ -213,3 +271,104 @@ TEST(materials, power_law_rate_sensitivity)
 
   ASSERT_LE(error, tol);
 }
+
+TEST(materials, tabulated_power_law_hardening)
+{
+  double const              K{1.0e9};
+  double const              G{1.0e9};
+  double const              Y0{10e9};
+  double const              n{4.0};
+  double const              eps0{1e-3};
+  double const              Svis0{0};
+  double const              m{1.0};
+  double const              eps_dot0{1e-3};
+  lgr::j2::Properties const props{
+      .K = K, .G = G, .Y0 = Y0, .n = n, .eps0 = eps0, .Svis0 = Svis0, .m = m, .eps_dot0 = eps_dot0};
+
+  double const tolerance = 1.0e-8;
+  auto const   curve     = lgr::j2::TabulatePowerLaw(props, 1.0, tolerance);
+  auto const   table     = curve.host_table();
+  ASSERT_GT(curve.size(), 2);
+  ASSERT_LT(curve.size(), 1000);
+
+  double const h = 1e-7;
+  for (double eqps = 1.0e-5; eqps < 2.0; eqps *= 1.3) {
+    double const S = lgr::j2::FlowStrength(props, table, eqps);
+    double const H = lgr::j2::HardeningRate(props, table, eqps);
+    if (eqps < 1.0) {
+      EXPECT_LE(std::abs(S - lgr::j2::FlowStrength(props, eqps)), 4.0 * tolerance * S);
+      EXPECT_LE(std::abs(lgr::j2::HardeningPotential(props, table, eqps) - lgr::j2::HardeningPotential(props, eqps)),
+                4.0 * tolerance * S * eqps);
+    }
+    double const S_h = 0.5 * (lgr::j2::HardeningPotential(props, table, eqps + h) -
+                              lgr::j2::HardeningPotential(props, table, eqps - h)) /
+                       h;
+    double const H_h =
+        0.5 * (lgr::j2::FlowStrength(props, table, eqps + h) - lgr::j2::FlowStrength(props, table, eqps - h)) / h;
+    EXPECT_LE(std::abs(S_h - S), 1.0e-6 * S);
+    EXPECT_LE(std::abs(H_h - H), 1.0e-5 * H);
+  }
+}
+
+TEST(materials, tabulated_curve_hardening)
+{
+  lgr::j2::Properties const props{};
+  std::vector<double> const eqps{0.0, 0.01, 0.05, 0.2, 0.5};
+  std::vector<double> const strength{300e6, 350e6, 380e6, 380e6, 400e6};
+  auto const                curve = lgr::j2::TabulateCurve(eqps, strength);
+  auto const                table = curve.host_table();
+
+  for (std::size_t i = 0; i < eqps.size(); ++i) {
+    EXPECT_DOUBLE_EQ(lgr::j2::FlowStrength(props, table, eqps[i]), strength[i]);
+  }
+  // monotone data gives a monotone curve, flat where the data is flat
+  double previous = strength.front();
+  for (double e = 0.0; e <= 0.6; e += 1.0e-3) {
+    double const S = lgr::j2::FlowStrength(props, table, e);
+    EXPECT_GE(S, previous - 1.0e-6);
+    EXPECT_GE(lgr::j2::HardeningRate(props, table, e), 0.0);
+    if (0.05 <= e && e <= 0.2) {
+      EXPECT_NEAR(S, 380e6, 1.0e-6);
+    }
+    previous = S;
+  }
+  double const d = 0.1;
+  EXPECT_NEAR(
+      lgr::j2::HardeningPotential(props, table, 0.5 + d) - lgr::j2::HardeningPotential(props, table, 0.5),
+      d * (400e6 + 0.5 * d * lgr::j2::HardeningRate(props, table, 0.5)),
+      1.0e-3);
+}
+
+TEST(materials, J2_point_tabulated_hardening)
+{
+  double const              K{(400.0 / 3.0) * 1e9};
+  double const              G{80.0e9};
+  double const              Y0{350e6};
+  double const              n{4.0};
+  double const              eps0{1e-2};
+  double const              Svis0{Y0};
+  double const              m{2.0};
+  double const              eps_dot0{1e-1};
+  lgr::j2::Properties const props{
+      .K = K, .G = G, .Y0 = Y0, .n = n, .eps0 = eps0, .Svis0 = Svis0, .m = m, .eps_dot0 = eps_dot0};
+  auto const curve = lgr::j2::TabulatePowerLaw(props, 1.0, 1.0e-10);
+
+  hpc::matrix3x3<double> const G0(0.3, -0.1, 0.2, 0.05, -0.2, 0.1, -0.15, 0.25, 0.1);
+  auto const                   F = hpc::exp(0.05 * G0);
+
+  auto   sigma(hpc::matrix3x3<double>::zero());
+  auto   sigma_table(hpc::matrix3x3<double>::zero());
+  double Keff, Geff, W, W_table;
+  auto   Fp(hpc::matrix3x3<double>::identity());
+  auto   Fp_table(hpc::matrix3x3<double>::identity());
+  double eqps{0.01};
+  double eqps_table{0.01};
+  lgr::variational_J2_point(F, props, 1.0e-2, sigma, Keff, Geff, W, Fp, eqps);
+  lgr::variational_J2_point(
+      F, props, curve.host_table(), 1.0e-2, sigma_table, Keff, Geff, W_table, Fp_table, eqps_table);
+
+  EXPECT_GT(eqps, 0.01);
+  EXPECT_LE(hpc::norm(sigma_table - sigma), 1.0e-8 * hpc::norm(sigma));
+  EXPECT_NEAR(eqps_table, eqps, 1.0e-8 * eqps);
+  EXPECT_NEAR(W_table, W, 1.0e-8 * W);
+}
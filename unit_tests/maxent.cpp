@@ -89,7 +89,7 @@ TEST(maxent, partition_unity_gradient_1)
   tetrahedron_single_point(s);
 
   auto const error = lgr_unit::compute_basis_gradient_error(s);
-  auto const eps   = 2 * hpc::machine_epsilon<double>();
+  auto const eps   = 2 * hpc::machine_epsilon<lgr::point_storage>();
 
   ASSERT_LE(error, eps);
 }
@@ -101,7 +101,7 @@ TEST(maxent, partition_unity_gradient_2)
   two_tetrahedra_two_points(s);
 
   auto const error = lgr_unit::compute_basis_gradient_error(s);
-  auto const eps   = 4 * hpc::machine_epsilon<double>();
+  auto const eps   = 4 * hpc::machine_epsilon<lgr::point_storage>();
 
   ASSERT_LE(error, eps);
 }
@@ -113,7 +113,7 @@ TEST(maxent, partition_unity_gradient_3)
   hexahedron_eight_points(s);
 
   auto const error = lgr_unit::compute_basis_gradient_error(s);
-  auto const eps   = 256 * hpc::machine_epsilon<double>();
+  auto const eps   = 256 * hpc::machine_epsilon<lgr::point_storage>();
 
   ASSERT_LE(error, eps);
 }
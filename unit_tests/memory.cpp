@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <hpc_memory_pool.hpp>
+#include <hpc_vector.hpp>
+#include <memory>
+
+namespace {
+
+// an upstream allocator that counts what reaches it
+struct counting_upstream
+{
+  using value_type = char;
+  static std::size_t allocations;
+  static std::size_t deallocations;
+  char*
+  allocate(std::size_t n)
+  {
+    ++allocations;
+    return std::allocator<char>().allocate(n);
+  }
+  void
+  deallocate(char* p, std::size_t n)
+  {
+    ++deallocations;
+    std::allocator<char>().deallocate(p, n);
+  }
+};
+
+std::size_t counting_upstream::allocations   = 0;
+std::size_t counting_upstream::deallocations = 0;
+
+template <class T>
+using counting_vector = hpc::vector<T, hpc::pool_allocator<T, counting_upstream>, hpc::host_policy, int>;
+
+}  // namespace
+
+TEST(memory, pool_reuses_released_blocks)
+{
+  auto& pool = hpc::pool_of<counting_upstream>();
+  pool.release_cached();
+  pool.reset_statistics();
+  auto const upstream_before = counting_upstream::allocations;
+  for (int step = 0; step < 10; ++step) {
+    counting_vector<double> a(1000);
+    counting_vector<double> b(1000);
+    counting_vector<int>    c(999);
+  }
+  auto const statistics = pool.statistics();
+  EXPECT_EQ(counting_upstream::allocations - upstream_before, 3u);
+  EXPECT_EQ(statistics.allocations, 30u);
+  EXPECT_EQ(statistics.reuses, 27u);
+  EXPECT_DOUBLE_EQ(statistics.reuse_rate(), 0.9);
+  EXPECT_EQ(statistics.bytes_in_use, 0u);
+  EXPECT_GE(statistics.high_water_mark, 2 * 1000 * sizeof(double) + 999 * sizeof(int));
+  EXPECT_EQ(statistics.bytes_cached, statistics.high_water_mark);
+}
+
+TEST(memory, pool_does_not_reuse_much_larger_blocks)
+{
+  auto& pool = hpc::pool_of<counting_upstream>();
+  pool.release_cached();
+  auto const upstream_before = counting_upstream::allocations;
+  { counting_vector<double> large(100000); }
+  { counting_vector<double> small(1000); }
+  EXPECT_EQ(counting_upstream::allocations - upstream_before, 2u);
+}
+
+TEST(memory, pool_scope_releases_blocks_unused_in_the_scope)
+{
+  auto& pool = hpc::pool_of<counting_upstream>();
+  pool.release_cached();
+  {
+    hpc::pool_scope<counting_upstream> const step;
+    counting_vector<double>                  kept(1000);
+    counting_vector<double>                  dropped(5000);
+  }
+  EXPECT_EQ(pool.statistics().bytes_in_use, 0u);
+  auto const deallocations_before = counting_upstream::deallocations;
+  {
+    hpc::pool_scope<counting_upstream> const step;
+    counting_vector<double>                  kept(1000);
+  }
+  EXPECT_EQ(counting_upstream::deallocations - deallocations_before, 1u);
+  EXPECT_GE(pool.statistics().bytes_cached, 1000 * sizeof(double));
+  EXPECT_LT(pool.statistics().bytes_cached, 5000 * sizeof(double));
+}
+
+TEST(memory, pool_rejects_blocks_it_did_not_hand_out)
+{
+  auto& pool = hpc::pool_of<counting_upstream>();
+  int   foreign{0};
+  EXPECT_DEATH(pool.deallocate(&foreign), "");
+}
+
+TEST(memory, device_vectors_draw_from_the_device_pool)
+{
+  auto const before = hpc::device_pool().statistics();
+  { hpc::device_vector<double> a(12345); }
+  { hpc::device_vector<double> b(12345); }
+  auto const after = hpc::device_pool().statistics();
+  EXPECT_EQ(after.allocations - before.allocations, 2u);
+  EXPECT_GE(after.reuses - before.reuses, 1u);
+}
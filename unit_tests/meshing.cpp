@@ -0,0 +1,294 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <lgr_basis_gradients.hpp>
+#include <lgr_distributed.hpp>
+#include <lgr_input.hpp>
+#include <lgr_meshing.hpp>
+#include <lgr_physics.hpp>
+#include <lgr_renumber.hpp>
+#include <lgr_state.hpp>
+#include <lgr_state_fields.hpp>
+#include <lgr_tetrahedron.hpp>
+#include <string>
+
+namespace {
+
+double
+centroid_tag(lgr::state const& s, lgr::element_index const element)
+{
+  auto const element_nodes = (s.elements * s.nodes_in_element)[element];
+  auto       centroid      = hpc::position<double>::zero();
+  for (auto const element_node : element_nodes) {
+    centroid = centroid + s.x[s.elements_to_nodes[element_node]].load();
+  }
+  return double(centroid(0)) + 10.0 * double(centroid(1)) + 100.0 * double(centroid(2));
+}
+
+}  // namespace
+
+TEST(meshing, hilbert_renumbering_permutes_fields_with_the_mesh)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element          = lgr::TETRAHEDRON;
+  in.mesh_ordering    = lgr::HILBERT_MESH_ORDERING;
+  in.elements_along_x = 6;
+  in.elements_along_y = 5;
+  in.elements_along_z = 4;
+  lgr::state s;
+  lgr::build_mesh(in, s);
+  s.v.resize(s.nodes.size());
+  s.rho.resize(s.points.size());
+  hpc::host_vector<double, lgr::node_index> input_tags(s.nodes.size());
+  for (auto const node : s.nodes) {
+    auto const x     = s.x[node].load();
+    s.v[node]        = hpc::velocity<double>(double(x(0)), double(x(1)), double(x(2)));
+    input_tags[node] = double(x(0)) + 10.0 * double(x(1)) + 100.0 * double(x(2));
+  }
+  for (auto const element : s.elements) s.rho[lgr::point_index(hpc::weaken(element))] = centroid_tag(s, element);
+  lgr::renumber_mesh(in, s);
+  ASSERT_EQ(s.elements.size(), lgr::element_index(6 * 5 * 4 * 6));
+  ASSERT_EQ(s.nodes.size(), lgr::node_index(7 * 6 * 5));
+  int moved_nodes = 0;
+  for (auto const node : s.nodes) {
+    auto const x = s.x[node].load();
+    auto const v = s.v[node].load();
+    for (int axis = 0; axis < 3; ++axis) ASSERT_EQ(double(v(axis)), double(x(axis)));
+    if (input_tags[node] != double(x(0)) + 10.0 * double(x(1)) + 100.0 * double(x(2))) ++moved_nodes;
+    for (auto const node_element : s.nodes_to_node_elements[node]) {
+      auto const element         = s.node_elements_to_elements[node_element];
+      auto const node_in_element = s.node_elements_to_nodes_in_element[node_element];
+      auto const element_node    = (s.elements * s.nodes_in_element)[element][node_in_element];
+      ASSERT_EQ(s.elements_to_nodes[element_node], node);
+    }
+  }
+  // the generator numbers nodes lexicographically, the Hilbert curve does not
+  ASSERT_GT(moved_nodes, 0);
+  for (auto const element : s.elements) {
+    ASSERT_EQ(double(s.rho[lgr::point_index(hpc::weaken(element))]), centroid_tag(s, element));
+  }
+}
+
+TEST(meshing, decomposition_keeps_every_element_around_owned_nodes)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element          = lgr::TETRAHEDRON;
+  in.elements_along_x = 6;
+  in.elements_along_y = 5;
+  in.elements_along_z = 4;
+  lgr::state mesh;
+  lgr::build_mesh(in, mesh);
+  int const                              ranks = 4;
+  hpc::host_vector<int, lgr::node_index> owner_counts(mesh.nodes.size(), 0);
+  for (int rank = 0; rank < ranks; ++rank) {
+    lgr::state s;
+    lgr::build_mesh(in, s);
+    lgr::decompose_mesh(s, rank, ranks);
+    ASSERT_LT(s.nodes.size(), mesh.nodes.size());
+    ASSERT_EQ(s.global_nodes.size(), s.nodes.size());
+    for (auto const node : s.nodes) {
+      lgr::node_index const global_node = s.global_nodes[node];
+      for (int axis = 0; axis < 3; ++axis) {
+        ASSERT_EQ(double(s.x[node].load()(axis)), double(mesh.x[global_node].load()(axis)));
+      }
+      int const owner = s.node_owners[node];
+      ASSERT_GE(owner, 0);
+      ASSERT_LT(owner, ranks);
+      if (owner != rank) continue;
+      ++owner_counts[global_node];
+      ASSERT_EQ(s.nodes_to_node_elements[node].size(), mesh.nodes_to_node_elements[global_node].size());
+    }
+  }
+  for (auto const node : mesh.nodes) ASSERT_EQ(owner_counts[node], 1);
+}
+
+TEST(meshing, state_memory_counts_fields_and_skips_unused_ones)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element                   = lgr::TETRAHEDRON;
+  in.elements_along_x          = 3;
+  in.elements_along_y          = 3;
+  in.elements_along_z          = 3;
+  in.enable_neo_Hookean[MI(0)] = true;
+  auto bytes_of = [](lgr::state const& s, std::string const& name) {
+    for (auto const& field : lgr::state_memory(s)) {
+      if (field.name == name) return field.bytes;
+    }
+    return std::size_t(0);
+  };
+  lgr::state full;
+  lgr::build_mesh(in, full);
+  lgr::resize_state(in, full);
+  auto type_of = [](lgr::state const& s, std::string const& name) {
+    for (auto const& field : lgr::state_memory(s)) {
+      if (field.name == name) return field.type;
+    }
+    return std::string();
+  };
+  auto space_of = [](lgr::state const& s, std::string const& name) {
+    for (auto const& field : lgr::state_memory(s)) {
+      if (field.name == name) return std::string(field.index_space);
+    }
+    return std::string();
+  };
+  auto const points = std::size_t(hpc::weaken(hpc::padded_size(lgr::tensor_layout, full.points.size())));
+  ASSERT_EQ(bytes_of(full, "F_total"), points * 9 * sizeof(double));
+  ASSERT_EQ(space_of(full, "b"), "nodes");
+  ASSERT_EQ(type_of(full, "F_total"), "matrix3x3<double>");
+  ASSERT_EQ(type_of(full, "sigma"), "symmetric3x3<double>");
+  ASSERT_EQ(type_of(full, "x"), "vector3<double>");
+  ASSERT_EQ(type_of(full, "material"), "int");
+  ASSERT_EQ(bytes_of(full, "sigma"), points * 6 * sizeof(double));
+  ASSERT_EQ(bytes_of(full, "Fp_total"), points * 9 * sizeof(double));
+  ASSERT_EQ(bytes_of(full, "v_prime"), std::size_t(0));
+  in.skip_unused_fields = true;
+  lgr::state lean;
+  lgr::build_mesh(in, lean);
+  lgr::resize_state(in, lean);
+  ASSERT_EQ(bytes_of(lean, "F_total"), bytes_of(full, "F_total"));
+  ASSERT_EQ(bytes_of(lean, "Fp_total"), std::size_t(0));
+  ASSERT_EQ(bytes_of(lean, "ep"), std::size_t(0));
+  ASSERT_EQ(bytes_of(lean, "b"), std::size_t(0));
+  in.enable_neo_Hookean[MI(0)]    = false;
+  in.enable_variational_J2[MI(0)] = true;
+  lgr::state plastic;
+  lgr::build_mesh(in, plastic);
+  lgr::resize_state(in, plastic);
+  ASSERT_EQ(bytes_of(plastic, "Fp_total"), bytes_of(full, "Fp_total"));
+}
+
+TEST(meshing, required_fields_follow_the_enabled_physics)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element                 = lgr::TETRAHEDRON;
+  in.elements_along_x        = 2;
+  in.elements_along_y        = 2;
+  in.elements_along_z        = 2;
+  in.enable_ideal_gas[MI(0)] = true;
+  in.skip_unused_fields      = true;
+  auto const gas_fields      = lgr::required_fields(in);
+  ASSERT_TRUE(gas_fields.contains(lgr::ideal_gas_fields));
+  ASSERT_FALSE(gas_fields.contains(lgr::F_TOTAL_FIELD));
+  ASSERT_FALSE(gas_fields.contains(lgr::NU_ART_FIELD));
+  lgr::state s;
+  lgr::build_mesh(in, s);
+  lgr::resize_state(in, s);
+  ASSERT_TRUE(lgr::has_fields(s, gas_fields));
+  ASSERT_FALSE(lgr::has_fields(s, lgr::neo_Hookean_fields));
+  ASSERT_TRUE(s.F_total.empty());
+  ASSERT_TRUE(gas_fields.contains(lgr::unfused_point_fields));
+  in.enable_fused_point_kernels = true;
+  ASSERT_FALSE(lgr::required_fields(in).contains(lgr::SYMM_GRAD_V_FIELD));
+  ASSERT_FALSE(lgr::required_fields(in).contains(lgr::RHO_E_DOT_FIELD));
+  in.enable_fused_point_kernels = false;
+  in.enable_viscosity           = true;
+  ASSERT_TRUE(lgr::required_fields(in).contains(lgr::apply_viscosity_fields));
+  in.enable_nodal_energy[MI(0)] = true;
+  ASSERT_TRUE(lgr::required_fields(in).contains(lgr::E_FIELD));
+  in.skip_unused_fields = false;
+  ASSERT_TRUE(lgr::required_fields(in).contains(lgr::unconditional_fields));
+}
+
+TEST(meshing, recomputed_basis_gradients_match_stored_ones)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element                   = lgr::TETRAHEDRON;
+  in.elements_along_x          = 2;
+  in.elements_along_y          = 3;
+  in.elements_along_z          = 2;
+  in.enable_neo_Hookean[MI(0)] = true;
+  lgr::state stored;
+  lgr::build_mesh(in, stored);
+  lgr::resize_state(in, stored);
+  lgr::initialize_tetrahedron_V(stored);
+  lgr::initialize_tetrahedron_grad_N(stored);
+  in.recompute_grad_N = true;
+  ASSERT_FALSE(lgr::required_fields(in).contains(lgr::GRAD_N_FIELD));
+  lgr::state recomputed;
+  lgr::build_mesh(in, recomputed);
+  lgr::resize_state(in, recomputed);
+  lgr::initialize_tetrahedron_V(recomputed);
+  lgr::initialize_tetrahedron_grad_N(recomputed);
+  ASSERT_TRUE(recomputed.grad_N.empty());
+  auto const stored_grad_N     = lgr::basis_gradients(stored);
+  auto const recomputed_grad_N = lgr::basis_gradients(recomputed);
+  ASSERT_FALSE(stored_grad_N.recomputed());
+  ASSERT_TRUE(recomputed_grad_N.recomputed());
+  auto const elements_to_points = stored.elements * stored.points_in_element;
+  for (auto const element : stored.elements) {
+    for (auto const point : elements_to_points[element]) {
+      auto const expected = stored_grad_N(element, point);
+      auto const actual   = recomputed_grad_N(element, point);
+      for (auto const node_in_element : stored.nodes_in_element) {
+        auto const difference = actual[node_in_element] - expected[node_in_element];
+        ASSERT_LE(double(norm(difference)), 1.0e-12 * double(norm(expected[node_in_element])));
+      }
+    }
+  }
+}
+
+TEST(meshing, colored_scatter_force_matches_gather)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element                   = lgr::TETRAHEDRON;
+  in.elements_along_x          = 3;
+  in.elements_along_y          = 2;
+  in.elements_along_z          = 2;
+  in.enable_neo_Hookean[MI(0)] = true;
+  lgr::state s;
+  lgr::build_mesh(in, s);
+  lgr::resize_state(in, s);
+  lgr::initialize_tetrahedron_V(s);
+  lgr::initialize_tetrahedron_grad_N(s);
+  auto const points_to_sigma = s.sigma.begin();
+  auto       stress          = [=] HPC_DEVICE(lgr::point_index const point) {
+    auto const p           = double(hpc::weaken(point));
+    points_to_sigma[point] = hpc::symmetric_stress<double>(1.0 + p, 2.0 - p, 0.5 * p, 0.25, -0.125 * p, 3.0);
+  };
+  hpc::for_each(hpc::device_policy(), s.points, stress);
+  lgr::update_internal_force(in, s);
+  hpc::pinned_array_vector<hpc::force<double>, lgr::node_index> gathered(s.nodes.size());
+  hpc::copy(s.f, gathered);
+  in.force_assembly = lgr::COLORED_SCATTER_FORCE_ASSEMBLY;
+  lgr::color_elements(s);
+  ASSERT_GT(s.element_colors.size(), 1);
+  lgr::update_internal_force(in, s);
+  hpc::pinned_array_vector<hpc::force<double>, lgr::node_index> scattered(s.nodes.size());
+  hpc::copy(s.f, scattered);
+  double largest = 0.0;
+  for (auto const node : s.nodes) largest = std::max(largest, double(norm(gathered[node].load())));
+  ASSERT_GT(largest, 0.0);
+  for (auto const node : s.nodes) {
+    auto const difference = scattered[node].load() - gathered[node].load();
+    ASSERT_LE(double(norm(difference)), 1.0e-12 * largest);
+  }
+}
+
+TEST(meshing, node_element_lists_come_out_in_element_order)
+{
+  using MI = lgr::material_index;
+  lgr::input in(MI(1), MI(0));
+  in.element          = lgr::COMPOSITE_TETRAHEDRON;
+  in.elements_along_x = 3;
+  in.elements_along_y = 2;
+  in.elements_along_z = 2;
+  lgr::state s;
+  lgr::build_mesh(in, s);
+  auto const elements_to_element_nodes = s.elements * s.nodes_in_element;
+  for (auto const node : s.nodes) {
+    auto previous = lgr::element_index(-1);
+    for (auto const node_element : s.nodes_to_node_elements[node]) {
+      auto const element         = s.node_elements_to_elements[node_element];
+      auto const node_in_element = s.node_elements_to_nodes_in_element[node_element];
+      ASSERT_LT(previous, element);
+      ASSERT_EQ(s.elements_to_nodes[elements_to_element_nodes[element][node_in_element]], node);
+      previous = element;
+    }
+  }
+}
@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <hpc_algorithm.hpp>
+#include <hpc_array_vector.hpp>
+#include <hpc_atomic.hpp>
+#include <hpc_dimensional.hpp>
+#include <hpc_execution.hpp>
+#include <hpc_functional.hpp>
+#include <hpc_numeric.hpp>
+#include <hpc_range.hpp>
+#include <hpc_thread_pool.hpp>
+#include <hpc_transform_reduce.hpp>
+#include <hpc_vector.hpp>
+#include <lgr_timers.hpp>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::ptrdiff_t parallel_test_size = 100003;
+
+}  // namespace
+
+TEST(parallel, for_each_visits_every_item_once)
+{
+  hpc::host_vector<int> counts(parallel_test_size, 0);
+  auto const            items_to_counts = counts.begin();
+  auto                  functor         = [=](std::ptrdiff_t const item) { ++items_to_counts[item]; };
+  hpc::for_each(hpc::parallel_policy(), hpc::counting_range<std::ptrdiff_t>(parallel_test_size), functor);
+  for (auto const count : counts) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(parallel, fill_and_copy_array_vector)
+{
+  using velocity = hpc::velocity<double>;
+  hpc::host_array_vector<velocity> from(parallel_test_size);
+  hpc::host_array_vector<velocity> to(parallel_test_size);
+  hpc::fill(hpc::parallel_policy(), from, velocity(1.0, 2.0, 3.0));
+  hpc::copy(hpc::parallel_policy(), from, to);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    auto const v = to[i].load();
+    ASSERT_EQ(v(0), 1.0);
+    ASSERT_EQ(v(1), 2.0);
+    ASSERT_EQ(v(2), 3.0);
+  }
+}
+
+TEST(parallel, transform_reduce_matches_serial)
+{
+  using index        = std::ptrdiff_t;
+  auto const range   = hpc::counting_range<index>(parallel_test_size);
+  auto       unop    = [](index const i) { return (i % 7) - 3; };
+  auto const serial  = hpc::transform_reduce(hpc::serial_policy(), range, index(5), hpc::plus<index>(), unop);
+  auto const threads = hpc::transform_reduce(hpc::parallel_policy(), range, index(5), hpc::plus<index>(), unop);
+  ASSERT_EQ(serial, threads);
+  auto const minimum = hpc::transform_reduce(hpc::parallel_policy(), range, index(0), hpc::minimum<index>(), unop);
+  ASSERT_EQ(minimum, -3);
+  hpc::host_vector<bool> flags(parallel_test_size, false);
+  ASSERT_FALSE(hpc::any_of(hpc::parallel_policy(), flags));
+  flags[parallel_test_size - 1] = true;
+  ASSERT_TRUE(hpc::any_of(hpc::parallel_policy(), flags));
+  ASSERT_FALSE(hpc::all_of(hpc::parallel_policy(), flags));
+}
+
+TEST(parallel, reduce_of_empty_range_is_init)
+{
+  hpc::host_vector<double> empty;
+  ASSERT_EQ(hpc::reduce(hpc::parallel_policy(), empty, 4.0), 4.0);
+}
+
+TEST(parallel, transform_inclusive_scan_matches_serial)
+{
+  auto const            range = hpc::counting_range<std::ptrdiff_t>(parallel_test_size);
+  auto                  unop  = [](std::ptrdiff_t const i) -> int { return (i % 3 == 0) ? 1 : 0; };
+  hpc::host_vector<int> serial(parallel_test_size);
+  hpc::host_vector<int> threads(parallel_test_size);
+  hpc::transform_inclusive_scan(hpc::serial_policy(), range, serial, hpc::plus<int>(), unop);
+  hpc::transform_inclusive_scan(hpc::parallel_policy(), range, threads, hpc::plus<int>(), unop);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    ASSERT_EQ(serial[i], threads[i]);
+  }
+}
+
+TEST(parallel, copy_if_keeps_selected_items_in_order)
+{
+  auto const            range = hpc::counting_range<std::ptrdiff_t>(parallel_test_size);
+  auto                  pred  = [](std::ptrdiff_t const i) -> int { return (i % 7 == 3) ? 1 : 0; };
+  hpc::host_vector<int> serial(5, -1);
+  hpc::host_vector<int> threads;
+  hpc::copy_if(hpc::serial_policy(), range, serial, pred);
+  hpc::copy_if(hpc::parallel_policy(), range, threads, pred);
+  ASSERT_EQ(serial.size(), (parallel_test_size + 3) / 7);
+  ASSERT_EQ(threads.size(), serial.size());
+  for (std::ptrdiff_t i = 0; i < serial.size(); ++i) {
+    ASSERT_EQ(serial[i], 7 * i + 3);
+    ASSERT_EQ(threads[i], 7 * i + 3);
+  }
+  hpc::copy_if(hpc::parallel_policy(), hpc::counting_range<std::ptrdiff_t>(0), threads, pred);
+  ASSERT_EQ(threads.size(), 0);
+}
+
+TEST(parallel, work_stealing_runs_uneven_chunks_once)
+{
+  constexpr std::ptrdiff_t      chunk_count = 256;
+  hpc::thread_pool              pool(4);
+  hpc::work_stealing_scheduler  scheduler(pool);
+  std::vector<std::atomic<int>> counts(chunk_count);
+  std::vector<double>           sums(chunk_count, 0.0);
+  scheduler.enable_timing(true);
+  auto functor = [&](std::ptrdiff_t const chunk) {
+    ++counts[std::size_t(chunk)];
+    // the last quarter of the chunks does almost all of the work
+    auto const work = (chunk >= 3 * chunk_count / 4) ? 20000 : 10;
+    double     sum  = 0.0;
+    for (int i = 0; i < work; ++i) sum += 1.0 / double(i + 1);
+    sums[std::size_t(chunk)] = sum;
+  };
+  scheduler.for_each_chunk(hpc::counting_range<std::ptrdiff_t>(chunk_count), functor);
+  for (auto const& count : counts) {
+    ASSERT_EQ(count.load(), 1);
+  }
+  auto const    statistics = scheduler.statistics();
+  std::uint64_t total      = 0;
+  for (auto const chunks : statistics.chunks) total += chunks;
+  ASSERT_EQ(statistics.chunks.size(), 4u);
+  ASSERT_EQ(total, std::uint64_t(chunk_count));
+  ASSERT_GE(statistics.imbalance(), 1.0);
+  scheduler.reset_statistics();
+  ASSERT_EQ(scheduler.statistics().chunks[0], 0u);
+}
+
+TEST(parallel, aligned_allocator_keeps_cache_lines_apart)
+{
+  class alignas(64) line
+  {
+   public:
+    std::uint64_t value{0};
+  };
+  for (std::size_t size = 1; size <= 8; ++size) {
+    std::vector<line, hpc::aligned_allocator<line>> lines(size);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(lines.data()) % 64, 0u);
+  }
+}
+
+TEST(parallel, atomic_ref_fetch_operations)
+{
+  using index         = std::ptrdiff_t;
+  auto const   range   = hpc::counting_range<index>(parallel_test_size);
+  int          count   = 0;
+  std::int64_t sum     = 0;
+  double       total   = 0.0;
+  double       minimum = 1.0e300;
+  double       maximum = -1.0e300;
+  auto         functor = [&](index const i) {
+    hpc::atomic_ref<int>(count)++;
+    hpc::atomic_ref<std::int64_t>(sum).fetch_add(std::int64_t(i));
+    hpc::atomic_ref<double>(total).fetch_add(1.0);
+    hpc::atomic_ref<double>(minimum).fetch_min(double(i % 1000) - 7.0);
+    hpc::atomic_ref<double>(maximum).fetch_max(double(i % 1000) - 7.0);
+  };
+  hpc::for_each(hpc::parallel_policy(), range, functor);
+  ASSERT_EQ(count, parallel_test_size);
+  ASSERT_EQ(sum, std::int64_t(parallel_test_size) * std::int64_t(parallel_test_size - 1) / 2);
+  ASSERT_EQ(total, double(parallel_test_size));
+  ASSERT_EQ(minimum, -7.0);
+  ASSERT_EQ(maximum, 992.0);
+}
+
+TEST(parallel, atomic_ref_quantity_and_compare_exchange)
+{
+  hpc::time<double>                  dt(1.0);
+  hpc::atomic_ref<hpc::time<double>> dt_ref(dt);
+  auto                               functor = [&](std::ptrdiff_t const i) {
+    dt_ref.fetch_min(hpc::time<double>(1.0 + double(i % 97)));
+  };
+  hpc::for_each(hpc::parallel_policy(), hpc::counting_range<std::ptrdiff_t>(parallel_test_size), functor);
+  dt_ref.fetch_min(hpc::time<double>(0.5));
+  ASSERT_EQ(double(dt_ref.load()), 0.5);
+  int                  value = 3;
+  hpc::atomic_ref<int> ref(value);
+  int                  expected = 4;
+  ASSERT_FALSE(ref.compare_exchange(expected, 5));
+  ASSERT_EQ(expected, 3);
+  ASSERT_TRUE(ref.compare_exchange(expected, 5));
+  ASSERT_EQ(ref.load(), 5);
+}
+
+TEST(parallel, exclusive_scan_matches_serial)
+{
+  auto const            range = hpc::counting_range<std::ptrdiff_t>(parallel_test_size);
+  hpc::host_vector<int> values(parallel_test_size);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) values[i] = int(i % 5) - 1;
+  hpc::host_vector<int> serial(parallel_test_size);
+  hpc::host_vector<int> threads(parallel_test_size);
+  hpc::exclusive_scan(hpc::serial_policy(), values, serial, 7);
+  hpc::exclusive_scan(hpc::parallel_policy(), values, threads, 7);
+  ASSERT_EQ(serial[0], 7);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    ASSERT_EQ(serial[i], threads[i]);
+  }
+  auto unop = [](std::ptrdiff_t const i) { return std::ptrdiff_t(i % 3); };
+  hpc::host_vector<std::ptrdiff_t> in_place(parallel_test_size);
+  hpc::transform_exclusive_scan(
+      hpc::parallel_policy(), range, in_place, std::ptrdiff_t(0), hpc::plus<std::ptrdiff_t>(), unop);
+  hpc::exclusive_scan(hpc::parallel_policy(), in_place, in_place, std::ptrdiff_t(0));
+  hpc::host_vector<std::ptrdiff_t> twice(parallel_test_size);
+  hpc::transform_exclusive_scan(
+      hpc::serial_policy(), range, twice, std::ptrdiff_t(0), hpc::plus<std::ptrdiff_t>(), unop);
+  hpc::exclusive_scan(hpc::serial_policy(), twice, twice, std::ptrdiff_t(0));
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    ASSERT_EQ(in_place[i], twice[i]);
+  }
+}
+
+TEST(parallel, inclusive_scan_by_key_matches_serial)
+{
+  // runs shorter than, equal to and much longer than a chunk
+  for (std::ptrdiff_t const run : {std::ptrdiff_t(3), std::ptrdiff_t(1024), std::ptrdiff_t(5000)}) {
+    hpc::host_vector<int>                       keys(parallel_test_size);
+    hpc::host_vector<int> values(parallel_test_size);
+    for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+      keys[i]   = int(i / run);
+      values[i] = int(i % 11);
+    }
+    hpc::host_vector<int> serial(parallel_test_size);
+    hpc::host_vector<int> threads(parallel_test_size);
+    hpc::inclusive_scan_by_key(hpc::serial_policy(), keys, values, serial, hpc::plus<int>());
+    hpc::inclusive_scan_by_key(hpc::parallel_policy(), keys, values, threads, hpc::plus<int>());
+    for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+      ASSERT_EQ(serial[i], threads[i]);
+    }
+    int first_run_sum = 0;
+    for (std::ptrdiff_t i = 0; i < run; ++i) first_run_sum += int(i % 11);
+    ASSERT_EQ(serial[run - 1], first_run_sum);
+    ASSERT_EQ(serial[run], int(run % 11));
+  }
+}
+
+TEST(parallel, sort_by_key_is_stable_and_matches_std_stable_sort)
+{
+  hpc::host_vector<int>                       keys(parallel_test_size);
+  hpc::host_vector<std::ptrdiff_t>            values(parallel_test_size);
+  std::vector<std::pair<int, std::ptrdiff_t>> expected(static_cast<std::size_t>(parallel_test_size));
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    keys[i]                  = int((i * 7919) % 4099) - 2000;
+    values[i]                = i;
+    expected[std::size_t(i)] = std::make_pair(keys[i], values[i]);
+  }
+  auto const by_key = [](std::pair<int, std::ptrdiff_t> const& a, std::pair<int, std::ptrdiff_t> const& b) {
+    return a.first < b.first;
+  };
+  std::stable_sort(expected.begin(), expected.end(), by_key);
+  hpc::sort_by_key(hpc::parallel_policy(), keys, values);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    ASSERT_EQ(keys[i], expected[std::size_t(i)].first);
+    ASSERT_EQ(values[i], expected[std::size_t(i)].second);
+  }
+  ASSERT_EQ(keys[0], -2000);
+}
+
+TEST(parallel, unique_and_partition_match_serial)
+{
+  hpc::host_vector<int> serial(parallel_test_size);
+  hpc::host_vector<int> threads(parallel_test_size);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) serial[i] = int((i / 3) % 1000);
+  hpc::copy(hpc::serial_policy(), serial, threads);
+  auto const serial_count  = hpc::unique(hpc::serial_policy(), serial);
+  auto const threads_count = hpc::unique(hpc::parallel_policy(), threads);
+  ASSERT_EQ(serial_count, (parallel_test_size + 2) / 3);
+  ASSERT_EQ(threads_count, serial_count);
+  for (std::ptrdiff_t i = 0; i < serial_count; ++i) {
+    ASSERT_EQ(serial[i], int(i % 1000));
+    ASSERT_EQ(threads[i], serial[i]);
+  }
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) serial[i] = int(i);
+  hpc::copy(hpc::serial_policy(), serial, threads);
+  auto       pred          = [](int const i) { return i % 3 == 1; };
+  auto const serial_true   = hpc::partition(hpc::serial_policy(), serial, pred);
+  auto const threads_true  = hpc::partition(hpc::parallel_policy(), threads, pred);
+  ASSERT_EQ(serial_true, parallel_test_size / 3);
+  ASSERT_EQ(threads_true, serial_true);
+  for (std::ptrdiff_t i = 0; i < parallel_test_size; ++i) {
+    ASSERT_EQ(threads[i], serial[i]);
+    ASSERT_EQ(pred(serial[i]), i < serial_true);
+    if (i > 0 && i != serial_true) {
+      ASSERT_LT(serial[i - 1], serial[i]);
+    }
+  }
+}
+
+TEST(parallel, kernel_timers_accumulate_calls_and_items)
+{
+  lgr::reset_kernel_timings();
+  auto& timing = lgr::register_kernel_timing("timed_test_kernel", "items");
+  ASSERT_EQ(&lgr::register_kernel_timing("timed_test_kernel", "items"), &timing);
+  hpc::device_vector<int, std::ptrdiff_t> v(parallel_test_size);
+  for (int i = 0; i < 3; ++i) {
+    lgr::scoped_kernel_timer const timer(timing, double(v.size()));
+    hpc::fill(hpc::device_policy(), v, i);
+  }
+  ASSERT_EQ(timing.calls, 3);
+  ASSERT_EQ(timing.items, 3.0 * double(parallel_test_size));
+  ASSERT_GE(timing.seconds, 0.0);
+  std::stringstream table;
+  lgr::print_kernel_timings(table);
+  ASSERT_NE(table.str().find("timed_test_kernel"), std::string::npos);
+  std::stringstream json;
+  lgr::write_kernel_timings_json(json);
+  auto const expected = "\"kernel\": \"timed_test_kernel\", \"item\": \"items\", \"calls\": 3";
+  ASSERT_NE(json.str().find(expected), std::string::npos);
+  lgr::reset_kernel_timings();
+  ASSERT_EQ(timing.calls, 0);
+}
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <hpc_matrix3x3.hpp>
+#include <hpc_symmetric3x3.hpp>
 #include <otm_util.hpp>
+#include <vector>
 
 using Real   = double;
 using Tensor = hpc::matrix3x3<Real>;
@@ -109,3 +111,108 @@ TEST(tensor, polar)
   auto const error = (hpc::norm(R - A) + hpc::norm(B - U)) / hpc::norm(C);
   ASSERT_LE(error, eps);
 }
+
+#ifndef HPC_CUDA
+
+using Batch = hpc::native_simd<Real>;
+
+// tensors with different norms, so the lanes of a batch take different numbers of iterations
+static std::vector<Tensor>
+batch_test_tensors()
+{
+  auto const c = std::sqrt(2.0) / 2.0;
+  auto const R = Tensor(c, -c, 0.0, c, c, 0.0, 0.0, 0.0, 1.0);
+  auto const G = Tensor(0.5, 0.3, 0.1, -0.2, -0.4, 0.05, 0.1, 0.0, 0.2);
+  auto const I = Tensor::identity();
+  return {
+      Tensor(7, 1, 2, 3, 8, 4, 5, 6, 9),
+      I,
+      R * Tensor(2, 1, 0, 1, 2, 1, 0, 1, 2),
+      Tensor(1.01, 0.02, 0.0, -0.01, 0.99, 0.03, 0.0, 0.01, 1.0),
+      I + G,
+      R,
+      I + 0.01 * G,
+      2.0 * R};
+}
+
+static hpc::matrix3x3<Batch>
+make_batch(std::vector<Tensor> const& tensors, int const first)
+{
+  auto batch = hpc::matrix3x3<Batch>::zero();
+  for (int lane = 0; lane < Batch::size(); ++lane) {
+    hpc::set_lane(batch, lane, tensors[(first + lane) % tensors.size()]);
+  }
+  return batch;
+}
+
+TEST(tensor, simd_determinant_inverse)
+{
+  auto const eps     = hpc::machine_epsilon<Real>();
+  auto const tensors = batch_test_tensors();
+  for (int first = 0; first < int(tensors.size()); first += Batch::size()) {
+    auto const A     = make_batch(tensors, first);
+    auto const det_A = hpc::determinant(A);
+    auto const inv_A = hpc::inverse(A);
+    for (int lane = 0; lane < Batch::size(); ++lane) {
+      auto const a         = tensors[(first + lane) % tensors.size()];
+      auto const det_error = std::abs(det_A[lane] - hpc::determinant(a));
+      ASSERT_LE(det_error, 4 * eps * std::abs(hpc::determinant(a)));
+      auto const inv_error = hpc::norm(hpc::get_lane(inv_A, lane) - hpc::inverse(a));
+      ASSERT_LE(inv_error, 4 * eps * hpc::norm(hpc::inverse(a)));
+    }
+  }
+}
+
+TEST(tensor, simd_exp_log)
+{
+  auto const eps     = hpc::machine_epsilon<Real>();
+  auto const tol     = 64 * eps;
+  auto const tensors = batch_test_tensors();
+  for (int first = 0; first < int(tensors.size()); first += Batch::size()) {
+    auto const A = make_batch(tensors, first);
+    auto const a = hpc::log(A);
+    auto const b = hpc::exp(a);
+    for (int lane = 0; lane < Batch::size(); ++lane) {
+      auto const x         = tensors[(first + lane) % tensors.size()];
+      auto const log_error = hpc::norm(hpc::get_lane(a, lane) - hpc::log(x));
+      ASSERT_LE(log_error, tol * hpc::max(hpc::norm(x), 1.0));
+      auto const exp_error = hpc::norm(hpc::get_lane(b, lane) - hpc::exp(hpc::get_lane(a, lane)));
+      ASSERT_LE(exp_error, tol * hpc::norm(x));
+      auto const round_trip_error = hpc::norm(hpc::get_lane(b, lane) - x);
+      ASSERT_LE(round_trip_error, tol * hpc::norm(x));
+    }
+  }
+}
+
+TEST(tensor, simd_polar)
+{
+  auto const eps     = hpc::machine_epsilon<Real>();
+  auto const tensors = batch_test_tensors();
+  for (int first = 0; first < int(tensors.size()); first += Batch::size()) {
+    auto const R = hpc::polar_rotation(make_batch(tensors, first));
+    for (int lane = 0; lane < Batch::size(); ++lane) {
+      auto const x     = tensors[(first + lane) % tensors.size()];
+      auto const error = hpc::norm(hpc::get_lane(R, lane) - hpc::polar_rotation(x));
+      ASSERT_LE(error, 16 * eps);
+    }
+  }
+}
+
+TEST(tensor, simd_symmetric)
+{
+  auto const eps   = hpc::machine_epsilon<Real>();
+  auto       batch = hpc::symmetric3x3<Batch>::identity();
+  for (int lane = 0; lane < Batch::size(); ++lane) {
+    hpc::set_lane(batch, lane, hpc::symmetric3x3<Real>(4.0 + lane, 5.0, 6.0, 1.0, 0.5 * lane, 0.25));
+  }
+  auto const inv_batch  = hpc::inverse(batch);
+  auto const norm_batch = hpc::norm(batch);
+  for (int lane = 0; lane < Batch::size(); ++lane) {
+    auto const x         = hpc::get_lane(batch, lane);
+    auto const inv_error = hpc::norm(hpc::get_lane(inv_batch, lane) - hpc::inverse(x));
+    ASSERT_LE(inv_error, 4 * eps * hpc::norm(hpc::inverse(x)));
+    ASSERT_EQ(norm_batch[lane], hpc::norm(x));
+  }
+}
+
+#endif
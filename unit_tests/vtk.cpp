@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <lgr_background_writer.hpp>
 #include <lgr_input.hpp>
 #include <lgr_state.hpp>
+#include <lgr_vtu.hpp>
 #include <otm_meshless.hpp>
 #include <otm_vtk.hpp>
+#include <thread>
 #include <unit_tests/otm_unit_mesh.hpp>
 
 TEST(vtk, canPrintOtmStateToFile)
@@ -36,7 +44,110 @@ TEST(vtk, canPrintOtmStateToFile)
   ASSERT_EQ(writer.host_s.K.size(), s.K.size());
 
   writer.write(0);
+  writer.finish();
 
   unlink("tetrahedron_single_point_nodes_0.vtk");
   unlink("tetrahedron_single_point_points_0.vtk");
 }
+
+TEST(vtk, canPrintOtmStateToVtuFile)
+{
+  lgr::state s;
+  using MI = lgr::material_index;
+  lgr::input in(MI(0), MI(0));
+
+  tetrahedron_single_point(s);
+  lgr::otm_update_nodal_mass(s);
+  lgr::otm_allocate_state(in, s);
+
+  lgr::otm_file_writer writer("tetrahedron_single_point", lgr::RAW_VTU_OUTPUT_FORMAT);
+
+  writer.capture(s);
+  writer.write(0);
+  auto const bytes = writer.finish();
+
+  std::ifstream nodes("tetrahedron_single_point_nodes_0.vtu", std::ios::binary | std::ios::ate);
+  std::ifstream points("tetrahedron_single_point_points_0.vtu", std::ios::binary | std::ios::ate);
+  ASSERT_TRUE(nodes.is_open());
+  ASSERT_TRUE(points.is_open());
+  ASSERT_EQ(bytes, std::size_t(nodes.tellg()) + std::size_t(points.tellg()));
+
+  unlink("tetrahedron_single_point_nodes_0.vtu");
+  unlink("tetrahedron_single_point_points_0.vtu");
+}
+
+TEST(vtk, vtuFileAppendsRawArraysAfterTheXml)
+{
+  double const x[]            = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+  int const    connectivity[] = {0, 1, 2, 3};
+  double const pressure[]     = {42.0};
+  int const    material[]     = {7};
+
+  lgr::vtu_file file(lgr::RAW_VTU_ENCODING, 4, 1);
+  file.set_points(x);
+  file.set_cells(connectivity, 4, 10);
+  file.add_point_data("position", x, 3);
+  file.add_cell_data("pressure", pressure, 1);
+  file.add_cell_data("material", material, 1);
+  auto const bytes = file.write("vtu_file_test.vtu");
+
+  std::ifstream     stream("vtu_file_test.vtu", std::ios::binary);
+  std::string const contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  unlink("vtu_file_test.vtu");
+  ASSERT_EQ(bytes, contents.size());
+
+  // points, connectivity, offsets, types, position, pressure and material, each after an 8 byte count
+  auto const marker = std::string("<AppendedData encoding=\"raw\">\n_");
+  auto const start  = contents.find(marker);
+  ASSERT_NE(start, std::string::npos);
+  auto const appended = contents.data() + start + marker.size();
+  auto const array_at = [&](std::uint64_t const offset, std::uint64_t const expected_bytes) {
+    std::uint64_t count;
+    std::memcpy(&count, appended + offset, sizeof(count));
+    EXPECT_EQ(count, expected_bytes);
+    return appended + offset + sizeof(count);
+  };
+  ASSERT_NE(contents.find("offset=\"0\""), std::string::npos);
+  ASSERT_EQ(std::memcmp(array_at(0, sizeof(x)), x, sizeof(x)), 0);
+  auto const connectivity_offset = 8 + sizeof(x);
+  ASSERT_NE(contents.find("offset=\"" + std::to_string(connectivity_offset) + "\""), std::string::npos);
+  ASSERT_EQ(std::memcmp(array_at(connectivity_offset, sizeof(connectivity)), connectivity, sizeof(connectivity)), 0);
+  auto const         offsets_offset = connectivity_offset + 8 + sizeof(connectivity);
+  std::int64_t const cell_offsets[] = {4};
+  ASSERT_EQ(std::memcmp(array_at(offsets_offset, sizeof(cell_offsets)), cell_offsets, sizeof(cell_offsets)), 0);
+  auto const         types_offset = offsets_offset + 8 + sizeof(cell_offsets);
+  std::uint8_t const types[]      = {10};
+  ASSERT_EQ(std::memcmp(array_at(types_offset, sizeof(types)), types, sizeof(types)), 0);
+  auto const pressure_offset = types_offset + 8 + sizeof(types) + 8 + sizeof(x);
+  ASSERT_NE(contents.find("Name=\"pressure\" NumberOfComponents=\"1\" format=\"appended\" offset=\"" +
+                          std::to_string(pressure_offset) + "\""),
+            std::string::npos);
+  ASSERT_EQ(std::memcmp(array_at(pressure_offset, sizeof(pressure)), pressure, sizeof(pressure)), 0);
+  auto const material_offset = pressure_offset + 8 + sizeof(pressure);
+  ASSERT_EQ(std::memcmp(array_at(material_offset, sizeof(material)), material, sizeof(material)), 0);
+  ASSERT_EQ(contents.substr(std::size_t(appended - contents.data()) + material_offset + 8 + sizeof(material)),
+            "\n</AppendedData>\n</VTKFile>\n");
+}
+
+TEST(vtk, backgroundWriterRunsOneWriteAtATime)
+{
+  lgr::background_writer writer;
+  std::atomic<int>       running{0};
+  std::atomic<int>       most_running{0};
+  std::atomic<int>       written{0};
+  for (int i = 0; i < 4; ++i) {
+    writer.submit([&] {
+      auto const now = ++running;
+      if (now > most_running) most_running = now;
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      ++written;
+      --running;
+      return std::size_t(10);
+    });
+    // back-pressure: each write waits for the one before it, so none is left queued behind a running one
+    ASSERT_GE(written.load(), i);
+  }
+  ASSERT_EQ(writer.finish(), std::size_t(40));
+  ASSERT_EQ(written.load(), 4);
+  ASSERT_EQ(most_running.load(), 1);
+}